@@ -1,6 +1,14 @@
 #pragma once
 
+#include <cstdint>
+
 struct BlockState
 {
 public:
+	std::uint64_t m_Block         = ~0ULL; // Id in the block registry
+	std::uint32_t m_ModelId       = 0;
+	std::uint8_t  m_LightEmission = 0;
+	bool          m_Opaque        = true;  // Hides the faces of neighbouring voxels and blocks light
+	bool          m_Solid         = true;  // Stops rays and colliding boxes
+	bool          m_RandomTicks   = false; // Picked by the random ticks of BlockTicker
 };
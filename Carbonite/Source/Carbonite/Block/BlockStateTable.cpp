@@ -0,0 +1,70 @@
+#include "BlockStateTable.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+const BlockStateTable& BlockStateTable::Default()
+{
+	static BlockStateTable s_Default;
+	return s_Default;
+}
+
+BlockStateTable::BlockStateTable()
+{
+	build({});
+}
+
+void BlockStateTable::build(const Registry<BlockState>& registry)
+{
+	m_DirectIds.clear();
+	m_SparseIds.clear();
+	m_States.clear();
+	m_Opaque.clear();
+	m_Solid.clear();
+	m_Emission.clear();
+	m_ModelIds.clear();
+	m_RandomTicks.clear();
+
+	BlockState air;
+	air.m_Opaque = false;
+	air.m_Solid  = false;
+	addRuntimeId(Chunk::EmptyState, air);
+	addRuntimeId(Chunk::EmptyState, BlockState {});
+
+	// Registry ids are assigned in ascending order so the runtime ids do not depend on the registry's iteration order.
+	std::vector<std::pair<std::uint64_t, const BlockState*>> states;
+	states.reserve(registry.getSize());
+	std::uint64_t maxDirectState = 0;
+	registry.forEach([&states, &maxDirectState](std::uint64_t state, std::string_view, const BlockState& properties) {
+		if (state == Chunk::EmptyState)
+			return;
+		states.emplace_back(state, &properties);
+		if (state < MaxDirectId)
+			maxDirectState = std::max(maxDirectState, state + 1);
+	});
+	std::sort(states.begin(), states.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+	if (states.size() + m_States.size() > 0x1'0000)
+		throw std::runtime_error("Too many block states for 16 bit runtime ids");
+
+	m_DirectIds.assign(static_cast<std::size_t>(maxDirectState), UnknownId);
+	for (auto& [state, properties] : states)
+	{
+		auto id = static_cast<std::uint16_t>(m_States.size());
+		if (state < MaxDirectId)
+			m_DirectIds[static_cast<std::size_t>(state)] = id;
+		else
+			m_SparseIds.insert({ state, id });
+		addRuntimeId(state, *properties);
+	}
+}
+
+void BlockStateTable::addRuntimeId(std::uint64_t state, const BlockState& properties)
+{
+	m_States.push_back(state);
+	m_Opaque.push_back(properties.m_Opaque);
+	m_Solid.push_back(properties.m_Solid);
+	m_Emission.push_back(properties.m_LightEmission);
+	m_ModelIds.push_back(properties.m_ModelId);
+	m_RandomTicks.push_back(properties.m_RandomTicks);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "BlockState.h"
+#include "Carbonite/World/Chunk.h"
+#include "Utils/InternalRegistry.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <unordered_map>
+#include <vector>
+
+// Block state properties flattened into columns indexed by dense 16 bit runtime ids, built once after every mod registered
+// its states. Voxels keep storing registry ids, registry ids below MaxDirectId map to their runtime id through a flat array.
+// Runtime id 0 is air (Chunk::EmptyState), 1 stands in for every state that was never registered, which is opaque and solid
+// like any voxel was before states had properties.
+class BlockStateTable
+{
+public:
+	static constexpr std::uint16_t AirId       = 0;
+	static constexpr std::uint16_t UnknownId   = 1;
+	static constexpr std::uint64_t MaxDirectId = 1 << 16;
+
+	// Table without registered states, shared by everything no table was set for.
+	static const BlockStateTable& Default();
+
+public:
+	BlockStateTable();
+
+	void build(const Registry<BlockState>& registry);
+
+	std::uint16_t getRuntimeId(std::uint64_t state) const
+	{
+		if (state < m_DirectIds.size())
+			return m_DirectIds[static_cast<std::size_t>(state)];
+		if (state == Chunk::EmptyState)
+			return AirId;
+		if (m_SparseIds.empty())
+			return UnknownId;
+		auto itr = m_SparseIds.find(state);
+		return itr != m_SparseIds.end() ? itr->second : UnknownId;
+	}
+
+	bool          isOpaque(std::uint64_t state) const { return m_Opaque[getRuntimeId(state)]; }
+	bool          isSolid(std::uint64_t state) const { return m_Solid[getRuntimeId(state)]; }
+	std::uint8_t  getEmission(std::uint64_t state) const { return m_Emission[getRuntimeId(state)]; }
+	std::uint32_t getModelId(std::uint64_t state) const { return m_ModelIds[getRuntimeId(state)]; }
+	bool          isRandomTicking(std::uint64_t state) const { return m_RandomTicks[getRuntimeId(state)]; }
+
+	// Registry id of the runtime id, Chunk::EmptyState for air and unknown states.
+	std::uint64_t getState(std::uint16_t runtimeId) const { return m_States[runtimeId]; }
+	std::size_t   getRuntimeIdCount() const { return m_States.size(); }
+
+	// Columns indexed by runtime id, for loops that resolve a palette once and look properties up per voxel.
+	auto& getOpaqueColumn() const { return m_Opaque; }
+	auto& getSolidColumn() const { return m_Solid; }
+	auto& getEmissionColumn() const { return m_Emission; }
+	auto& getModelIdColumn() const { return m_ModelIds; }
+	auto& getRandomTickColumn() const { return m_RandomTicks; }
+
+private:
+	void addRuntimeId(std::uint64_t state, const BlockState& properties);
+
+private:
+	std::vector<std::uint16_t>                       m_DirectIds;
+	std::unordered_map<std::uint64_t, std::uint16_t> m_SparseIds;
+
+	std::vector<std::uint64_t> m_States;
+	std::vector<std::uint8_t>  m_Opaque;
+	std::vector<std::uint8_t>  m_Solid;
+	std::vector<std::uint8_t>  m_Emission;
+	std::vector<std::uint32_t> m_ModelIds;
+	std::vector<std::uint8_t>  m_RandomTicks;
+};
@@ -3,6 +3,8 @@
 #include "Renderer/RTRenderer.h"
 #include "Renderer/RasterRenderer.h"
 #include "Renderer/Renderer.h"
+#include "Scene/Components/CameraComponent.h"
+#include "Scene/Components/TransformComponent.h"
 #include "Scene/ECS.h"
 #include "Utils/FileIO.h"
 #include "Utils/Log.h"
@@ -24,8 +26,22 @@ void Carbonite::init()
 
 	[[maybe_unused]] auto& ecs = ECS::Get();
 
+	// Blocks and block states are registered before this, the registries and the table are not rebuilt afterwards.
+	m_BlockRegistry.freeze();
+	m_BlockStateRegistry.freeze();
+	m_BlockStateTable.build(m_BlockStateRegistry);
+
+	// There is only a single generated overworld, mods cannot add dimensions yet.
+	auto& overworld = *m_LoadedDimensions.emplace_back(std::make_unique<Dimension>());
+	overworld.setBlockStates(&m_BlockStateTable);
+	overworld.setGenerator([this](Chunk& chunk) { m_TerrainGenerator.generate(chunk); });
+	overworld.getLod().setGenerator([this](Chunk& node, std::uint32_t level) { m_TerrainGenerator.generateLod(node, level); });
+	overworld.setSaveDirectory(FileIO::getGameDir() / "Saves/Overworld/");
+
 	// TODO(MarcasRealAccount): Add a way to enable raytracing.
-	m_Renderer = new RasterRenderer();
+	auto renderer = new RasterRenderer();
+	renderer->setDimension(&overworld);
+	m_Renderer = renderer;
 	m_Renderer->init();
 }
 
@@ -37,16 +53,57 @@ void Carbonite::run()
 	{
 		glfwPollEvents();
 
+		updateWorld();
+
 		m_Renderer->render();
 	}
 }
 
+void Carbonite::updateWorld()
+{
+	auto& registry = ECS::Get().getRegistry();
+	auto  cameras  = registry.view<CameraComponent, TransformComponent>();
+
+	std::vector<glm::fvec3> focuses;
+	for (auto camera : cameras)
+		focuses.push_back(cameras.get<TransformComponent>(camera).getTranslation());
+
+	// Game ticks run at a fixed rate however fast frames are rendered.
+	constexpr auto TickInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)) / TicksPerSecond;
+
+	auto          now   = std::chrono::steady_clock::now();
+	std::uint32_t ticks = 0;
+	while (m_NextTick <= now && ticks < MaxCatchUpTicks)
+	{
+		m_NextTick += TickInterval;
+		++ticks;
+	}
+	if (m_NextTick <= now)
+		m_NextTick = now + TickInterval;
+
+	// Newly streamed in chunks and the edits of the ticks get lit before the renderer meshes them.
+	for (auto& dimension : m_LoadedDimensions)
+	{
+		dimension->updateStreaming(focuses);
+		for (std::uint32_t i = 0; i < ticks; ++i)
+		{
+			dimension->tick();
+			dimension->updateFluids();
+		}
+		dimension->updateLighting();
+		dimension->updateSaving();
+	}
+}
+
 void Carbonite::deinit()
 {
 	m_Renderer->deinit();
 	delete m_Renderer;
 	m_Renderer = nullptr;
 
+	// Unloading saves every chunk still in memory.
+	m_LoadedDimensions.clear();
+
 	ECS::Destroy();
 
 	Log::trace("Carbonite deinit");
@@ -2,17 +2,27 @@
 
 #include "Block/Block.h"
 #include "Block/BlockState.h"
+#include "Block/BlockStateTable.h"
 #include "Graphics/Window.h"
 #include "Mod/Mod.h"
 #include "Utils/InternalRegistry.h"
 #include "World/Dimension.h"
+#include "World/Generation/TerrainGenerator.h"
 
+#include <cstdint>
+
+#include <chrono>
+#include <memory>
 #include <vector>
 
 class Renderer;
 
 class Carbonite
 {
+public:
+	static constexpr std::uint32_t TicksPerSecond  = 20;
+	static constexpr std::uint32_t MaxCatchUpTicks = 10; // Per frame, a stalled game drops the rest instead of spiralling
+
 public:
 	static Carbonite& Get();
 	static void       Destroy();
@@ -34,18 +44,26 @@ protected:
 	void loadModAPI();
 	void loadAvailableMods();
 
+	// Streams the chunks of every loaded dimension around the cameras, runs the block ticks and fluid steps that are due
+	// at TicksPerSecond, then lights and saves them.
+	void updateWorld();
+
 public:
 	CSharp::Assembly* m_ModAPI;
 
 	std::vector<ModInfo> m_AvailableMods;
 	std::vector<Mod>     m_EnabledMods;
 
-	std::vector<Dimension> m_LoadedDimensions;
+	std::vector<std::unique_ptr<Dimension>> m_LoadedDimensions; // Created in init(), the renderer keeps a pointer to the first one
+	TerrainGenerator                        m_TerrainGenerator;
 
 	Registry<Block>      m_BlockRegistry;
 	Registry<BlockState> m_BlockStateRegistry;
+	BlockStateTable      m_BlockStateTable; // Frozen from m_BlockStateRegistry in init()
 
 private:
 	Graphics::Window m_Window;
 	Renderer*        m_Renderer;
+
+	std::chrono::steady_clock::time_point m_NextTick = std::chrono::steady_clock::now();
 };
@@ -0,0 +1,180 @@
+#include "ChunkMeshScheduler.h"
+#include "Carbonite/World/Dimension.h"
+#include "ChunkMesher.h"
+
+#include <algorithm>
+
+ChunkMeshScheduler::ChunkMeshScheduler(std::size_t workerCount, std::size_t resultCapacity)
+    : m_WorkerCount(workerCount), m_Results(resultCapacity)
+{
+	if (m_WorkerCount == 0)
+	{
+		// Leave one core for the main thread.
+		std::size_t hardwareThreads = std::thread::hardware_concurrency();
+		m_WorkerCount               = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+}
+
+ChunkMeshScheduler::~ChunkMeshScheduler()
+{
+	stop();
+}
+
+void ChunkMeshScheduler::start()
+{
+	if (m_Running)
+		return;
+
+	m_Running = true;
+	m_Workers.reserve(m_WorkerCount);
+	for (std::size_t i = 0; i < m_WorkerCount; ++i)
+		m_Workers.emplace_back(&ChunkMeshScheduler::workerLoop, this);
+}
+
+void ChunkMeshScheduler::stop()
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		if (!m_Running)
+			return;
+		m_Running = false;
+	}
+	m_Condition.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+	m_Workers.clear();
+}
+
+void ChunkMeshScheduler::setFocus(const glm::fvec3& position)
+{
+	std::lock_guard lock(m_Mutex);
+	m_Focus = position;
+
+	// Drop superseded entries while re-prioritising.
+	std::erase_if(m_Queue, [this](const QueueEntry& entry) {
+		auto itr = m_Jobs.find(entry.m_Coord);
+		return itr == m_Jobs.end() || itr->second.m_Ticket != entry.m_Ticket;
+	});
+	for (auto& entry : m_Queue)
+		entry.m_DistanceSquared = distanceSquared(entry.m_Coord);
+	std::make_heap(m_Queue.begin(), m_Queue.end());
+}
+
+void ChunkMeshScheduler::enqueue(const Dimension& dimension, const Chunk& chunk)
+{
+	std::array<const Chunk*, FaceCount> neighbours;
+	for (std::uint32_t i = 0; i < FaceCount; ++i)
+		neighbours[i] = dimension.getChunk(chunk.getCoord().neighbour(static_cast<EFace>(i)));
+	enqueue({ chunk.getCoord(), 0 }, chunk, neighbours);
+}
+
+void ChunkMeshScheduler::enqueue(const LodCoord& coord, const Chunk& chunk, const std::array<const Chunk*, FaceCount>& neighbours)
+{
+	Job job;
+	job.m_Revision = chunk.getRevision();
+	job.m_Voxels   = chunk.getVoxels();
+	for (std::uint32_t i = 0; i < FaceCount; ++i)
+		if (neighbours[i])
+			job.m_Neighbours[i] = neighbours[i]->getVoxels();
+
+	{
+		std::lock_guard lock(m_Mutex);
+		job.m_Ticket           = m_NextTicket++;
+		m_LatestTickets[coord] = job.m_Ticket;
+		m_Queue.push_back({ distanceSquared(coord), coord, job.m_Ticket });
+		std::push_heap(m_Queue.begin(), m_Queue.end());
+		m_Jobs.insert_or_assign(coord, std::move(job));
+	}
+	m_Condition.notify_one();
+}
+
+void ChunkMeshScheduler::cancel(const LodCoord& coord)
+{
+	std::lock_guard lock(m_Mutex);
+	m_Jobs.erase(coord);
+	m_LatestTickets.erase(coord);
+}
+
+std::size_t ChunkMeshScheduler::getPendingCount() const
+{
+	std::lock_guard lock(m_Mutex);
+	return m_LatestTickets.size();
+}
+
+void ChunkMeshScheduler::workerLoop()
+{
+	ChunkMesher mesher;
+	while (true)
+	{
+		Job      job;
+		LodCoord coord;
+		{
+			std::unique_lock lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return !m_Running || !m_Queue.empty(); });
+			if (!m_Running)
+				return;
+
+			std::pop_heap(m_Queue.begin(), m_Queue.end());
+			QueueEntry entry = m_Queue.back();
+			m_Queue.pop_back();
+
+			auto itr = m_Jobs.find(entry.m_Coord);
+			if (itr == m_Jobs.end() || itr->second.m_Ticket != entry.m_Ticket)
+				continue;
+
+			job   = std::move(itr->second);
+			coord = entry.m_Coord;
+			m_Jobs.erase(itr);
+		}
+
+		std::array<const ChunkStorage*, FaceCount> neighbours;
+		for (std::uint32_t i = 0; i < FaceCount; ++i)
+			neighbours[i] = job.m_Neighbours[i] ? &*job.m_Neighbours[i] : nullptr;
+
+		mesher.setBlockStates(m_BlockStates);
+
+		ChunkMeshResult result;
+		result.m_Coord    = coord;
+		result.m_Revision = job.m_Revision;
+		result.m_Ticket   = job.m_Ticket;
+		mesher.mesh(job.m_Voxels, neighbours, result.m_Vertices, result.m_Indices);
+		result.m_Visibility = mesher.getVisibility();
+
+		while (!m_Results.push(std::move(result)))
+		{
+			if (!m_Running || !isLatestTicket(result.m_Coord, result.m_Ticket))
+				break;
+			std::this_thread::yield();
+		}
+	}
+}
+
+float ChunkMeshScheduler::distanceSquared(const LodCoord& coord) const
+{
+	float size     = static_cast<float>(coord.getSize() * Chunk::Size);
+	float halfSize = size * 0.5f;
+
+	float dx = static_cast<float>(coord.m_Coord.m_X) * size + halfSize - m_Focus.x;
+	float dy = static_cast<float>(coord.m_Coord.m_Y) * size + halfSize - m_Focus.y;
+	float dz = static_cast<float>(coord.m_Coord.m_Z) * size + halfSize - m_Focus.z;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+bool ChunkMeshScheduler::isLatestTicket(const LodCoord& coord, std::uint64_t ticket) const
+{
+	std::lock_guard lock(m_Mutex);
+	auto            itr = m_LatestTickets.find(coord);
+	return itr != m_LatestTickets.end() && itr->second == ticket;
+}
+
+bool ChunkMeshScheduler::retireTicket(const LodCoord& coord, std::uint64_t ticket)
+{
+	std::lock_guard lock(m_Mutex);
+	auto            itr = m_LatestTickets.find(coord);
+	if (itr == m_LatestTickets.end() || itr->second != ticket)
+		return false;
+
+	m_LatestTickets.erase(itr);
+	return true;
+}
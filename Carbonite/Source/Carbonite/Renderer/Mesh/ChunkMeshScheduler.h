@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Carbonite/World/Chunk.h"
+#include "Carbonite/World/ChunkCoord.h"
+#include "Carbonite/World/ChunkLod.h"
+#include "ChunkVisibility.h"
+#include "Mesh.h"
+#include "Utils/MPMCQueue.h"
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Dimension;
+
+struct ChunkMeshResult
+{
+public:
+	LodCoord                   m_Coord;
+	std::uint64_t              m_Revision = 0; // Revision of the chunk the mesh was built from
+	std::uint64_t              m_Ticket   = 0;
+	ChunkVisibility            m_Visibility;
+	std::vector<Vertex>        m_Vertices;
+	std::vector<std::uint32_t> m_Indices;
+};
+
+// Meshes dirty chunks and LOD nodes on a pool of background workers.
+// Jobs are ordered by the distance between the chunk and the focus (the active camera), closest first.
+// Enqueuing takes copy on write copies of the voxels of the chunk and its neighbours, so workers never read chunks the main
+// thread is editing.
+// Enqueuing a chunk again supersedes the older job, results of superseded or cancelled jobs are dropped.
+// Finished meshes are handed back through a lock free queue and uploaded by the render thread in drainResults().
+class ChunkMeshScheduler
+{
+public:
+	ChunkMeshScheduler(std::size_t workerCount = 0, std::size_t resultCapacity = 256);
+	~ChunkMeshScheduler();
+
+	void start();
+	void stop();
+
+	void setFocus(const glm::fvec3& position);
+	// Applies to jobs picked up afterwards, the table must outlive the scheduler.
+	void setBlockStates(const BlockStateTable* blockStates) { m_BlockStates = blockStates; }
+
+	void enqueue(const Dimension& dimension, const Chunk& chunk);
+	// Meshes a chunk or LOD node against the given neighbours, missing neighbours leave their border faces in place.
+	void enqueue(const LodCoord& coord, const Chunk& chunk, const std::array<const Chunk*, FaceCount>& neighbours);
+	void cancel(const LodCoord& coord);
+
+	// Calls func(ChunkMeshResult&&) for at most maxResults up to date results, returns how many were handed out.
+	template <class F>
+	std::size_t drainResults(F&& func, std::size_t maxResults = ~0ULL)
+	{
+		std::size_t     count = 0;
+		ChunkMeshResult result;
+		while (count < maxResults && m_Results.pop(result))
+		{
+			if (!retireTicket(result.m_Coord, result.m_Ticket))
+				continue;
+
+			func(std::move(result));
+			++count;
+		}
+		return count;
+	}
+
+	std::size_t getPendingCount() const;
+	auto        getWorkerCount() const { return m_WorkerCount; }
+
+private:
+	struct Job
+	{
+	public:
+		std::uint64_t                                      m_Ticket   = 0;
+		std::uint64_t                                      m_Revision = 0;
+		ChunkStorage                                       m_Voxels; // Copy on write copies, taking them costs a reference count
+		std::array<std::optional<ChunkStorage>, FaceCount> m_Neighbours;
+	};
+
+	struct QueueEntry
+	{
+	public:
+		float         m_DistanceSquared;
+		LodCoord      m_Coord;
+		std::uint64_t m_Ticket;
+
+		// std::push_heap builds a max heap, invert so the closest chunk is on top.
+		friend bool operator<(const QueueEntry& lhs, const QueueEntry& rhs) { return lhs.m_DistanceSquared > rhs.m_DistanceSquared; }
+	};
+
+	void  workerLoop();
+	float distanceSquared(const LodCoord& coord) const;
+	bool  isLatestTicket(const LodCoord& coord, std::uint64_t ticket) const;
+	bool  retireTicket(const LodCoord& coord, std::uint64_t ticket);
+
+private:
+	std::size_t              m_WorkerCount;
+	std::vector<std::thread> m_Workers;
+	std::atomic<bool>        m_Running = false;
+
+	std::atomic<const BlockStateTable*> m_BlockStates = &BlockStateTable::Default();
+
+	mutable std::mutex                                         m_Mutex;
+	std::condition_variable                                    m_Condition;
+	std::vector<QueueEntry>                                    m_Queue;
+	std::unordered_map<LodCoord, Job, LodCoordHash>            m_Jobs;
+	std::unordered_map<LodCoord, std::uint64_t, LodCoordHash> m_LatestTickets;
+	std::uint64_t                                              m_NextTicket = 1;
+	glm::fvec3                                                 m_Focus      = { 0.0f, 0.0f, 0.0f };
+
+	MPMCQueue<ChunkMeshResult> m_Results;
+};
@@ -0,0 +1,343 @@
+#include "ChunkMesher.h"
+#include "Carbonite/World/Dimension.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace
+{
+	// Bit per voxel of the snapshot, set for the border voxels that belong to the neighbours.
+	const std::vector<std::uint64_t>& GetBorderMask()
+	{
+		static const std::vector<std::uint64_t> s_Mask = [] {
+			constexpr std::int32_t Last = static_cast<std::int32_t>(Chunk::Size);
+
+			std::vector<std::uint64_t> mask((ChunkSnapshot::VoxelCount + 63) / 64, 0);
+			for (std::int32_t z = -1; z <= Last; ++z)
+			{
+				for (std::int32_t y = -1; y <= Last; ++y)
+				{
+					for (std::int32_t x = -1; x <= Last; ++x)
+					{
+						if (x >= 0 && x < Last && y >= 0 && y < Last && z >= 0 && z < Last)
+							continue;
+						std::size_t index = ChunkSnapshot::PositionToIndex(x, y, z);
+						mask[index / 64] |= 1ULL << (index % 64);
+					}
+				}
+			}
+			return mask;
+		}();
+		return s_Mask;
+	}
+} // namespace
+
+ChunkMesher::ChunkMesher()
+    : m_Mask(SliceSize, Chunk::EmptyState),
+      m_Columns(3 * SliceSize, 0),
+      m_FaceRows(Size * Size, 0),
+      m_Visited((ChunkSnapshot::VoxelCount + 63) / 64, 0) {}
+
+void ChunkMesher::mesh(const Dimension& dimension, const Chunk& chunk, Mesh& mesh)
+{
+	auto                                neighbours = dimension.getNeighbours(chunk.getCoord());
+	std::array<const Chunk*, FaceCount> constNeighbours;
+	for (std::uint32_t i = 0; i < FaceCount; ++i)
+		constNeighbours[i] = neighbours[i];
+	this->mesh(chunk, constNeighbours, mesh);
+}
+
+void ChunkMesher::mesh(const Chunk& chunk, const std::array<const Chunk*, FaceCount>& neighbours, Mesh& mesh)
+{
+	this->mesh(chunk, neighbours, mesh.m_Vertices, mesh.m_Indices);
+}
+
+void ChunkMesher::mesh(const Chunk& chunk, const std::array<const Chunk*, FaceCount>& neighbours, std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices)
+{
+	std::array<const ChunkStorage*, FaceCount> neighbourVoxels;
+	for (std::uint32_t i = 0; i < FaceCount; ++i)
+		neighbourVoxels[i] = neighbours[i] ? &neighbours[i]->getVoxels() : nullptr;
+	mesh(chunk.getVoxels(), neighbourVoxels, vertices, indices);
+}
+
+void ChunkMesher::mesh(const ChunkStorage& voxels, const std::array<const ChunkStorage*, FaceCount>& neighbours, std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices)
+{
+	m_Snapshot.capture(voxels, neighbours, 0);
+
+	auto&       palette      = voxels.getPalette();
+	std::size_t opaqueStates = 0;
+	for (auto state : palette)
+		if (isOpaque(state))
+			++opaqueStates;
+
+	if (m_Mode == EChunkMesherMode::Binary)
+		buildQuadsBinary(opaqueStates <= 1);
+	else
+		buildQuads();
+	emitQuads(vertices, indices);
+	buildVisibility(opaqueStates, palette.size());
+}
+
+void ChunkMesher::buildQuads()
+{
+	m_Quads.clear();
+
+	for (std::uint32_t face = 0; face < FaceCount; ++face)
+	{
+		std::uint32_t axis     = getFaceAxis(static_cast<EFace>(face));
+		bool          positive = isPositiveFace(static_cast<EFace>(face));
+
+		for (std::uint32_t slice = 0; slice < Size; ++slice)
+		{
+			std::int32_t adjacentSlice = static_cast<std::int32_t>(slice) + (positive ? 1 : -1);
+
+			for (std::uint32_t u = 0; u < Size; ++u)
+			{
+				for (std::uint32_t v = 0; v < Size; ++v)
+				{
+					std::uint64_t state    = getVoxel(axis, slice, u, v);
+					std::uint64_t adjacent = getVoxel(axis, adjacentSlice, u, v);
+					m_Mask[u * Size + v]   = isOpaque(state) && !isOpaque(adjacent) ? state : Chunk::EmptyState;
+				}
+			}
+
+			for (std::uint32_t u = 0; u < Size; ++u)
+			{
+				for (std::uint32_t v = 0; v < Size;)
+				{
+					std::uint64_t state = m_Mask[u * Size + v];
+					if (state == Chunk::EmptyState)
+					{
+						++v;
+						continue;
+					}
+
+					std::uint32_t width = 1;
+					while (v + width < Size && m_Mask[u * Size + v + width] == state)
+						++width;
+
+					std::uint32_t height = 1;
+					for (; u + height < Size; ++height)
+					{
+						const std::uint64_t* row = m_Mask.data() + (u + height) * Size + v;
+						std::uint32_t        i   = 0;
+						while (i < width && row[i] == state)
+							++i;
+						if (i < width)
+							break;
+					}
+
+					for (std::uint32_t du = 0; du < height; ++du)
+						std::fill_n(m_Mask.data() + (u + du) * Size + v, width, Chunk::EmptyState);
+
+					m_Quads.push_back({ state, static_cast<EFace>(face), static_cast<std::uint8_t>(slice), static_cast<std::uint8_t>(u), static_cast<std::uint8_t>(v), static_cast<std::uint8_t>(height), static_cast<std::uint8_t>(width) });
+					v += width;
+				}
+			}
+		}
+	}
+}
+
+void ChunkMesher::buildQuadsBinary(bool singleOpaqueState)
+{
+	m_Quads.clear();
+	std::fill(m_Columns.begin(), m_Columns.end(), 0);
+
+	std::uint64_t* columnsX = m_Columns.data();
+	std::uint64_t* columnsY = columnsX + SliceSize;
+	std::uint64_t* columnsZ = columnsY + SliceSize;
+	for (std::uint32_t z = 0; z < Size; ++z)
+	{
+		for (std::uint32_t y = 0; y < Size; ++y)
+		{
+			const std::uint64_t* row = m_Snapshot.getRow(y, z);
+			for (std::uint32_t x = 0; x < Size; ++x)
+			{
+				if (!isOpaque(row[x]))
+					continue;
+
+				columnsX[y * Size + z] |= 1ULL << (x + 1);
+				columnsY[z * Size + x] |= 1ULL << (y + 1);
+				columnsZ[x * Size + y] |= 1ULL << (z + 1);
+			}
+		}
+	}
+
+	for (std::uint32_t face = 0; face < FaceCount; ++face)
+	{
+		std::uint32_t  axis     = getFaceAxis(static_cast<EFace>(face));
+		bool           positive = isPositiveFace(static_cast<EFace>(face));
+		std::int32_t   slice    = positive ? static_cast<std::int32_t>(Size) : -1;
+		std::uint64_t* columns  = m_Columns.data() + axis * SliceSize;
+		std::uint64_t  bit      = positive ? 1ULL << (Size + 1) : 1ULL;
+		for (std::uint32_t u = 0; u < Size; ++u)
+			for (std::uint32_t v = 0; v < Size; ++v)
+				if (isOpaque(getVoxel(axis, slice, u, v)))
+					columns[u * Size + v] |= bit;
+	}
+
+	for (std::uint32_t face = 0; face < FaceCount; ++face)
+	{
+		std::uint32_t        axis     = getFaceAxis(static_cast<EFace>(face));
+		bool                 positive = isPositiveFace(static_cast<EFace>(face));
+		const std::uint64_t* columns  = m_Columns.data() + axis * SliceSize;
+
+		// A face is visible where a voxel is opaque and the next one along the face normal is not.
+		std::fill(m_FaceRows.begin(), m_FaceRows.end(), 0);
+		for (std::uint32_t i = 0; i < SliceSize; ++i)
+		{
+			std::uint64_t column = columns[i];
+			std::uint64_t faces  = positive ? column & ~(column >> 1) : column & ~(column << 1);
+			faces                = (faces >> 1) & 0xFFFF'FFFF;
+
+			std::uint32_t u = i / Size;
+			std::uint32_t v = i % Size;
+			while (faces)
+			{
+				std::uint32_t slice = static_cast<std::uint32_t>(std::countr_zero(faces));
+				faces &= faces - 1;
+				m_FaceRows[slice * Size + u] |= 1U << v;
+			}
+		}
+
+		// Greedy merge in the same u, v scan order as the reference so both produce identical quads.
+		for (std::uint32_t slice = 0; slice < Size; ++slice)
+		{
+			std::uint32_t* rows = m_FaceRows.data() + slice * Size;
+			for (std::uint32_t u = 0; u < Size; ++u)
+			{
+				while (rows[u])
+				{
+					std::uint32_t v     = static_cast<std::uint32_t>(std::countr_zero(rows[u]));
+					std::uint64_t state = getVoxel(axis, slice, u, v);
+					std::uint32_t width = static_cast<std::uint32_t>(std::countr_zero(~(rows[u] >> v)));
+					if (!singleOpaqueState)
+					{
+						std::uint32_t sameWidth = 1;
+						while (sameWidth < width && getVoxel(axis, slice, u, v + sameWidth) == state)
+							++sameWidth;
+						width = sameWidth;
+					}
+					std::uint32_t runMask = static_cast<std::uint32_t>(((1ULL << width) - 1) << v);
+
+					std::uint32_t height = 1;
+					for (; u + height < Size; ++height)
+					{
+						if ((rows[u + height] & runMask) != runMask)
+							break;
+
+						if (!singleOpaqueState)
+						{
+							std::uint32_t i = 0;
+							while (i < width && getVoxel(axis, slice, u + height, v + i) == state)
+								++i;
+							if (i < width)
+								break;
+						}
+					}
+
+					for (std::uint32_t du = 0; du < height; ++du)
+						rows[u + du] &= ~runMask;
+
+					m_Quads.push_back({ state, static_cast<EFace>(face), static_cast<std::uint8_t>(slice), static_cast<std::uint8_t>(u), static_cast<std::uint8_t>(v), static_cast<std::uint8_t>(height), static_cast<std::uint8_t>(width) });
+				}
+			}
+		}
+	}
+}
+
+void ChunkMesher::emitQuads(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices) const
+{
+	vertices.clear();
+	indices.clear();
+	vertices.reserve(m_Quads.size() * 4);
+	indices.reserve(m_Quads.size() * 6);
+
+	for (auto& quad : m_Quads)
+	{
+		std::uint32_t axis     = getFaceAxis(quad.m_Face);
+		bool          positive = isPositiveFace(quad.m_Face);
+
+		float plane = static_cast<float>(quad.m_Slice + (positive ? 1 : 0));
+		float u0    = static_cast<float>(quad.m_U);
+		float v0    = static_cast<float>(quad.m_V);
+		float u1    = u0 + quad.m_Height;
+		float v1    = v0 + quad.m_Width;
+
+		float normal[3] = { 0.0f, 0.0f, 0.0f };
+		normal[axis]    = positive ? 1.0f : -1.0f;
+
+		const float corners[4][2] = { { u0, v0 }, { u1, v0 }, { u1, v1 }, { u0, v1 } };
+
+		std::uint32_t base = static_cast<std::uint32_t>(vertices.size());
+		for (auto& corner : corners)
+		{
+			float position[3];
+			position[axis]           = plane;
+			position[(axis + 1) % 3] = corner[0];
+			position[(axis + 2) % 3] = corner[1];
+			vertices.push_back({ { position[0], position[1], position[2], 1.0f }, { normal[0], normal[1], normal[2], 0.0f }, { corner[0] - u0, corner[1] - v0 } });
+		}
+
+		// (u, v, axis) is right handed, so the corner order is counter clockwise seen from the positive side.
+		if (positive)
+			indices.insert(indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+		else
+			indices.insert(indices.end(), { base, base + 2, base + 1, base, base + 3, base + 2 });
+	}
+}
+
+void ChunkMesher::buildVisibility(std::size_t opaqueStates, std::size_t stateCount)
+{
+	// The palette may list states no voxel uses anymore, these shortcuts only trust what it cannot contain.
+	m_Visibility = opaqueStates == 0 ? ChunkVisibility::All() : ChunkVisibility {};
+	if (opaqueStates == 0 || opaqueStates == stateCount)
+		return;
+
+	// The flood runs over the padded snapshot, reaching a border voxel means the chunk face it belongs to is reachable.
+	constexpr std::int32_t Padded = ChunkSnapshot::Size;
+	constexpr std::int32_t Strides[FaceCount] { -1, 1, -Padded, Padded, -Padded * Padded, Padded * Padded };
+
+	auto& voxels = m_Snapshot.getVoxels();
+	auto& border = GetBorderMask();
+	std::fill(m_Visited.begin(), m_Visited.end(), 0);
+	for (std::int32_t z = 0; z < static_cast<std::int32_t>(Size); ++z)
+	{
+		for (std::int32_t y = 0; y < static_cast<std::int32_t>(Size); ++y)
+		{
+			std::uint32_t row = static_cast<std::uint32_t>(ChunkSnapshot::PositionToIndex(0, y, z));
+			for (std::uint32_t start = row; start < row + Size; ++start)
+			{
+				if ((m_Visited[start / 64] >> (start % 64)) & 1 || isOpaque(voxels[start]))
+					continue;
+
+				std::uint32_t faces = 0;
+				m_Visited[start / 64] |= 1ULL << (start % 64);
+				m_Flood.push_back(static_cast<std::uint16_t>(start));
+				while (!m_Flood.empty())
+				{
+					std::uint32_t index = m_Flood.back();
+					m_Flood.pop_back();
+
+					for (std::uint32_t face = 0; face < FaceCount; ++face)
+					{
+						std::uint32_t next = static_cast<std::uint32_t>(static_cast<std::int32_t>(index) + Strides[face]);
+						if ((border[next / 64] >> (next % 64)) & 1)
+						{
+							faces |= 1U << face;
+							continue;
+						}
+						if ((m_Visited[next / 64] >> (next % 64)) & 1 || isOpaque(voxels[next]))
+							continue;
+						m_Visited[next / 64] |= 1ULL << (next % 64);
+						m_Flood.push_back(static_cast<std::uint16_t>(next));
+					}
+				}
+
+				m_Visibility.connectAll(faces);
+				if (m_Visibility == ChunkVisibility::All())
+					return;
+			}
+		}
+	}
+}
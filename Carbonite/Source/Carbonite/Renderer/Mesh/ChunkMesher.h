@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Carbonite/World/Chunk.h"
+#include "Carbonite/World/ChunkCoord.h"
+#include "Carbonite/World/ChunkSnapshot.h"
+#include "ChunkVisibility.h"
+#include "Mesh.h"
+
+#include <cstdint>
+
+#include <array>
+#include <vector>
+
+class Dimension;
+
+// A merged rectangle of faces in a single slice of the chunk.
+// For a face on axis a, u is axis (a + 1) % 3 and v is axis (a + 2) % 3, m_Height spans u and m_Width spans v.
+struct ChunkMeshQuad
+{
+public:
+	std::uint64_t m_State;
+	EFace         m_Face;
+	std::uint8_t  m_Slice;
+	std::uint8_t  m_U, m_V;
+	std::uint8_t  m_Height, m_Width;
+
+	friend bool operator==(const ChunkMeshQuad& lhs, const ChunkMeshQuad& rhs)
+	{
+		return lhs.m_State == rhs.m_State && lhs.m_Face == rhs.m_Face && lhs.m_Slice == rhs.m_Slice && lhs.m_U == rhs.m_U && lhs.m_V == rhs.m_V && lhs.m_Height == rhs.m_Height && lhs.m_Width == rhs.m_Width;
+	}
+};
+
+enum class EChunkMesherMode : std::uint8_t
+{
+	Reference, // Scalar voxel by voxel greedy meshing
+	Binary     // Bitmask culling and greedy merging on 32 bit occupancy rows, produces the same quads as Reference
+};
+
+// Turns chunk voxels into greedy meshed geometry.
+// Only opaque voxels (BlockStateTable::isOpaque) get faces, and only where the adjacent voxel is not opaque, including
+// against the neighbouring chunks. Non opaque voxels such as air or glass produce no faces.
+// Coplanar faces of the same state are merged into as few quads as possible.
+// Meshing also flood fills the non opaque voxels to find which faces of the chunk can see each other.
+// All scratch memory is owned by the mesher, reuse one mesher per thread to avoid allocations.
+class ChunkMesher
+{
+public:
+	static constexpr std::size_t Size      = Chunk::Size;
+	static constexpr std::size_t SliceSize = Size * Size;
+
+public:
+	ChunkMesher();
+
+	void mesh(const Dimension& dimension, const Chunk& chunk, Mesh& mesh);
+	void mesh(const Chunk& chunk, const std::array<const Chunk*, FaceCount>& neighbours, Mesh& mesh);
+	void mesh(const Chunk& chunk, const std::array<const Chunk*, FaceCount>& neighbours, std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices);
+	// Meshing only reads voxels, so copy on write copies of them can be meshed on any thread.
+	void mesh(const ChunkStorage& voxels, const std::array<const ChunkStorage*, FaceCount>& neighbours, std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices);
+
+	void setMode(EChunkMesherMode mode) { m_Mode = mode; }
+	auto getMode() const { return m_Mode; }
+
+	// Decides which states are opaque, must outlive the mesher.
+	void  setBlockStates(const BlockStateTable* blockStates) { m_BlockStates = blockStates; }
+	auto& getBlockStates() const { return *m_BlockStates; }
+
+	auto& getQuads() const { return m_Quads; }
+	auto& getVisibility() const { return m_Visibility; }
+
+private:
+	void buildQuads();
+	void buildQuadsBinary(bool singleOpaqueState);
+	void emitQuads(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices) const;
+	void buildVisibility(std::size_t opaqueStates, std::size_t stateCount);
+
+	bool isOpaque(std::uint64_t state) const { return m_BlockStates->isOpaque(state); }
+
+	// Returns the state of the voxel at slice position (slice, u, v) for faces on the given axis.
+	// Slices -1 and Size are the border layers of the neighbours.
+	std::uint64_t getVoxel(std::uint32_t axis, std::int32_t slice, std::int32_t u, std::int32_t v) const
+	{
+		std::int32_t position[3];
+		position[axis]           = slice;
+		position[(axis + 1) % 3] = u;
+		position[(axis + 2) % 3] = v;
+		return m_Snapshot.get(position[0], position[1], position[2]);
+	}
+
+private:
+	ChunkSnapshot              m_Snapshot;
+	std::vector<std::uint64_t> m_Mask;
+	std::vector<ChunkMeshQuad> m_Quads;
+
+	// Opaque voxels per column along every axis, indexed by axis * SliceSize + u * Size + v.
+	// Bit 0 is the negative neighbour, bits 1 to 32 are the slices and bit 33 is the positive neighbour.
+	std::vector<std::uint64_t> m_Columns;
+	std::vector<std::uint32_t> m_FaceRows; // Visible faces of one face direction, indexed by slice * Size + u with v as bit
+
+	std::vector<std::uint64_t> m_Visited; // Flood filled voxels, bit per voxel of the snapshot
+	std::vector<std::uint16_t> m_Flood;
+	ChunkVisibility            m_Visibility;
+
+	EChunkMesherMode       m_Mode        = EChunkMesherMode::Binary;
+	const BlockStateTable* m_BlockStates = &BlockStateTable::Default();
+};
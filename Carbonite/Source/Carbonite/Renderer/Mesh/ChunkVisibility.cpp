@@ -0,0 +1,109 @@
+#include "ChunkVisibility.h"
+#include "Carbonite/World/Chunk.h"
+
+#include <cmath>
+
+void ChunkVisibilityGraph::setChunk(const ChunkCoord& coord, const ChunkVisibility& visibility)
+{
+	m_Chunks[coord].m_Visibility = visibility;
+}
+
+void ChunkVisibilityGraph::removeChunk(const ChunkCoord& coord)
+{
+	m_Chunks.erase(coord);
+}
+
+void ChunkVisibilityGraph::clear()
+{
+	m_Chunks.clear();
+	m_Enabled = false;
+}
+
+bool ChunkVisibilityGraph::update(const glm::fmat4& projectionView, const glm::fvec3& camera)
+{
+	// Clip space planes, w + x >= 0, w - x >= 0 and so on for y, the near plane is w + z >= 0 which also holds for a 0 to 1 depth range.
+	for (std::uint32_t i = 0; i < m_Planes.size(); ++i)
+	{
+		std::uint32_t axis = i / 2;
+		float         sign = i & 1 ? -1.0f : 1.0f;
+		for (std::uint32_t j = 0; j < 4; ++j)
+			m_Planes[i][j] = projectionView[j][3] + sign * projectionView[j][axis];
+	}
+
+	++m_Frame;
+	m_Escaped      = false;
+	m_VisibleCount = 0;
+	m_Queue.clear();
+
+	ChunkCoord start { static_cast<std::int64_t>(std::floor(camera.x / Chunk::Size)),
+		               static_cast<std::int64_t>(std::floor(camera.y / Chunk::Size)),
+		               static_cast<std::int64_t>(std::floor(camera.z / Chunk::Size)) };
+	auto       itr = m_Chunks.find(start);
+	m_Enabled      = itr != m_Chunks.end();
+	if (!m_Enabled)
+	{
+		m_Escaped = true;
+		return false;
+	}
+
+	itr->second.m_VisitedFrame = m_Frame;
+	m_Queue.push_back({ &itr->second, start, 0, static_cast<std::uint8_t>(FaceCount) });
+	for (std::size_t i = 0; i < m_Queue.size(); ++i)
+	{
+		Step step = m_Queue[i];
+		for (std::uint32_t j = 0; j < FaceCount; ++j)
+		{
+			EFace face = static_cast<EFace>(j);
+			if (step.m_Directions & (1U << static_cast<std::uint32_t>(getOppositeFace(face))))
+				continue;
+			if (step.m_Entry != FaceCount && !step.m_Node->m_Visibility.connects(static_cast<EFace>(step.m_Entry), face))
+				continue;
+
+			ChunkCoord coord = step.m_Coord.neighbour(face);
+			glm::fvec3 min   = { static_cast<float>(coord.m_X * Chunk::Size), static_cast<float>(coord.m_Y * Chunk::Size), static_cast<float>(coord.m_Z * Chunk::Size) };
+			glm::fvec3 max   = { min.x + Chunk::Size, min.y + Chunk::Size, min.z + Chunk::Size };
+			if (!isInFrustum(min, max))
+				continue;
+
+			auto next = m_Chunks.find(coord);
+			if (next == m_Chunks.end())
+			{
+				m_Escaped = true;
+				continue;
+			}
+			if (next->second.m_VisitedFrame == m_Frame)
+				continue;
+
+			next->second.m_VisitedFrame = m_Frame;
+			m_Queue.push_back({ &next->second, coord, static_cast<std::uint8_t>(step.m_Directions | (1U << j)), static_cast<std::uint8_t>(getOppositeFace(face)) });
+		}
+	}
+	m_VisibleCount = m_Queue.size();
+	return true;
+}
+
+bool ChunkVisibilityGraph::isVisible(const ChunkCoord& coord) const
+{
+	if (!m_Enabled)
+	{
+		glm::fvec3 min = { static_cast<float>(coord.m_X * Chunk::Size), static_cast<float>(coord.m_Y * Chunk::Size), static_cast<float>(coord.m_Z * Chunk::Size) };
+		return isInFrustum(min, { min.x + Chunk::Size, min.y + Chunk::Size, min.z + Chunk::Size });
+	}
+
+	auto itr = m_Chunks.find(coord);
+	return itr != m_Chunks.end() && itr->second.m_VisitedFrame == m_Frame;
+}
+
+bool ChunkVisibilityGraph::isInFrustum(const glm::fvec3& min, const glm::fvec3& max) const
+{
+	for (auto& plane : m_Planes)
+	{
+		// Only the corner furthest along the plane normal has to be tested.
+		float x = plane.x >= 0.0f ? max.x : min.x;
+		float y = plane.y >= 0.0f ? max.y : min.y;
+		float z = plane.z >= 0.0f ? max.z : min.z;
+		if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Carbonite/World/ChunkCoord.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Which faces of a chunk can see each other through its non opaque voxels, a symmetric 6x6 bit matrix.
+struct ChunkVisibility
+{
+public:
+	static constexpr ChunkVisibility All() { return { (1ULL << (FaceCount * FaceCount)) - 1 }; }
+
+	constexpr bool connects(EFace lhs, EFace rhs) const { return (m_Connections >> Bit(lhs, rhs)) & 1; }
+
+	// Connects every pair of faces set in faces (bit per EFace).
+	constexpr void connectAll(std::uint32_t faces)
+	{
+		for (std::uint32_t i = 0; i < FaceCount; ++i)
+			if (faces & (1U << i))
+				m_Connections |= static_cast<std::uint64_t>(faces) << (i * FaceCount);
+	}
+
+	friend constexpr bool operator==(const ChunkVisibility& lhs, const ChunkVisibility& rhs) { return lhs.m_Connections == rhs.m_Connections; }
+	friend constexpr bool operator!=(const ChunkVisibility& lhs, const ChunkVisibility& rhs) { return !(lhs == rhs); }
+
+public:
+	std::uint64_t m_Connections = 0;
+
+private:
+	static constexpr std::uint32_t Bit(EFace lhs, EFace rhs) { return static_cast<std::uint32_t>(lhs) * FaceCount + static_cast<std::uint32_t>(rhs); }
+};
+
+// Cave culling over the face connectivity of the meshed chunks.
+// update() walks the graph breadth first from the camera's chunk. A chunk is left through a face only if that face can be
+// seen from the face the walk came in through, the walk never turns back against a direction it already moved in and
+// only enters chunks inside the view frustum. Chunks the walk does not reach cannot be seen from the camera.
+class ChunkVisibilityGraph
+{
+public:
+	void setChunk(const ChunkCoord& coord, const ChunkVisibility& visibility);
+	void removeChunk(const ChunkCoord& coord);
+	void clear();
+
+	// Returns false if the camera is not inside a chunk of the graph, nothing is culled then.
+	bool update(const glm::fmat4& projectionView, const glm::fvec3& camera);
+
+	bool isVisible(const ChunkCoord& coord) const;
+	// Whether the walk tried to leave the chunks of the graph, everything outside can only be seen if it did.
+	bool hasEscaped() const { return m_Escaped; }
+	// Box in world coordinates against the frustum of the last update.
+	bool isInFrustum(const glm::fvec3& min, const glm::fvec3& max) const;
+
+	auto getVisibleCount() const { return m_VisibleCount; }
+	auto getChunkCount() const { return m_Chunks.size(); }
+
+private:
+	struct Node
+	{
+	public:
+		ChunkVisibility m_Visibility;
+		std::uint64_t   m_VisitedFrame = 0;
+	};
+
+	struct Step
+	{
+	public:
+		Node*        m_Node;
+		ChunkCoord   m_Coord;
+		std::uint8_t m_Directions; // Faces moved through so far, bit per EFace
+		std::uint8_t m_Entry;      // Face the walk came in through, FaceCount for the camera's chunk
+	};
+
+private:
+	std::unordered_map<ChunkCoord, Node, ChunkCoordHash> m_Chunks;
+	std::array<glm::fvec4, 5>                            m_Planes {}; // Left, right, bottom, top and near, the far plane may be infinite
+	std::uint64_t                                        m_Frame        = 0;
+	bool                                                 m_Enabled      = false;
+	bool                                                 m_Escaped      = false;
+	std::size_t                                          m_VisibleCount = 0;
+	std::vector<Step>                                    m_Queue;
+};
@@ -3,9 +3,12 @@
 #include "Carbonite/Scene/Components/StaticMeshComponent.h"
 #include "Carbonite/Scene/Components/TransformComponent.h"
 #include "Carbonite/Scene/ECS.h"
+#include "Carbonite/World/Dimension.h"
 #include "Utils/Log.h"
 #include "Utils/Utils.h"
 
+#include <unordered_set>
+
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 
@@ -20,6 +23,17 @@ RasterRenderer::RasterRenderer()
       m_CameraTransform(nullptr),
       m_Mesh(m_Vma) {}
 
+void RasterRenderer::setDimension(Dimension* dimension)
+{
+	if (m_Dimension == dimension)
+		return;
+
+	while (!m_ChunkMeshes.empty())
+		removeChunkMesh(m_ChunkMeshes.begin()->first);
+	m_Dimension = dimension;
+	m_ChunkMeshScheduler.setBlockStates(dimension ? &dimension->getBlockStates() : &BlockStateTable::Default());
+}
+
 void RasterRenderer::initImpl()
 {
 	Log::trace("RasterRenderer init");
@@ -139,11 +153,16 @@ void RasterRenderer::initImpl()
 
 	entt::entity cube = m_Scene.instantiate({});
 	registry.emplace<StaticMeshComponent>(cube, &m_Mesh);
+
+	m_ChunkMeshScheduler.start();
 }
 
 void RasterRenderer::deinitImpl()
 {
 	Log::trace("RasterRenderer deinit");
+
+	m_ChunkMeshScheduler.stop();
+	setDimension(nullptr);
 }
 
 static glm::fvec3 rotation = { 0.0f, 0.0f, 0.0f };
@@ -155,6 +174,8 @@ void RasterRenderer::renderImpl()
 	m_CameraTransform->setRotation(rotation);
 	m_CameraTransform->setTranslation(m_CameraTransform->getForward() * -5.0f);
 
+	updateChunkMeshes();
+
 	void* uniformBufferMemory = m_UniformBuffer.mapMemory();
 
 	auto& currentCommandPool   = *getCurrentCommandPool();
@@ -171,6 +192,7 @@ void RasterRenderer::renderImpl()
 			auto& cameraComponent = cameras.get<CameraComponent>(camera);
 			cameraComponent.setAspect(static_cast<float>(m_Swapchain.m_Width) / m_Swapchain.m_Height);
 			auto& projectionViewMatrix = cameraComponent.getProjectionViewMatrix();
+			cullChunkMeshes(projectionViewMatrix, registry.get<TransformComponent>(camera).getTranslation());
 			std::memcpy(reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(uniformBufferMemory) + Utils::alignCeil(128, m_Device.getPhysicalDeviceLimits().minUniformBufferOffsetAlignment) * m_CurrentFrame), &projectionViewMatrix, sizeof(projectionViewMatrix));
 
 			currentCommandBuffer.cmdBeginRenderPass(m_RenderPass, m_Framebuffers[m_CurrentImage], { { 0, 0 }, { m_Swapchain.m_Width, m_Swapchain.m_Height } }, { vk::ClearColorValue(std::array<float, 4> { 0.1f, 0.1f, 0.1f, 1.0f }), vk::ClearDepthStencilValue(1.0f, 0) });
@@ -182,7 +204,7 @@ void RasterRenderer::renderImpl()
 				auto [transformComponent, meshComponent] = meshes.get<TransformComponent, StaticMeshComponent>(mesh);
 
 				Mesh* pMesh = meshComponent.m_Mesh;
-				if (!pMesh)
+				if (!pMesh || !meshComponent.m_Visible)
 					continue;
 
 				auto& transformationMatrix = transformComponent.getMatrix();
@@ -205,4 +227,138 @@ void RasterRenderer::renderImpl()
 	}
 
 	m_UniformBuffer.unmapMemory();
-}
\ No newline at end of file
+}
+
+void RasterRenderer::updateChunkMeshes()
+{
+	if (!m_Dimension)
+		return;
+
+	glm::fvec3 focus = m_CameraTransform->getTranslation();
+	m_ChunkMeshScheduler.setFocus(focus);
+
+	// Chunks close to the camera are drawn as they are, further out the LOD nodes of the dimension take over.
+	auto& lod = m_Dimension->getLod();
+	lod.select(focus, m_LodNodes);
+	lod.update(*m_Dimension, m_LodNodes);
+	std::unordered_set<LodCoord, LodCoordHash> selected(m_LodNodes.begin(), m_LodNodes.end());
+
+	// Drop meshes of nodes that are no longer drawn and of chunks that got unloaded.
+	for (auto itr = m_ChunkMeshes.begin(); itr != m_ChunkMeshes.end();)
+	{
+		auto current = itr++;
+		if (!selected.contains(current->first) || !lod.getNode(*m_Dimension, current->first))
+			removeChunkMesh(current->first);
+	}
+
+	for (auto& coord : m_LodNodes)
+	{
+		const Chunk* node = lod.getNode(*m_Dimension, coord);
+		if (!node)
+			continue;
+
+		// Faces towards a node of another level keep their border faces, those hang over the cracks between levels as skirts.
+		std::array<const Chunk*, FaceCount> neighbours {};
+		std::uint8_t                        skirts = 0;
+		for (std::uint32_t i = 0; i < FaceCount; ++i)
+		{
+			LodCoord neighbour = coord.neighbour(static_cast<EFace>(i));
+			if (selected.contains(neighbour))
+				neighbours[i] = lod.getNode(*m_Dimension, neighbour);
+			else
+				skirts |= static_cast<std::uint8_t>(1U << i);
+		}
+
+		auto& chunkMesh = m_ChunkMeshes[coord];
+		if (chunkMesh.m_QueuedRevision != node->getRevision() || chunkMesh.m_QueuedSkirts != skirts)
+		{
+			// Chunks that were not meshed yet could connect anything.
+			if (coord.m_Level == 0 && chunkMesh.m_QueuedRevision == ~0ULL)
+				m_ChunkVisibility.setChunk(coord.m_Coord, ChunkVisibility::All());
+
+			chunkMesh.m_QueuedRevision = node->getRevision();
+			chunkMesh.m_QueuedSkirts   = skirts;
+			m_ChunkMeshScheduler.enqueue(coord, *node, neighbours);
+		}
+	}
+
+	// Render ends every frame by waiting for the queue to go idle, so replacing mesh buffers here is safe.
+	m_ChunkMeshScheduler.drainResults([this](ChunkMeshResult&& result) { uploadChunkMesh(std::move(result)); }, m_MaxChunkMeshUploadsPerFrame);
+}
+
+void RasterRenderer::uploadChunkMesh(ChunkMeshResult&& result)
+{
+	auto itr = m_ChunkMeshes.find(result.m_Coord);
+	if (itr == m_ChunkMeshes.end())
+		return;
+
+	if (result.m_Coord.m_Level == 0)
+		m_ChunkVisibility.setChunk(result.m_Coord.m_Coord, result.m_Visibility);
+
+	auto& registry  = ECS::Get().getRegistry();
+	auto& chunkMesh = itr->second;
+	if (result.m_Indices.empty())
+	{
+		if (chunkMesh.m_Entity != entt::null)
+			registry.destroy(chunkMesh.m_Entity);
+		chunkMesh.m_Entity = entt::null;
+		chunkMesh.m_Mesh.reset();
+		return;
+	}
+
+	if (!chunkMesh.m_Mesh)
+		chunkMesh.m_Mesh = std::make_unique<Mesh>(m_Vma);
+	chunkMesh.m_Mesh->m_Vertices = std::move(result.m_Vertices);
+	chunkMesh.m_Mesh->m_Indices  = std::move(result.m_Indices);
+	chunkMesh.m_Mesh->updateMeshData();
+
+	if (chunkMesh.m_Entity == entt::null)
+	{
+		// LOD nodes are meshed in cells, scale them up to voxels.
+		float      scale   = static_cast<float>(result.m_Coord.getSize());
+		float      size    = scale * Chunk::Size;
+		glm::fvec3 origin  = { result.m_Coord.m_Coord.m_X * size, result.m_Coord.m_Coord.m_Y * size, result.m_Coord.m_Coord.m_Z * size };
+		chunkMesh.m_Entity = m_Scene.instantiate(origin, { 0.0f, 0.0f, 0.0f, 1.0f }, { scale, scale, scale });
+		registry.emplace<StaticMeshComponent>(chunkMesh.m_Entity, chunkMesh.m_Mesh.get());
+	}
+}
+
+void RasterRenderer::removeChunkMesh(const LodCoord& coord)
+{
+	auto itr = m_ChunkMeshes.find(coord);
+	if (itr == m_ChunkMeshes.end())
+		return;
+
+	m_ChunkMeshScheduler.cancel(coord);
+	if (coord.m_Level == 0)
+		m_ChunkVisibility.removeChunk(coord.m_Coord);
+	if (itr->second.m_Entity != entt::null)
+		ECS::Get().getRegistry().destroy(itr->second.m_Entity);
+	m_ChunkMeshes.erase(itr);
+}
+
+void RasterRenderer::cullChunkMeshes(const glm::fmat4& projectionView, const glm::fvec3& camera)
+{
+	m_ChunkVisibility.update(projectionView, camera);
+
+	auto& registry = ECS::Get().getRegistry();
+	for (auto& [coord, chunkMesh] : m_ChunkMeshes)
+	{
+		if (chunkMesh.m_Entity == entt::null)
+			continue;
+
+		bool visible;
+		if (coord.m_Level == 0)
+		{
+			visible = m_ChunkVisibility.isVisible(coord.m_Coord);
+		}
+		else
+		{
+			// LOD nodes lie beyond the chunks, the walk has to get out of those for them to be seen.
+			float      size = static_cast<float>(coord.getSize() * Chunk::Size);
+			glm::fvec3 min  = { coord.m_Coord.m_X * size, coord.m_Coord.m_Y * size, coord.m_Coord.m_Z * size };
+			visible         = m_ChunkVisibility.hasEscaped() && m_ChunkVisibility.isInFrustum(min, { min.x + size, min.y + size, min.z + size });
+		}
+		registry.get<StaticMeshComponent>(chunkMesh.m_Entity).m_Visible = visible;
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Carbonite/Scene/Scene.h"
+#include "Carbonite/World/ChunkCoord.h"
 #include "Graphics/Memory/Buffer.h"
 #include "Graphics/Pipeline/Descriptor/DescriptorPool.h"
 #include "Graphics/Pipeline/Descriptor/DescriptorSet.h"
@@ -8,20 +9,48 @@
 #include "Graphics/Pipeline/GraphicsPipeline.h"
 #include "Graphics/Pipeline/PipelineLayout.h"
 #include "Graphics/Pipeline/ShaderModule.h"
+#include "Mesh/ChunkMeshScheduler.h"
+#include "Mesh/ChunkVisibility.h"
 #include "Mesh/Mesh.h"
 #include "Renderer.h"
 #include "Shader/Shader.h"
 
+#include <cstdint>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Dimension;
+
 class RasterRenderer : public Renderer
 {
 public:
 	RasterRenderer();
 
+	void setDimension(Dimension* dimension);
+
 private:
 	virtual void initImpl() override;
 	virtual void deinitImpl() override;
 	virtual void renderImpl() override;
 
+	void updateChunkMeshes();
+	void uploadChunkMesh(ChunkMeshResult&& result);
+	void removeChunkMesh(const LodCoord& coord);
+	// Hides chunk meshes outside the frustum and chunks hidden behind opaque chunks.
+	void cullChunkMeshes(const glm::fmat4& projectionView, const glm::fvec3& camera);
+
+private:
+	struct ChunkRenderMesh
+	{
+	public:
+		std::unique_ptr<Mesh> m_Mesh;
+		entt::entity          m_Entity         = entt::null;
+		std::uint64_t         m_QueuedRevision = ~0ULL;
+		std::uint8_t          m_QueuedSkirts   = 0; // Faces meshed without their neighbour, bit per EFace
+	};
+
 public:
 	// Test pipeline
 	Shader                               m_VertexShader;
@@ -36,4 +65,11 @@ public:
 	Scene               m_Scene;
 	TransformComponent* m_CameraTransform;
 	Mesh                m_Mesh;
+
+	Dimension*                                                  m_Dimension = nullptr;
+	ChunkMeshScheduler                                          m_ChunkMeshScheduler;
+	std::unordered_map<LodCoord, ChunkRenderMesh, LodCoordHash> m_ChunkMeshes;
+	std::vector<LodCoord>                                       m_LodNodes;
+	ChunkVisibilityGraph                                        m_ChunkVisibility;
+	std::size_t                                                 m_MaxChunkMeshUploadsPerFrame = 16;
 };
\ No newline at end of file
@@ -14,5 +14,6 @@ public:
 	StaticMeshComponent& operator=(StaticMeshComponent&&) noexcept = default;
 
 public:
-	Mesh* m_Mesh = nullptr;
+	Mesh* m_Mesh    = nullptr;
+	bool  m_Visible = true; // Meshes culled by the renderer record no commands
 };
\ No newline at end of file
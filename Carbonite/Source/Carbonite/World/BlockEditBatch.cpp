@@ -0,0 +1,185 @@
+#include "BlockEditBatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+std::uint64_t ChunkEditResult::FaceSections(EFace face)
+{
+	constexpr std::uint32_t SectionsPerAxis = Chunk::Size / SectionSize;
+
+	std::uint32_t axis  = getFaceAxis(face);
+	std::uint32_t slice = isPositiveFace(face) ? SectionsPerAxis - 1 : 0;
+	std::uint64_t mask  = 0;
+	for (std::uint32_t z = 0; z < SectionsPerAxis; ++z)
+	{
+		for (std::uint32_t y = 0; y < SectionsPerAxis; ++y)
+		{
+			for (std::uint32_t x = 0; x < SectionsPerAxis; ++x)
+			{
+				std::uint32_t position[3] { x, y, z };
+				if (position[axis] == slice)
+					mask |= 1ULL << SectionIndex(x * SectionSize, y * SectionSize, z * SectionSize);
+			}
+		}
+	}
+	return mask;
+}
+
+void BlockEditBatch::Apply(Chunk& chunk, const std::vector<BlockEdit>& edits, ChunkEditResult& result)
+{
+	auto& voxels  = chunk.getVoxels();
+	bool  written = false;
+	bool  shapes  = false;
+	for (auto& edit : edits)
+	{
+		if (!edit.m_Sphere && edit.isSingleVoxel())
+		{
+			std::size_t   index    = Chunk::PositionToIndex(edit.m_Min[0], edit.m_Min[1], edit.m_Min[2]);
+			std::uint64_t oldState = voxels.get(index);
+			if (oldState == edit.m_State)
+				continue;
+
+			if (!result.m_Bulk && result.m_Changes.size() < MaxTrackedChanges)
+			{
+				result.m_Changes.emplace_back(static_cast<std::uint16_t>(index), oldState);
+			}
+			else
+			{
+				result.m_Bulk = true;
+				result.m_Changes.clear();
+			}
+			voxels.set(index, edit.m_State);
+			result.m_DirtySections |= 1ULL << ChunkEditResult::SectionIndex(edit.m_Min[0], edit.m_Min[1], edit.m_Min[2]);
+			++result.m_Written;
+			written = true;
+			continue;
+		}
+
+		result.m_Bulk = true;
+		result.m_Changes.clear();
+		if (voxels.isUniform() && voxels.get(0) == edit.m_State)
+			continue;
+
+		constexpr std::uint8_t Last = Chunk::Size - 1;
+		if (!edit.m_Sphere && edit.m_Min[0] == 0 && edit.m_Min[1] == 0 && edit.m_Min[2] == 0 && edit.m_Max[0] == Last && edit.m_Max[1] == Last && edit.m_Max[2] == Last)
+		{
+			voxels.fill(edit.m_State);
+			result.m_DirtySections = ~0ULL;
+			result.m_Written += ChunkStorage::VoxelCount;
+			written = true;
+			continue;
+		}
+
+		shapes = true;
+		for (std::uint32_t z = edit.m_Min[2]; z <= edit.m_Max[2]; ++z)
+		{
+			for (std::uint32_t y = edit.m_Min[1]; y <= edit.m_Max[1]; ++y)
+			{
+				std::int64_t first = edit.m_Min[0];
+				std::int64_t last  = edit.m_Max[0];
+				if (edit.m_Sphere)
+				{
+					// Span of voxel centres inside the sphere on this row.
+					float dy        = y + 0.5f - edit.m_Center[1];
+					float dz        = z + 0.5f - edit.m_Center[2];
+					float remaining = edit.m_RadiusSquared - dy * dy - dz * dz;
+					if (remaining < 0.0f)
+						continue;
+					float half = std::sqrt(remaining);
+					first      = std::max<std::int64_t>(first, static_cast<std::int64_t>(std::ceil(edit.m_Center[0] - half - 0.5f)));
+					last       = std::min<std::int64_t>(last, static_cast<std::int64_t>(std::floor(edit.m_Center[0] + half - 0.5f)));
+					if (first > last)
+						continue;
+				}
+
+				std::size_t count = static_cast<std::size_t>(last - first + 1);
+				voxels.fillRun(Chunk::PositionToIndex(static_cast<std::uint32_t>(first), y, z), count, edit.m_State);
+				for (std::int64_t x = first & ~7LL; x <= last; x += ChunkEditResult::SectionSize)
+					result.m_DirtySections |= 1ULL << ChunkEditResult::SectionIndex(static_cast<std::uint32_t>(x), y, z);
+				result.m_Written += count;
+				written = true;
+			}
+		}
+	}
+
+	if (!written)
+		return;
+
+	// Overwritten states stay in the palette until compacted.
+	if (shapes)
+		voxels.compact();
+	chunk.markDirty();
+	chunk.markUnsaved();
+}
+
+void BlockEditBatch::set(std::int64_t x, std::int64_t y, std::int64_t z, std::uint64_t state)
+{
+	BlockEdit    edit { state };
+	std::int64_t position[3] { x, y, z };
+	addShape(position, position, edit, nullptr);
+}
+
+void BlockEditBatch::fillBox(std::int64_t minX, std::int64_t minY, std::int64_t minZ, std::int64_t maxX, std::int64_t maxY, std::int64_t maxZ, std::uint64_t state)
+{
+	if (minX > maxX || minY > maxY || minZ > maxZ)
+		return;
+
+	BlockEdit    edit { state };
+	std::int64_t min[3] { minX, minY, minZ };
+	std::int64_t max[3] { maxX, maxY, maxZ };
+	addShape(min, max, edit, nullptr);
+}
+
+void BlockEditBatch::fillSphere(double x, double y, double z, double radius, std::uint64_t state)
+{
+	if (radius < 0.0)
+		return;
+
+	BlockEdit edit { state };
+	edit.m_Sphere        = true;
+	edit.m_RadiusSquared = static_cast<float>(radius * radius);
+
+	double       center[3] { x, y, z };
+	std::int64_t min[3];
+	std::int64_t max[3];
+	for (std::uint32_t a = 0; a < 3; ++a)
+	{
+		min[a] = static_cast<std::int64_t>(std::ceil(center[a] - radius - 0.5));
+		max[a] = static_cast<std::int64_t>(std::floor(center[a] + radius - 0.5));
+		if (min[a] > max[a])
+			return;
+	}
+	addShape(min, max, edit, center);
+}
+
+void BlockEditBatch::clear()
+{
+	m_Chunks.clear();
+	m_EditCount = 0;
+}
+
+void BlockEditBatch::addShape(const std::int64_t (&min)[3], const std::int64_t (&max)[3], const BlockEdit& edit, const double* center)
+{
+	constexpr std::int64_t Size = static_cast<std::int64_t>(Chunk::Size);
+
+	++m_EditCount;
+	for (std::int64_t cz = min[2] >> 5; cz <= max[2] >> 5; ++cz)
+	{
+		for (std::int64_t cy = min[1] >> 5; cy <= max[1] >> 5; ++cy)
+		{
+			for (std::int64_t cx = min[0] >> 5; cx <= max[0] >> 5; ++cx)
+			{
+				std::int64_t base[3] { cx * Size, cy * Size, cz * Size };
+				BlockEdit    clipped = edit;
+				for (std::uint32_t a = 0; a < 3; ++a)
+				{
+					clipped.m_Min[a] = static_cast<std::uint8_t>(std::max(min[a], base[a]) - base[a]);
+					clipped.m_Max[a] = static_cast<std::uint8_t>(std::min(max[a], base[a] + Size - 1) - base[a]);
+					if (center)
+						clipped.m_Center[a] = static_cast<float>(center[a] - static_cast<double>(base[a]));
+				}
+				m_Chunks[{ cx, cy, cz }].push_back(clipped);
+			}
+		}
+	}
+}
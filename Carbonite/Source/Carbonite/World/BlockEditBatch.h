@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Chunk.h"
+#include "ChunkCoord.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <unordered_map>
+#include <vector>
+
+// One edit clipped to a single chunk, bounds are inclusive chunk local voxel positions.
+struct BlockEdit
+{
+public:
+	std::uint64_t m_State = Chunk::EmptyState;
+	std::uint8_t  m_Min[3] {};
+	std::uint8_t  m_Max[3] {};
+	bool          m_Sphere = false;
+	float         m_Center[3] {}; // Chunk local, voxel centres within m_RadiusSquared of it are set
+	float         m_RadiusSquared = 0.0f;
+
+	bool isSingleVoxel() const { return m_Min[0] == m_Max[0] && m_Min[1] == m_Max[1] && m_Min[2] == m_Max[2]; }
+};
+
+// Section bits of chunk voxels touched by edits, a section is 8x8x8 voxels and bit x + y * 4 + z * 16 covers section (x, y, z).
+struct ChunkEditResult
+{
+public:
+	static constexpr std::uint32_t SectionSize = 8;
+
+	static std::uint32_t SectionIndex(std::uint32_t x, std::uint32_t y, std::uint32_t z) { return x / SectionSize + (y / SectionSize) * 4 + (z / SectionSize) * 16; }
+	// Sections touching the given face of the chunk.
+	static std::uint64_t FaceSections(EFace face);
+
+public:
+	std::uint64_t m_DirtySections = 0;
+	std::size_t   m_Written       = 0; // Voxels written, shapes may count voxels that already had the state
+	// Old state of every changed voxel as long as the chunk only saw a few single voxel edits, empty otherwise.
+	std::vector<std::pair<std::uint16_t, std::uint64_t>> m_Changes;
+	bool                                                 m_Bulk = false;
+};
+
+struct BlockEditResult
+{
+public:
+	std::size_t m_Chunks        = 0; // Loaded chunks that were edited
+	std::size_t m_SkippedChunks = 0; // Chunks with edits that were not loaded
+	std::size_t m_Written       = 0;
+};
+
+// Collects block edits in world coordinates and groups them by chunk, Dimension::applyEdits() applies a whole batch with a single
+// pass over every chunk: shapes are written as runs of rows, a box covering a whole chunk fills it, chunks are compacted,
+// bump their revision and queue their lighting once.
+// Edits to the same chunk are applied in the order they were added.
+class BlockEditBatch
+{
+public:
+	// Chunks with more single voxel changes than this are relit by 8x8x8 section instead of voxel by voxel.
+	static constexpr std::size_t MaxTrackedChanges = 64;
+
+	// Applies edits to chunk in order.
+	static void Apply(Chunk& chunk, const std::vector<BlockEdit>& edits, ChunkEditResult& result);
+
+public:
+	void set(std::int64_t x, std::int64_t y, std::int64_t z, std::uint64_t state);
+	// Every voxel in the inclusive box [min, max].
+	void fillBox(std::int64_t minX, std::int64_t minY, std::int64_t minZ, std::int64_t maxX, std::int64_t maxY, std::int64_t maxZ, std::uint64_t state);
+	// Every voxel whose centre is within radius of (x, y, z).
+	void fillSphere(double x, double y, double z, double radius, std::uint64_t state);
+
+	void clear();
+
+	bool empty() const { return m_Chunks.empty(); }
+	auto getChunkCount() const { return m_Chunks.size(); }
+	auto getEditCount() const { return m_EditCount; }
+
+	template <class F>
+	void forEachChunk(F&& func) const
+	{
+		for (auto& [coord, edits] : m_Chunks)
+			func(coord, edits);
+	}
+
+private:
+	void addShape(const std::int64_t (&min)[3], const std::int64_t (&max)[3], const BlockEdit& edit, const double* center);
+
+private:
+	std::unordered_map<ChunkCoord, std::vector<BlockEdit>, ChunkCoordHash> m_Chunks;
+	std::size_t                                                            m_EditCount = 0;
+};
@@ -0,0 +1,291 @@
+#include "BlockTicker.h"
+#include "Dimension.h"
+
+#include <bit>
+#include <chrono>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	std::uint64_t SplitMix(std::uint64_t value)
+	{
+		value += 0x9E37'79B9'7F4A'7C15ULL;
+		value = (value ^ (value >> 30)) * 0xBF58'476D'1CE4'E5B9ULL;
+		value = (value ^ (value >> 27)) * 0x94D0'49BB'1331'11EBULL;
+		return value ^ (value >> 31);
+	}
+
+	std::uint32_t XorShift(std::uint32_t& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	// The top 15 bits of a step, the low bits of xorshift are the weakest.
+	constexpr std::uint32_t IndexShift = 32 - 15;
+	static_assert((1ULL << (32 - IndexShift)) == ChunkStorage::VoxelCount, "Sampled indices must cover exactly one chunk");
+
+	BlockTick MakeTick(const Chunk& chunk, std::size_t index, bool scheduled)
+	{
+		ChunkCoord   coord = chunk.getCoord();
+		std::int64_t size  = static_cast<std::int64_t>(Chunk::Size);
+		BlockTick    tick;
+		tick.m_X         = coord.m_X * size + static_cast<std::int64_t>(index % Chunk::Size);
+		tick.m_Y         = coord.m_Y * size + static_cast<std::int64_t>((index / Chunk::Size) % Chunk::Size);
+		tick.m_Z         = coord.m_Z * size + static_cast<std::int64_t>(index / (Chunk::Size * Chunk::Size));
+		tick.m_State     = chunk.getVoxels().get(index);
+		tick.m_Scheduled = scheduled;
+		return tick;
+	}
+} // namespace
+
+void RandomTickSampler::reseed(std::uint64_t seed)
+{
+	// xorshift never leaves a zero state.
+	for (std::size_t i = 0; i < Lanes; ++i)
+		m_State[i] = static_cast<std::uint32_t>(SplitMix(seed + i)) | 1;
+}
+
+void RandomTickSampler::sample(std::uint16_t* out, std::size_t count)
+{
+	std::size_t i = 0;
+#if defined(__AVX2__)
+	__m256i state = _mm256_load_si256(reinterpret_cast<const __m256i*>(m_State.data()));
+	for (; i + Lanes <= count; i += Lanes)
+	{
+		state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+		state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+		state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+
+		// Indices fit into 15 bits, so the signed pack does not saturate. It packs within 128 bit halves, the permute joins them.
+		__m256i indices = _mm256_srli_epi32(state, IndexShift);
+		__m256i packed  = _mm256_permute4x64_epi64(_mm256_packs_epi32(indices, indices), 0b1000);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_castsi256_si128(packed));
+	}
+	_mm256_store_si256(reinterpret_cast<__m256i*>(m_State.data()), state);
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+	__m128i low  = _mm_load_si128(reinterpret_cast<const __m128i*>(m_State.data()));
+	__m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(m_State.data() + 4));
+	for (; i + Lanes <= count; i += Lanes)
+	{
+		low  = _mm_xor_si128(low, _mm_slli_epi32(low, 13));
+		high = _mm_xor_si128(high, _mm_slli_epi32(high, 13));
+		low  = _mm_xor_si128(low, _mm_srli_epi32(low, 17));
+		high = _mm_xor_si128(high, _mm_srli_epi32(high, 17));
+		low  = _mm_xor_si128(low, _mm_slli_epi32(low, 5));
+		high = _mm_xor_si128(high, _mm_slli_epi32(high, 5));
+
+		__m128i packed = _mm_packs_epi32(_mm_srli_epi32(low, IndexShift), _mm_srli_epi32(high, IndexShift));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+	}
+	_mm_store_si128(reinterpret_cast<__m128i*>(m_State.data()), low);
+	_mm_store_si128(reinterpret_cast<__m128i*>(m_State.data() + 4), high);
+#endif
+
+	for (; i + Lanes <= count; i += Lanes)
+		for (std::size_t lane = 0; lane < Lanes; ++lane)
+			out[i + lane] = static_cast<std::uint16_t>(XorShift(m_State[lane]) >> IndexShift);
+	if (i < count)
+	{
+		std::uint16_t tail[Lanes];
+		for (std::size_t lane = 0; lane < Lanes; ++lane)
+			tail[lane] = static_cast<std::uint16_t>(XorShift(m_State[lane]) >> IndexShift);
+		for (std::size_t lane = 0; i < count; ++i, ++lane)
+			out[i] = tail[lane];
+	}
+}
+
+std::uint64_t BlockTickContext::getVoxel(std::int64_t x, std::int64_t y, std::int64_t z) const
+{
+	return m_Dimension->getVoxel(x, y, z);
+}
+
+void BlockTickContext::scheduleTick(std::int64_t x, std::int64_t y, std::int64_t z, std::uint64_t delay)
+{
+	std::size_t index = Chunk::PositionToIndex(static_cast<std::uint32_t>(x & 31), static_cast<std::uint32_t>(y & 31), static_cast<std::uint32_t>(z & 31));
+	m_Requests.push_back({ { x >> 5, y >> 5, z >> 5 }, static_cast<std::uint16_t>(index), delay });
+}
+
+std::uint32_t BlockTickContext::random()
+{
+	return XorShift(m_Random);
+}
+
+BlockTicker::BlockTicker(WorkerPool& workers)
+    : m_Workers(workers)
+{
+}
+
+void BlockTicker::setBlockStates(const BlockStateTable* blockStates)
+{
+	m_BlockStates = blockStates;
+	for (auto& [coord, ticks] : m_Chunks)
+		ticks.m_Revision = ~0ULL;
+}
+
+void BlockTicker::scheduleTick(std::int64_t x, std::int64_t y, std::int64_t z, std::uint64_t delay)
+{
+	std::size_t index = Chunk::PositionToIndex(static_cast<std::uint32_t>(x & 31), static_cast<std::uint32_t>(y & 31), static_cast<std::uint32_t>(z & 31));
+	m_Wheel.schedule({ x >> 5, y >> 5, z >> 5 }, static_cast<std::uint16_t>(index), delay);
+}
+
+std::size_t BlockTicker::tick(Dimension& dimension)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	m_DueTicks.clear();
+	m_Wheel.advance(m_DueTicks);
+	std::uint64_t tick = m_Wheel.getTick();
+
+	m_Stats        = {};
+	m_Stats.m_Tick = tick;
+	dimension.forEachChunk([this](const Chunk& chunk) { m_Chunks[chunk.getCoord()].m_Chunk = &chunk; });
+
+	for (auto& due : m_DueTicks)
+	{
+		auto itr = m_Chunks.find(due.m_Chunk);
+		if (itr != m_Chunks.end())
+			itr->second.m_Due.push_back(due.m_Index);
+		else
+			++m_Stats.m_DroppedTicks;
+	}
+
+	// Chunks that did not change since their set was built and have neither tickable voxels nor due ticks are skipped.
+	for (auto& phase : m_Phases)
+		phase.clear();
+	for (auto& [coord, ticks] : m_Chunks)
+	{
+		if (ticks.m_Revision == ticks.m_Chunk->getRevision() && ticks.m_TickableCount == 0 && ticks.m_Due.empty())
+			continue;
+
+		// Seeded from the chunk and the tick only, so results do not depend on the worker a chunk ends up on.
+		ticks.m_Seed                = SplitMix(m_Seed ^ coord.morton() ^ (tick * 0xD6E8'FEB8'6659'FD93ULL));
+		ticks.m_Context.m_Dimension = &dimension;
+		ticks.m_Context.m_Coord     = coord;
+		ticks.m_Context.m_Tick      = tick;
+		ticks.m_Context.m_Random    = static_cast<std::uint32_t>(ticks.m_Seed >> 32) | 1;
+		m_Phases[GetPhase(coord)].push_back(&ticks);
+	}
+
+	std::size_t calls = 0;
+	for (auto& phase : m_Phases)
+	{
+		if (phase.empty())
+			continue;
+
+		m_Workers.parallelFor(phase.size(), [this, &phase](std::size_t i) { process(*phase[i]); });
+
+		// Edits are applied in chunk order of the phase, before the next phase looks at the world.
+		for (ChunkTicks* ticks : phase)
+		{
+			BlockTickContext& context = ticks->m_Context;
+			if (!context.m_Edits.empty())
+			{
+				m_Stats.m_Edits += context.m_Edits.getEditCount();
+				dimension.applyEdits(context.m_Edits);
+				context.m_Edits.clear();
+			}
+			for (auto& request : context.m_Requests)
+				m_Wheel.schedule(request.m_Chunk, request.m_Index, request.m_Delay);
+			context.m_Requests.clear();
+
+			calls += ticks->m_Calls;
+			m_Stats.m_RandomTicks += ticks->m_RandomTicks;
+			m_Stats.m_Rebuilt += ticks->m_Rebuilt ? 1 : 0;
+		}
+		m_Stats.m_Chunks += phase.size();
+	}
+	m_Stats.m_ScheduledTicks = m_DueTicks.size() - m_Stats.m_DroppedTicks;
+
+	m_Stats.m_TickMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return calls;
+}
+
+std::size_t BlockTicker::getTickableCount(const ChunkCoord& coord) const
+{
+	auto itr = m_Chunks.find(coord);
+	return itr != m_Chunks.end() ? itr->second.m_TickableCount : 0;
+}
+
+void BlockTicker::rebuild(ChunkTicks& ticks)
+{
+	const Chunk& chunk  = *ticks.m_Chunk;
+	auto&        voxels = chunk.getVoxels();
+	ticks.m_Revision      = chunk.getRevision();
+	ticks.m_TickableCount = 0;
+	ticks.m_Rebuilt       = true;
+
+	// Most chunks hold no random ticking state at all, which the palette tells without looking at a voxel.
+	auto& palette = voxels.getPalette();
+	bool  any     = false;
+	ticks.m_PaletteTicks.resize(palette.size());
+	for (std::size_t i = 0; i < palette.size(); ++i)
+	{
+		ticks.m_PaletteTicks[i] = m_BlockStates->isRandomTicking(palette[i]);
+		any |= ticks.m_PaletteTicks[i] != 0;
+	}
+	if (!any)
+	{
+		ticks.m_Tickable.clear();
+		return;
+	}
+
+	ticks.m_Tickable.assign(ChunkStorage::VoxelCount / 64, voxels.isUniform() ? ~0ULL : 0);
+	if (voxels.isUniform())
+	{
+		ticks.m_TickableCount = ChunkStorage::VoxelCount;
+		return;
+	}
+
+	std::uint32_t bits           = voxels.getBitsPerIndex();
+	std::uint32_t indicesPerWord = 64 / bits;
+	std::uint64_t mask           = (1ULL << bits) - 1;
+	std::size_t   index          = 0;
+	for (std::uint64_t word : voxels.getWords())
+	{
+		for (std::uint32_t i = 0; i < indicesPerWord; ++i, ++index, word >>= bits)
+			ticks.m_Tickable[index / 64] |= static_cast<std::uint64_t>(ticks.m_PaletteTicks[static_cast<std::size_t>(word & mask)]) << (index % 64);
+	}
+	for (std::uint64_t word : ticks.m_Tickable)
+		ticks.m_TickableCount += static_cast<std::size_t>(std::popcount(word));
+}
+
+void BlockTicker::process(ChunkTicks& ticks)
+{
+	ticks.m_Calls       = 0;
+	ticks.m_RandomTicks = 0;
+	ticks.m_Rebuilt     = false;
+	if (ticks.m_Revision != ticks.m_Chunk->getRevision())
+		rebuild(ticks);
+
+	const Chunk&      chunk   = *ticks.m_Chunk;
+	BlockTickContext& context = ticks.m_Context;
+
+	if (ticks.m_TickableCount > 0 && m_RandomHandler && m_RandomTickSpeed > 0)
+	{
+		RandomTickSampler sampler(ticks.m_Seed);
+		ticks.m_Samples.resize(m_RandomTickSpeed);
+		sampler.sample(ticks.m_Samples.data(), ticks.m_Samples.size());
+		for (std::uint16_t index : ticks.m_Samples)
+		{
+			if (!((ticks.m_Tickable[index / 64] >> (index % 64)) & 1))
+				continue;
+			m_RandomHandler(context, MakeTick(chunk, index, false));
+			++ticks.m_RandomTicks;
+		}
+		ticks.m_Calls += ticks.m_RandomTicks;
+	}
+
+	if (m_ScheduledHandler)
+	{
+		for (std::uint16_t index : ticks.m_Due)
+			m_ScheduledHandler(context, MakeTick(chunk, index, true));
+		ticks.m_Calls += ticks.m_Due.size();
+	}
+	ticks.m_Due.clear();
+}
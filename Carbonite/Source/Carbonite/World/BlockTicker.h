@@ -0,0 +1,178 @@
+#pragma once
+
+#include "BlockEditBatch.h"
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Chunk.h"
+#include "ChunkCoord.h"
+#include "TickWheel.h"
+#include "Utils/WorkerPool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class Dimension;
+
+struct BlockTickStats
+{
+public:
+	std::uint64_t m_Tick             = 0;
+	std::size_t   m_Chunks           = 0; // Chunks with tickable voxels or due ticks in the last tick
+	std::size_t   m_RandomTicks      = 0; // Random samples that hit a tickable voxel
+	std::size_t   m_ScheduledTicks   = 0;
+	std::size_t   m_DroppedTicks     = 0; // Scheduled ticks whose chunk was not loaded
+	std::size_t   m_Rebuilt          = 0; // Tickable sets rebuilt because their chunk changed
+	std::size_t   m_Edits            = 0; // Voxels written by the handlers
+	float         m_TickMilliseconds = 0.0f;
+};
+
+// Eight xorshift32 generators advanced side by side, 8 (AVX2) or 4 (SSE2) lanes per instruction.
+// The tail of a request steps the same lanes one at a time, so the indices only depend on the seed.
+class RandomTickSampler
+{
+public:
+	static constexpr std::size_t Lanes = 8;
+
+public:
+	RandomTickSampler(std::uint64_t seed = 0) { reseed(seed); }
+
+	void reseed(std::uint64_t seed);
+	// Fills out with count voxel indices below ChunkStorage::VoxelCount.
+	void sample(std::uint16_t* out, std::size_t count);
+
+private:
+	alignas(32) std::array<std::uint32_t, Lanes> m_State {};
+};
+
+struct BlockTick
+{
+public:
+	std::int64_t  m_X, m_Y, m_Z;
+	std::uint64_t m_State;
+	bool          m_Scheduled; // Requested through scheduleTick() instead of picked at random
+};
+
+// What a tick handler may do. Reads see the world as it was when the phase started, writes and new scheduled ticks are
+// collected and applied once every chunk of the phase ticked.
+class BlockTickContext
+{
+public:
+	std::uint64_t getVoxel(std::int64_t x, std::int64_t y, std::int64_t z) const;
+	void          setVoxel(std::int64_t x, std::int64_t y, std::int64_t z, std::uint64_t state) { m_Edits.set(x, y, z, state); }
+	// Ticks the voxel again delay ticks from now, with the scheduled tick handler.
+	void          scheduleTick(std::int64_t x, std::int64_t y, std::int64_t z, std::uint64_t delay);
+
+	// Random numbers seeded from the chunk and the tick, independent of which thread runs the chunk.
+	std::uint32_t random();
+
+	auto& getDimension() const { return *m_Dimension; }
+	auto& getChunkCoord() const { return m_Coord; }
+	auto  getTick() const { return m_Tick; }
+
+private:
+	friend class BlockTicker;
+
+	struct Request
+	{
+	public:
+		ChunkCoord    m_Chunk;
+		std::uint16_t m_Index;
+		std::uint64_t m_Delay;
+	};
+
+	const Dimension*     m_Dimension = nullptr;
+	ChunkCoord           m_Coord;
+	std::uint64_t        m_Tick   = 0;
+	std::uint32_t        m_Random = 1;
+	BlockEditBatch       m_Edits;
+	std::vector<Request> m_Requests;
+};
+
+// Random and scheduled block ticks.
+// Every loaded chunk keeps a bitset of the voxels whose state is random ticking (BlockState::m_RandomTicks), rebuilt from the
+// palette when the chunk's revision changes. Chunks without a ticking state are skipped by looking at the palette only.
+// Every tick picks getRandomTickSpeed() random voxels per chunk, samples that miss the bitset are dropped without touching
+// the voxels. Delayed ticks wait in a TickWheel.
+// Chunks run in parallel in eight phases by the parity of their coordinates, chunks of one phase are never neighbours,
+// not even diagonally, so a chunk always sees the edits its neighbours made in earlier phases and none made concurrently.
+// The chunks of a phase are jobs of the dimension's WorkerPool, tick() blocks until every phase ran.
+class BlockTicker
+{
+public:
+	using TickFunc = std::function<void(BlockTickContext& context, const BlockTick& tick)>;
+
+	static constexpr std::uint32_t PhaseCount = 8;
+
+	static std::uint32_t GetPhase(const ChunkCoord& coord) { return static_cast<std::uint32_t>((coord.m_X & 1) | ((coord.m_Y & 1) << 1) | ((coord.m_Z & 1) << 2)); }
+
+public:
+	BlockTicker(WorkerPool& workers);
+
+	// Which states random tick, must outlive the ticker and not change during tick().
+	// Every tickable set is rebuilt on the next tick.
+	void setBlockStates(const BlockStateTable* blockStates);
+	// Handlers run on worker threads, for chunks of different phases never at the same time.
+	void setRandomTickHandler(TickFunc handler) { m_RandomHandler = std::move(handler); }
+	void setScheduledTickHandler(TickFunc handler) { m_ScheduledHandler = std::move(handler); }
+	// Random samples per chunk and tick, 24 matches 3 per 16^3 voxels.
+	void setRandomTickSpeed(std::uint32_t samplesPerChunk) { m_RandomTickSpeed = samplesPerChunk; }
+	void setSeed(std::uint64_t seed) { m_Seed = seed; }
+
+	void scheduleTick(std::int64_t x, std::int64_t y, std::int64_t z, std::uint64_t delay);
+	// Drops the tickable set of the chunk, its scheduled ticks stay queued.
+	void chunkUnloaded(const ChunkCoord& coord) { m_Chunks.erase(coord); }
+
+	// Runs one tick over the loaded chunks of the dimension, returns the number of handler calls.
+	std::size_t tick(Dimension& dimension);
+
+	// Number of random ticking voxels as of the last tick the chunk had something to do in.
+	std::size_t getTickableCount(const ChunkCoord& coord) const;
+
+	auto  getRandomTickSpeed() const { return m_RandomTickSpeed; }
+	auto  getTick() const { return m_Wheel.getTick(); }
+	auto  getPendingTickCount() const { return m_Wheel.getSize(); }
+	auto  getWorkerCount() const { return m_Workers.getWorkerCount(); }
+	auto& getStats() const { return m_Stats; }
+
+private:
+	struct ChunkTicks
+	{
+	public:
+		const Chunk*               m_Chunk    = nullptr;
+		std::uint64_t              m_Revision = ~0ULL;
+		std::uint64_t              m_Seed     = 0; // Of this tick
+		std::vector<std::uint64_t> m_Tickable; // One bit per voxel, empty without tickable voxels
+		std::size_t                m_TickableCount = 0;
+		std::vector<std::uint16_t> m_Due;
+
+		// Only touched by the thread running the chunk.
+		BlockTickContext           m_Context;
+		std::vector<std::uint8_t>  m_PaletteTicks;
+		std::vector<std::uint16_t> m_Samples;
+		std::size_t                m_Calls       = 0;
+		std::size_t                m_RandomTicks = 0;
+		bool                       m_Rebuilt     = false;
+	};
+
+	void rebuild(ChunkTicks& ticks);
+	void process(ChunkTicks& ticks);
+
+private:
+	WorkerPool& m_Workers;
+
+	std::unordered_map<ChunkCoord, ChunkTicks, ChunkCoordHash> m_Chunks;
+	std::array<std::vector<ChunkTicks*>, PhaseCount>           m_Phases;
+	TickWheel                                                  m_Wheel;
+	std::vector<ScheduledTick>                                 m_DueTicks;
+
+	const BlockStateTable* m_BlockStates = &BlockStateTable::Default();
+	TickFunc               m_RandomHandler;
+	TickFunc               m_ScheduledHandler;
+	std::uint32_t          m_RandomTickSpeed = 24;
+	std::uint64_t          m_Seed            = 0;
+	BlockTickStats         m_Stats;
+};
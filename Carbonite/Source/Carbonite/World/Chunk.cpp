@@ -1,9 +1,7 @@
 #include "Chunk.h"
 
-#include <cstring>
+Chunk::Chunk(std::int64_t chunkX, std::int64_t chunkY, std::int64_t chunkZ)
+    : m_ChunkX(chunkX), m_ChunkY(chunkY), m_ChunkZ(chunkZ), m_Voxels(EmptyState) {}
 
-Chunk::Chunk(std::uint32_t chunkX, std::uint32_t chunkY, std::uint32_t chunkZ)
-    : m_ChunkX(chunkX), m_ChunkY(chunkY), m_ChunkZ(chunkZ)
-{
-	std::memset(m_Voxels, Size * Size * Size, ~0ULL);
-}
\ No newline at end of file
+Chunk::Chunk(const ChunkCoord& coord)
+    : Chunk(coord.m_X, coord.m_Y, coord.m_Z) {}
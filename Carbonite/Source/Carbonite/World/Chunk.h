@@ -1,11 +1,21 @@
 #pragma once
 
+#include "ChunkCoord.h"
+#include "ChunkFluid.h"
+#include "ChunkHeightmap.h"
+#include "ChunkLight.h"
+#include "ChunkOccupancy.h"
+#include "ChunkStorage.h"
+
+#include <cstdint>
+
 #include <stdexcept>
 
 struct Chunk
 {
 public:
-	static constexpr std::size_t Size = 32;
+	static constexpr std::size_t   Size       = 32;
+	static constexpr std::uint64_t EmptyState = ChunkStorage::DefaultState;
 
 	static std::size_t PositionToIndex(std::uint32_t x, std::uint32_t y, std::uint32_t z)
 	{
@@ -13,17 +23,79 @@ public:
 	}
 
 public:
-	Chunk(std::uint32_t chunkX, std::uint32_t chunkY, std::uint32_t chunkZ);
+	Chunk(std::int64_t chunkX, std::int64_t chunkY, std::int64_t chunkZ);
+	Chunk(const ChunkCoord& coord);
 
-	std::uint64_t& operator()(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+	std::uint64_t operator()(std::uint32_t x, std::uint32_t y, std::uint32_t z) const
 	{
 		// TODO(MarcasRealAccount): Add asserts
 		if (x >= Size || y >= Size || z >= Size)
 			throw std::runtime_error("Outside chunk bounds");
-		return m_Voxels[PositionToIndex(x, y, z)];
+		return m_Voxels.get(PositionToIndex(x, y, z));
+	}
+
+	void set(std::uint32_t x, std::uint32_t y, std::uint32_t z, std::uint64_t state)
+	{
+		if (x >= Size || y >= Size || z >= Size)
+			throw std::runtime_error("Outside chunk bounds");
+		m_Voxels.set(PositionToIndex(x, y, z), state);
+		++m_Revision;
+		m_Unsaved = true;
+	}
+
+	void fill(std::uint64_t state)
+	{
+		m_Voxels.fill(state);
+		++m_Revision;
+		m_Unsaved = true;
 	}
 
+	// Bumps the revision so cached data derived from this chunk (meshes etc.) gets rebuilt.
+	// Needed after writing through getVoxels() directly or when a neighbour changed.
+	void markDirty() { ++m_Revision; }
+	auto getRevision() const { return m_Revision; }
+
+	void markUnsaved() { m_Unsaved = true; }
+	void markSaved() { m_Unsaved = false; }
+	bool isUnsaved() const { return m_Unsaved; }
+
+	// Calls func(x, y, z, state) for every voxel in PositionToIndex order.
+	template <class F>
+	void forEach(F&& func) const
+	{
+		m_Voxels.forEach([&func](std::size_t index, std::uint64_t state) {
+			func(static_cast<std::uint32_t>(index % Size), static_cast<std::uint32_t>((index / Size) % Size), static_cast<std::uint32_t>(index / (Size * Size)), state);
+		});
+	}
+
+	ChunkCoord getCoord() const { return { m_ChunkX, m_ChunkY, m_ChunkZ }; }
+
+	auto& getVoxels() { return m_Voxels; }
+	auto& getVoxels() const { return m_Voxels; }
+	auto& getLight() { return m_Light; }
+	auto& getLight() const { return m_Light; }
+	auto& getHeightmap() { return m_Heightmap; }
+	auto& getHeightmap() const { return m_Heightmap; }
+	auto& getOccupancy() { return m_Occupancy; }
+	auto& getOccupancy() const { return m_Occupancy; }
+	auto& getFluid() { return m_Fluid; }
+	auto& getFluid() const { return m_Fluid; }
+
 public:
-	std::uint32_t m_ChunkX, m_ChunkY, m_ChunkZ;
-	std::uint64_t m_Voxels[Size * Size * Size];
+	std::int64_t m_ChunkX, m_ChunkY, m_ChunkZ;
+
+private:
+	ChunkStorage   m_Voxels;
+	ChunkLight     m_Light; // Not persisted, the lighting engine recomputes it on load
+	ChunkHeightmap m_Heightmap;
+	ChunkOccupancy m_Occupancy; // Not persisted, built when collision first needs it
+	ChunkFluid     m_Fluid;
+	std::uint64_t  m_Revision = 0;
+	bool           m_Unsaved  = false;
 };
+
+static_assert(Chunk::Size * Chunk::Size * Chunk::Size == ChunkStorage::VoxelCount, "ChunkStorage must hold exactly one chunk");
+static_assert(Chunk::Size * Chunk::Size * Chunk::Size == ChunkLight::VoxelCount, "ChunkLight must hold exactly one chunk");
+static_assert(Chunk::Size * Chunk::Size * Chunk::Size == ChunkFluid::VoxelCount, "ChunkFluid must hold exactly one chunk");
+static_assert(Chunk::Size == ChunkHeightmap::Size, "ChunkHeightmap must cover exactly one chunk");
+static_assert(Chunk::Size == ChunkOccupancy::Size, "ChunkOccupancy must cover exactly one chunk");
@@ -0,0 +1,78 @@
+#include "ChunkCache.h"
+#include "Chunk.h"
+#include "ChunkCodec.h"
+
+ChunkCache::ChunkCache(std::size_t maxMemoryUsage)
+    : m_MaxMemoryUsage(maxMemoryUsage) {}
+
+void ChunkCache::store(const Chunk& chunk)
+{
+	erase(chunk.getCoord());
+
+	m_Uses.push_front(chunk.getCoord());
+	Entry& entry    = m_Entries[chunk.getCoord()];
+	entry.m_Unsaved = chunk.isUnsaved();
+	entry.m_Use     = m_Uses.begin();
+	ChunkCodec::encode(chunk.getVoxels(), entry.m_Data);
+	entry.m_VoxelSize = entry.m_Data.size();
+	chunk.getHeightmap().serialize(entry.m_Data);
+	entry.m_HeightmapSize = entry.m_Data.size() - entry.m_VoxelSize;
+	chunk.getFluid().serialize(entry.m_Data);
+	entry.m_Data.shrink_to_fit();
+	m_MemoryUsage += entry.m_Data.size();
+	evict();
+}
+
+bool ChunkCache::restore(Chunk& chunk)
+{
+	auto itr = m_Entries.find(chunk.getCoord());
+	if (itr == m_Entries.end())
+		return false;
+
+	auto& entry    = itr->second;
+	bool  restored = ChunkCodec::decode(entry.m_Data.data(), entry.m_VoxelSize, chunk.getVoxels());
+	if (restored)
+	{
+		std::size_t fluidOffset = entry.m_VoxelSize + entry.m_HeightmapSize;
+		chunk.getHeightmap().deserialize(entry.m_Data.data() + entry.m_VoxelSize, entry.m_HeightmapSize);
+		chunk.getFluid().deserialize(entry.m_Data.data() + fluidOffset, entry.m_Data.size() - fluidOffset);
+	}
+	if (restored && entry.m_Unsaved)
+		chunk.markUnsaved();
+	erase(chunk.getCoord());
+	return restored;
+}
+
+bool ChunkCache::erase(const ChunkCoord& coord)
+{
+	auto itr = m_Entries.find(coord);
+	if (itr == m_Entries.end())
+		return false;
+
+	m_MemoryUsage -= itr->second.m_Data.size();
+	m_Uses.erase(itr->second.m_Use);
+	m_Entries.erase(itr);
+	return true;
+}
+
+void ChunkCache::clear()
+{
+	m_Entries.clear();
+	m_Uses.clear();
+	m_MemoryUsage = 0;
+}
+
+void ChunkCache::setMaxMemoryUsage(std::size_t maxMemoryUsage)
+{
+	m_MaxMemoryUsage = maxMemoryUsage;
+	evict();
+}
+
+void ChunkCache::evict()
+{
+	while (m_MemoryUsage > m_MaxMemoryUsage && !m_Uses.empty())
+	{
+		ChunkCoord oldest = m_Uses.back();
+		erase(oldest);
+	}
+}
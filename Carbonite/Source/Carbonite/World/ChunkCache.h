@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ChunkCoord.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+struct Chunk;
+
+// Keeps recently unloaded chunks in memory encoded with ChunkCodec, so they can come back without disk reads or regeneration.
+// The serialized heightmaps and fluid follow the encoded voxels.
+// Once the encoded size passes the budget the least recently stored chunks are dropped.
+class ChunkCache
+{
+public:
+	ChunkCache(std::size_t maxMemoryUsage = 64ULL << 20);
+
+	void store(const Chunk& chunk);
+	// Decodes the cached copy into chunk and removes it from the cache.
+	bool restore(Chunk& chunk);
+	bool erase(const ChunkCoord& coord);
+	void clear();
+
+	void setMaxMemoryUsage(std::size_t maxMemoryUsage);
+
+	bool contains(const ChunkCoord& coord) const { return m_Entries.contains(coord); }
+	auto getSize() const { return m_Entries.size(); }
+	auto getMemoryUsage() const { return m_MemoryUsage; }
+	auto getMaxMemoryUsage() const { return m_MaxMemoryUsage; }
+
+private:
+	struct Entry
+	{
+	public:
+		std::vector<std::uint8_t>       m_Data;
+		std::size_t                     m_VoxelSize     = 0;
+		std::size_t                     m_HeightmapSize = 0;
+		bool                            m_Unsaved       = false;
+		std::list<ChunkCoord>::iterator m_Use;
+	};
+
+	void evict();
+
+private:
+	std::unordered_map<ChunkCoord, Entry, ChunkCoordHash> m_Entries;
+	std::list<ChunkCoord>                                 m_Uses; // Most recently stored first
+	std::size_t                                           m_MemoryUsage = 0;
+	std::size_t                                           m_MaxMemoryUsage;
+};
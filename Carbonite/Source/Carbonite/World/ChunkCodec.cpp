@@ -0,0 +1,185 @@
+#include "ChunkCodec.h"
+#include "Utils/LZ.h"
+
+#include <cstring>
+
+namespace
+{
+	// Worst case: a full 16 bit palette plus one run per voxel, every varint at its longest.
+	constexpr std::size_t MaxStreamSize = 1 + 3 + ChunkStorage::MaxPalette * 10 + ChunkStorage::VoxelCount * 6;
+
+	struct Run
+	{
+	public:
+		std::uint32_t m_PaletteIndex;
+		std::uint32_t m_Length;
+	};
+
+	void WriteVarint(std::vector<std::uint8_t>& out, std::uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back(static_cast<std::uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<std::uint8_t>(value));
+	}
+
+	bool ReadVarint(const std::uint8_t*& in, const std::uint8_t* end, std::uint64_t& value)
+	{
+		value = 0;
+		for (std::uint32_t shift = 0; shift < 64; shift += 7)
+		{
+			if (in == end)
+				return false;
+			std::uint8_t byte = *in++;
+			value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+
+	void FillRun(ChunkStorage::Words& words, std::uint32_t bits, std::size_t position, std::size_t length, std::uint64_t paletteIndex)
+	{
+		std::size_t   indicesPerWord = 64 / bits;
+		std::size_t   end            = position + length;
+		std::uint64_t pattern        = paletteIndex * (~0ULL / ((1ULL << bits) - 1));
+
+		for (; position < end && position % indicesPerWord != 0; ++position)
+			words[position / indicesPerWord] |= paletteIndex << ((position % indicesPerWord) * bits);
+		for (; position + indicesPerWord <= end; position += indicesPerWord)
+			words[position / indicesPerWord] = pattern;
+		for (; position < end; ++position)
+			words[position / indicesPerWord] |= paletteIndex << ((position % indicesPerWord) * bits);
+	}
+} // namespace
+
+namespace ChunkCodec
+{
+	void encode(const ChunkStorage& storage, std::vector<std::uint8_t>& data)
+	{
+		thread_local std::vector<Run>          runs;
+		thread_local std::vector<std::uint8_t> stream;
+		runs.clear();
+		stream.clear();
+
+		// Whole words holding a single index extend the current run without being unpacked.
+		std::uint32_t bits = storage.getBitsPerIndex();
+		if (bits == 0)
+		{
+			runs.push_back({ 0, static_cast<std::uint32_t>(ChunkStorage::VoxelCount) });
+		}
+		else
+		{
+			std::uint32_t indicesPerWord = 64 / bits;
+			std::uint64_t mask           = (1ULL << bits) - 1;
+			std::uint64_t repeat         = ~0ULL / mask;
+			Run           run { static_cast<std::uint32_t>(storage.getWords()[0] & mask), 0 };
+			for (std::uint64_t word : storage.getWords())
+			{
+				if (word == run.m_PaletteIndex * repeat)
+				{
+					run.m_Length += indicesPerWord;
+					continue;
+				}
+
+				for (std::uint32_t i = 0; i < indicesPerWord; ++i, word >>= bits)
+				{
+					std::uint32_t paletteIndex = static_cast<std::uint32_t>(word & mask);
+					if (paletteIndex == run.m_PaletteIndex)
+					{
+						++run.m_Length;
+						continue;
+					}
+					runs.push_back(run);
+					run = { paletteIndex, 1 };
+				}
+			}
+			runs.push_back(run);
+		}
+
+		// Drop unreferenced palette entries and number the rest by first appearance.
+		auto&                      palette = storage.getPalette();
+		std::vector<std::uint32_t> remap(palette.size(), ~0U);
+		std::vector<std::uint64_t> used;
+		for (auto& current : runs)
+		{
+			std::uint32_t& index = remap[current.m_PaletteIndex];
+			if (index == ~0U)
+			{
+				index = static_cast<std::uint32_t>(used.size());
+				used.push_back(palette[current.m_PaletteIndex]);
+			}
+			current.m_PaletteIndex = index;
+		}
+
+		// States are stored + 1 so the empty state ~0 takes a single byte.
+		WriteVarint(stream, used.size());
+		for (std::uint64_t state : used)
+			WriteVarint(stream, state + 1);
+		for (auto& current : runs)
+		{
+			WriteVarint(stream, current.m_PaletteIndex);
+			WriteVarint(stream, current.m_Length - 1);
+		}
+
+		std::uint32_t streamSize = static_cast<std::uint32_t>(stream.size());
+		std::size_t   offset     = data.size();
+		data.resize(offset + sizeof(streamSize));
+		std::memcpy(data.data() + offset, &streamSize, sizeof(streamSize));
+		LZ::compress(stream.data(), stream.size(), data);
+	}
+
+	bool decode(const std::uint8_t* data, std::size_t size, ChunkStorage& storage)
+	{
+		std::uint32_t streamSize;
+		if (size < sizeof(streamSize))
+			return false;
+		std::memcpy(&streamSize, data, sizeof(streamSize));
+		if (streamSize > MaxStreamSize)
+			return false;
+
+		thread_local std::vector<std::uint8_t> stream;
+		stream.resize(streamSize);
+		if (!LZ::decompress(data + sizeof(streamSize), size - sizeof(streamSize), stream.data(), streamSize))
+			return false;
+
+		const std::uint8_t* in  = stream.data();
+		const std::uint8_t* end = in + stream.size();
+
+		std::uint64_t paletteSize;
+		if (!ReadVarint(in, end, paletteSize) || paletteSize == 0 || paletteSize > ChunkStorage::MaxPalette)
+			return false;
+
+		std::vector<std::uint64_t> palette(paletteSize);
+		for (auto& state : palette)
+		{
+			if (!ReadVarint(in, end, state))
+				return false;
+			--state;
+		}
+
+		std::uint32_t       bits = ChunkStorage::BitsForPaletteSize(palette.size());
+		ChunkStorage::Words words(bits == 0 ? 0 : ChunkStorage::VoxelCount / (64 / bits), 0);
+		for (std::size_t position = 0; position < ChunkStorage::VoxelCount;)
+		{
+			std::uint64_t paletteIndex, length;
+			if (!ReadVarint(in, end, paletteIndex) || !ReadVarint(in, end, length))
+				return false;
+
+			++length;
+			if (paletteIndex >= paletteSize || length > ChunkStorage::VoxelCount - position)
+				return false;
+
+			if (bits != 0)
+				FillRun(words, bits, position, static_cast<std::size_t>(length), paletteIndex);
+			position += static_cast<std::size_t>(length);
+		}
+		if (in != end)
+			return false;
+
+		storage.assign(std::move(palette), std::move(words));
+		return true;
+	}
+} // namespace ChunkCodec
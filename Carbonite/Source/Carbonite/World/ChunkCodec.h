@@ -0,0 +1,22 @@
+#pragma once
+
+#include "ChunkStorage.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+// Compressed chunk encoding used by the region files and the cold chunk cache.
+// The palette is reduced to the states actually in use, ordered by first appearance, then the voxels are run length
+// coded in PositionToIndex() order as varint (palette index, run length - 1) pairs. Terrain is layered along z,
+// which is the slowest axis of that order, so whole layers collapse into single runs.
+// The palette and runs are finally packed with LZ to catch repeating run patterns.
+// Layout: [u32 size of the run stream][LZ block].
+namespace ChunkCodec
+{
+	// Appends the encoded storage to data.
+	void encode(const ChunkStorage& storage, std::vector<std::uint8_t>& data);
+	// Returns false on malformed input, storage is left untouched in that case.
+	bool decode(const std::uint8_t* data, std::size_t size, ChunkStorage& storage);
+} // namespace ChunkCodec
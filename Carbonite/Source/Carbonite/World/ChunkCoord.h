@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class EFace : std::uint8_t
+{
+	NegativeX,
+	PositiveX,
+	NegativeY,
+	PositiveY,
+	NegativeZ,
+	PositiveZ
+};
+
+static constexpr std::uint32_t FaceCount = 6;
+
+constexpr EFace getOppositeFace(EFace face) { return static_cast<EFace>(static_cast<std::uint8_t>(face) ^ 1); }
+constexpr std::uint32_t getFaceAxis(EFace face) { return static_cast<std::uint32_t>(face) >> 1; }
+constexpr bool          isPositiveFace(EFace face) { return static_cast<std::uint32_t>(face) & 1; }
+
+struct ChunkCoord
+{
+public:
+	// Interleaves the low 21 bits of every axis, two's complement keeps neighbouring negative coordinates close as well.
+	static constexpr std::uint64_t Morton(std::int64_t x, std::int64_t y, std::int64_t z)
+	{
+		return SpreadBits(static_cast<std::uint64_t>(x)) | (SpreadBits(static_cast<std::uint64_t>(y)) << 1) | (SpreadBits(static_cast<std::uint64_t>(z)) << 2);
+	}
+
+	static constexpr std::uint64_t SpreadBits(std::uint64_t value)
+	{
+		value &= 0x1F'FFFF;
+		value = (value | (value << 32)) & 0x001F'0000'0000'FFFF;
+		value = (value | (value << 16)) & 0x001F'0000'FF00'00FF;
+		value = (value | (value << 8)) & 0x100F'00F0'0F00'F00F;
+		value = (value | (value << 4)) & 0x10C3'0C30'C30C'30C3;
+		value = (value | (value << 2)) & 0x1249'2492'4924'9249;
+		return value;
+	}
+
+public:
+	constexpr std::uint64_t morton() const { return Morton(m_X, m_Y, m_Z); }
+
+	constexpr ChunkCoord offset(std::int64_t x, std::int64_t y, std::int64_t z) const { return { m_X + x, m_Y + y, m_Z + z }; }
+	constexpr ChunkCoord neighbour(EFace face) const
+	{
+		std::int64_t step = isPositiveFace(face) ? 1 : -1;
+		switch (getFaceAxis(face))
+		{
+		case 0: return offset(step, 0, 0);
+		case 1: return offset(0, step, 0);
+		default: return offset(0, 0, step);
+		}
+	}
+
+	friend constexpr bool operator==(const ChunkCoord& lhs, const ChunkCoord& rhs) { return lhs.m_X == rhs.m_X && lhs.m_Y == rhs.m_Y && lhs.m_Z == rhs.m_Z; }
+	friend constexpr bool operator!=(const ChunkCoord& lhs, const ChunkCoord& rhs) { return !(lhs == rhs); }
+
+public:
+	std::int64_t m_X = 0, m_Y = 0, m_Z = 0;
+};
+
+struct ChunkCoordHash
+{
+public:
+	std::size_t operator()(const ChunkCoord& coord) const { return static_cast<std::size_t>(coord.morton() * 0x9E37'79B9'7F4A'7C15ULL); }
+};
@@ -0,0 +1,52 @@
+#include "ChunkFluid.h"
+#include "Utils/LZ.h"
+
+namespace
+{
+	enum class EFluidEncoding : std::uint8_t
+	{
+		Empty  = 0,
+		Packed = 1
+	};
+} // namespace
+
+void ChunkFluid::serialize(std::vector<std::uint8_t>& data) const
+{
+	if (m_Cells.empty())
+	{
+		data.push_back(static_cast<std::uint8_t>(EFluidEncoding::Empty));
+		return;
+	}
+
+	data.push_back(static_cast<std::uint8_t>(EFluidEncoding::Packed));
+	LZ::compress(m_Cells.data(), m_Cells.size(), data);
+}
+
+bool ChunkFluid::deserialize(const std::uint8_t* data, std::size_t size)
+{
+	clear();
+	if (size < 1)
+		return false;
+
+	switch (static_cast<EFluidEncoding>(data[0]))
+	{
+	case EFluidEncoding::Empty: return size == 1;
+	case EFluidEncoding::Packed:
+	{
+		m_Cells.assign(VoxelCount, 0);
+		if (!LZ::decompress(data + 1, size - 1, m_Cells.data(), m_Cells.size()))
+		{
+			clear();
+			return false;
+		}
+
+		for (std::uint8_t cell : m_Cells)
+			m_Count += cell != 0;
+		++m_Revision;
+		if (m_Count == 0)
+			clear();
+		return true;
+	}
+	default: return false;
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Utils/SlabAllocator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+// Fluid of every voxel in a chunk, one byte per voxel: level in the low 4 bits (0 = none, MaxLevel = full), the source bit
+// and the fluid kind in the top 3 bits. Fluid lives next to the voxels, only non-solid voxels hold it.
+// A chunk without fluid stores nothing, the array is created by the first write and dropped again with the last fluid.
+// Fluid changes bump their own revision, the chunk's revision only follows the voxels.
+class ChunkFluid
+{
+public:
+	static constexpr std::size_t  VoxelCount = 32 * 32 * 32;
+	static constexpr std::uint8_t MaxLevel   = 8;
+	static constexpr std::uint8_t KindCount  = 8;
+
+	static constexpr std::uint8_t Make(std::uint8_t kind, std::uint8_t level, bool source)
+	{
+		return level == 0 ? 0 : static_cast<std::uint8_t>((level & LevelMask) | (source ? SourceBit : 0) | (kind << KindShift));
+	}
+
+	static constexpr std::uint8_t GetLevel(std::uint8_t cell) { return cell & LevelMask; }
+	static constexpr std::uint8_t GetKind(std::uint8_t cell) { return cell >> KindShift; }
+	static constexpr bool         IsSource(std::uint8_t cell) { return cell & SourceBit; }
+
+public:
+	std::uint8_t get(std::size_t index) const { return m_Cells.empty() ? 0 : m_Cells[index]; }
+
+	void set(std::size_t index, std::uint8_t cell)
+	{
+		if (m_Cells.empty())
+		{
+			if (cell == 0)
+				return;
+			m_Cells.assign(VoxelCount, 0);
+		}
+
+		std::uint8_t& current = m_Cells[index];
+		if (current == cell)
+			return;
+		if (current == 0 && cell != 0)
+			++m_Count;
+		else if (current != 0 && cell == 0)
+			--m_Count;
+		current = cell;
+		++m_Revision;
+		if (m_Count == 0)
+			clear();
+	}
+
+	void clear()
+	{
+		if (!m_Cells.empty())
+			++m_Revision;
+		m_Cells.clear();
+		m_Cells.shrink_to_fit();
+		m_Count = 0;
+	}
+
+	bool isEmpty() const { return m_Cells.empty(); }
+	auto getCount() const { return m_Count; }
+	auto getRevision() const { return m_Revision; }
+
+	std::size_t getMemoryUsage() const { return m_Cells.capacity(); }
+
+	// Appends the cells to data, a single byte if there is no fluid and LZ packed otherwise.
+	void serialize(std::vector<std::uint8_t>& data) const;
+	// Leaves the fluid empty on malformed input.
+	bool deserialize(const std::uint8_t* data, std::size_t size);
+
+private:
+	static constexpr std::uint8_t LevelMask = 0x0F;
+	static constexpr std::uint8_t SourceBit = 0x10;
+	static constexpr std::uint8_t KindShift = 5;
+
+	std::vector<std::uint8_t, SlabAllocator<std::uint8_t>> m_Cells; // 32 KiB, from the slab arenas like the light levels
+	std::size_t                                            m_Count    = 0;
+	std::uint64_t                                          m_Revision = 0;
+};
@@ -0,0 +1,190 @@
+#include "ChunkHeightmap.h"
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Chunk.h"
+#include "Utils/LZ.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace
+{
+	enum class EHeightmapEncoding : std::uint8_t
+	{
+		Uniform = 0, // One height per heightmap
+		Packed  = 1  // LZ block of every height
+	};
+} // namespace
+
+std::uint32_t ChunkHeightmap::GetMask(const BlockStateTable& blockStates, std::uint64_t state)
+{
+	std::uint16_t runtimeId = blockStates.getRuntimeId(state);
+	return (blockStates.getOpaqueColumn()[runtimeId] ? 1U << static_cast<std::uint32_t>(EHeightmap::Opaque) : 0U) |
+	       (blockStates.getSolidColumn()[runtimeId] ? 1U << static_cast<std::uint32_t>(EHeightmap::MotionBlocking) : 0U);
+}
+
+void ChunkHeightmap::build(const ChunkStorage& voxels, const BlockStateTable& blockStates)
+{
+	m_Valid = true;
+
+	// Heightmaps that every voxel or no voxel counts for are settled by the states in use, without looking at the voxels.
+	// Palettes keep entries no voxel uses anymore (generated chunks start with every terrain state), so count the uses.
+	thread_local std::vector<std::uint32_t> counts;
+	thread_local std::vector<std::uint8_t>  masks;
+	auto&                                   palette = voxels.getPalette();
+	std::uint32_t                           any     = 0;
+	std::uint32_t                           all     = ~0U;
+	voxels.histogram(counts);
+	masks.resize(palette.size());
+	for (std::size_t i = 0; i < palette.size(); ++i)
+	{
+		masks[i] = static_cast<std::uint8_t>(GetMask(blockStates, palette[i]));
+		if (counts[i] == 0)
+			continue;
+		any |= masks[i];
+		all &= masks[i];
+	}
+
+	// Top down, a surface near the top of the chunk resolves every column within a few layers. pending holds a bit per column
+	// of a row that has no height yet, rows without one are skipped.
+	std::array<std::array<std::uint32_t, Size>, HeightmapCount> pending;
+	std::array<std::size_t, HeightmapCount>                     remaining;
+	for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+	{
+		bool settled = !((any >> i) & 1) || ((all >> i) & 1);
+		m_Heights[i].fill((all >> i) & 1 ? static_cast<std::uint8_t>(Size) : 0);
+		pending[i].fill(settled ? 0 : ~0U);
+		remaining[i] = settled ? 0 : ColumnCount;
+	}
+
+	// A row is read a word at a time, words holding a single index (air above the surface, rock below) skip the lookups.
+	auto&         words     = voxels.getWords();
+	std::uint32_t bits      = std::max(voxels.getBitsPerIndex(), 1U);
+	std::uint32_t perWord   = 64 / bits;
+	std::uint32_t step      = std::min(perWord, static_cast<std::uint32_t>(Size));
+	std::uint64_t indexMask = (1ULL << bits) - 1;
+	std::uint64_t stepMask  = step * bits == 64 ? ~0ULL : (1ULL << (step * bits)) - 1;
+	std::uint64_t repeat    = (~0ULL / indexMask) & stepMask;
+	for (std::uint32_t z = Size; z-- > 0 && (remaining[0] || remaining[1]);)
+	{
+		for (std::uint32_t y = 0; y < Size; ++y)
+		{
+			if (!(pending[0][y] | pending[1][y]))
+				continue;
+
+			std::array<std::uint32_t, HeightmapCount> hits {};
+			std::size_t                               index = Chunk::PositionToIndex(0, y, z);
+			for (std::uint32_t x = 0; x < Size; x += step, index += step)
+			{
+				std::uint64_t word  = (words[index / perWord] >> ((index % perWord) * bits)) & stepMask;
+				std::uint64_t first = word & indexMask;
+				if (word == first * repeat)
+				{
+					std::uint32_t mask = masks[static_cast<std::size_t>(first)];
+					std::uint32_t run  = static_cast<std::uint32_t>(((1ULL << step) - 1) << x);
+					for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+						hits[i] |= (mask >> i) & 1 ? run : 0;
+					continue;
+				}
+
+				for (std::uint32_t j = 0; j < step; ++j, word >>= bits)
+				{
+					std::uint32_t mask = masks[static_cast<std::size_t>(word & indexMask)];
+					for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+						hits[i] |= ((mask >> i) & 1) << (x + j);
+				}
+			}
+
+			for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+			{
+				std::uint32_t found = hits[i] & pending[i][y];
+				pending[i][y] &= ~found;
+				remaining[i] -= static_cast<std::size_t>(std::popcount(found));
+				for (; found; found &= found - 1)
+					m_Heights[i][ColumnIndex(static_cast<std::uint32_t>(std::countr_zero(found)), y)] = static_cast<std::uint8_t>(z + 1);
+			}
+		}
+	}
+}
+
+std::uint32_t ChunkHeightmap::voxelChanged(const ChunkStorage& voxels, const BlockStateTable& blockStates, std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+	std::uint32_t changed = 0;
+	std::uint32_t mask    = GetMask(blockStates, voxels.get(Chunk::PositionToIndex(x, y, z)));
+	std::size_t   column  = ColumnIndex(x, y);
+	for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+	{
+		std::uint8_t& height = m_Heights[i][column];
+		if ((mask >> i) & 1)
+		{
+			if (z + 1 > height)
+			{
+				height = static_cast<std::uint8_t>(z + 1);
+				changed |= 1U << i;
+			}
+			continue;
+		}
+		if (z + 1 != height)
+			continue;
+
+		// The top voxel of the column went away, the next one down is the new top.
+		height = 0;
+		for (std::uint32_t below = z; below-- > 0;)
+		{
+			if ((GetMask(blockStates, voxels.get(Chunk::PositionToIndex(x, y, below))) >> i) & 1)
+			{
+				height = static_cast<std::uint8_t>(below + 1);
+				break;
+			}
+		}
+		changed |= 1U << i;
+	}
+	return changed;
+}
+
+void ChunkHeightmap::serialize(std::vector<std::uint8_t>& data) const
+{
+	bool uniform = true;
+	for (auto& heights : m_Heights)
+		for (std::uint8_t height : heights)
+			uniform &= height == heights[0];
+
+	if (uniform)
+	{
+		data.push_back(static_cast<std::uint8_t>(EHeightmapEncoding::Uniform));
+		for (auto& heights : m_Heights)
+			data.push_back(heights[0]);
+		return;
+	}
+
+	data.push_back(static_cast<std::uint8_t>(EHeightmapEncoding::Packed));
+	LZ::compress(m_Heights[0].data(), sizeof(m_Heights), data);
+}
+
+bool ChunkHeightmap::deserialize(const std::uint8_t* data, std::size_t size)
+{
+	m_Valid = false;
+	if (size < 1)
+		return false;
+
+	switch (static_cast<EHeightmapEncoding>(data[0]))
+	{
+	case EHeightmapEncoding::Uniform:
+		if (size != 1 + HeightmapCount)
+			return false;
+		for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+			m_Heights[i].fill(data[1 + i]);
+		break;
+	case EHeightmapEncoding::Packed:
+		if (!LZ::decompress(data + 1, size - 1, m_Heights[0].data(), sizeof(m_Heights)))
+			return false;
+		break;
+	default: return false;
+	}
+
+	for (auto& heights : m_Heights)
+		for (std::uint8_t height : heights)
+			if (height > Size)
+				return false;
+	m_Valid = true;
+	return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <vector>
+
+class BlockStateTable;
+class ChunkStorage;
+
+enum class EHeightmap : std::uint8_t
+{
+	Opaque,        // BlockState::m_Opaque, where sky light stops
+	MotionBlocking // BlockState::m_Solid, what rain, spawns and falling things land on
+};
+
+static constexpr std::uint32_t HeightmapCount = 2;
+
+// Highest voxel of every 32x32 column of a chunk for each EHeightmap, kept next to the voxels so height queries never decode
+// them. A height is the local z of the highest matching voxel + 1, 0 if the column has none inside the chunk.
+// Dimension builds it when a chunk is loaded without one and updates it per voxel edit, only scanning down a column when its
+// top voxel is removed. Writing the voxels of a chunk directly (Chunk::set(), getVoxels()) leaves it stale until build().
+class ChunkHeightmap
+{
+public:
+	static constexpr std::size_t Size        = 32;
+	static constexpr std::size_t ColumnCount = Size * Size;
+
+	static std::size_t ColumnIndex(std::uint32_t x, std::uint32_t y) { return x + y * Size; }
+	// Bit per EHeightmap the state counts for.
+	static std::uint32_t GetMask(const BlockStateTable& blockStates, std::uint64_t state);
+
+public:
+	std::uint8_t get(EHeightmap heightmap, std::uint32_t x, std::uint32_t y) const { return m_Heights[static_cast<std::size_t>(heightmap)][ColumnIndex(x, y)]; }
+	auto&        getHeights(EHeightmap heightmap) const { return m_Heights[static_cast<std::size_t>(heightmap)]; }
+
+	void build(const ChunkStorage& voxels, const BlockStateTable& blockStates);
+	// Call after the voxel at x, y, z was set, voxels must already hold the new state.
+	// Returns a bit per EHeightmap whose height of the column changed.
+	std::uint32_t voxelChanged(const ChunkStorage& voxels, const BlockStateTable& blockStates, std::uint32_t x, std::uint32_t y, std::uint32_t z);
+
+	void invalidate() { m_Valid = false; }
+	bool isValid() const { return m_Valid; }
+
+	// Appends the heights to data, a single byte per heightmap if all its columns are equal and LZ packed otherwise.
+	void serialize(std::vector<std::uint8_t>& data) const;
+	// Leaves the heightmap invalid on malformed input.
+	bool deserialize(const std::uint8_t* data, std::size_t size);
+
+private:
+	std::array<std::array<std::uint8_t, ColumnCount>, HeightmapCount> m_Heights {};
+	bool                                                              m_Valid = false;
+};
@@ -0,0 +1,104 @@
+#include "ChunkIndex.h"
+
+#include <bit>
+
+ChunkIndex::ChunkIndex(std::size_t initialCapacity)
+{
+	rehash(std::bit_ceil(initialCapacity < 16 ? 16 : initialCapacity));
+}
+
+Chunk* ChunkIndex::find(const ChunkCoord& coord) const
+{
+	std::uint64_t key = coord.morton();
+	for (std::size_t i = home(key);; i = (i + 1) & m_Mask)
+	{
+		auto& slot = m_Slots[i];
+		if (!slot.m_Chunk)
+			return nullptr;
+		if (slot.m_Key == key && slot.m_Coord == coord)
+			return slot.m_Chunk;
+	}
+}
+
+bool ChunkIndex::insert(const ChunkCoord& coord, Chunk* chunk)
+{
+	if ((m_Size + 1) * 4 > m_Slots.size() * 3)
+		rehash(m_Slots.size() * 2);
+
+	std::uint64_t key = coord.morton();
+	for (std::size_t i = home(key);; i = (i + 1) & m_Mask)
+	{
+		auto& slot = m_Slots[i];
+		if (!slot.m_Chunk)
+		{
+			slot = { key, coord, chunk };
+			++m_Size;
+			return true;
+		}
+		if (slot.m_Key == key && slot.m_Coord == coord)
+			return false;
+	}
+}
+
+Chunk* ChunkIndex::erase(const ChunkCoord& coord)
+{
+	std::uint64_t key = coord.morton();
+	std::size_t   i   = home(key);
+	for (;; i = (i + 1) & m_Mask)
+	{
+		auto& slot = m_Slots[i];
+		if (!slot.m_Chunk)
+			return nullptr;
+		if (slot.m_Key == key && slot.m_Coord == coord)
+			break;
+	}
+
+	Chunk* chunk = m_Slots[i].m_Chunk;
+
+	// Shift following entries back into the hole unless that would move them before their home slot.
+	std::size_t hole = i;
+	for (std::size_t j = (hole + 1) & m_Mask; m_Slots[j].m_Chunk; j = (j + 1) & m_Mask)
+	{
+		std::size_t slotHome = home(m_Slots[j].m_Key);
+		if (((j - slotHome) & m_Mask) >= ((j - hole) & m_Mask))
+		{
+			m_Slots[hole] = m_Slots[j];
+			hole          = j;
+		}
+	}
+	m_Slots[hole] = {};
+	--m_Size;
+	return chunk;
+}
+
+void ChunkIndex::clear()
+{
+	for (auto& slot : m_Slots)
+		slot = {};
+	m_Size = 0;
+}
+
+void ChunkIndex::rehash(std::size_t capacity)
+{
+	std::vector<Slot> slots = std::move(m_Slots);
+	m_Slots.assign(capacity, {});
+	m_Mask  = capacity - 1;
+	m_Shift = 64 - static_cast<std::uint32_t>(std::countr_zero(capacity));
+	m_Size  = 0;
+
+	for (auto& slot : slots)
+	{
+		if (!slot.m_Chunk)
+			continue;
+
+		for (std::size_t i = home(slot.m_Key);; i = (i + 1) & m_Mask)
+		{
+			if (!m_Slots[i].m_Chunk)
+			{
+				m_Slots[i] = slot;
+				++m_Size;
+				break;
+			}
+		}
+	}
+}
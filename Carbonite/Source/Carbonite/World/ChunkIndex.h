@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ChunkCoord.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+struct Chunk;
+
+// Open addressing hash map from chunk coordinates to chunks.
+// Slots are keyed by the Morton code of the coordinate, the full coordinate is kept to resolve wrap around collisions.
+// Removal uses backward shift deletion so lookups never have to step over tombstones.
+class ChunkIndex
+{
+public:
+	ChunkIndex(std::size_t initialCapacity = 256);
+
+	Chunk* find(const ChunkCoord& coord) const;
+	bool   insert(const ChunkCoord& coord, Chunk* chunk);
+	Chunk* erase(const ChunkCoord& coord);
+	void   clear();
+
+	template <class F>
+	void forEach(F&& func) const
+	{
+		for (auto& slot : m_Slots)
+			if (slot.m_Chunk)
+				func(slot.m_Coord, slot.m_Chunk);
+	}
+
+	auto getSize() const { return m_Size; }
+	auto getCapacity() const { return m_Slots.size(); }
+
+private:
+	struct Slot
+	{
+	public:
+		std::uint64_t m_Key = 0;
+		ChunkCoord    m_Coord;
+		Chunk*        m_Chunk = nullptr;
+	};
+
+	static std::uint64_t Hash(std::uint64_t key)
+	{
+		// Morton codes cluster in the low bits, multiply by the golden ratio so the top bits pick the slot.
+		return key * 0x9E37'79B9'7F4A'7C15ULL;
+	}
+
+	std::size_t home(std::uint64_t key) const { return static_cast<std::size_t>(Hash(key) >> m_Shift); }
+
+	void rehash(std::size_t capacity);
+
+private:
+	std::vector<Slot> m_Slots;
+	std::size_t       m_Mask  = 0;
+	std::uint32_t     m_Shift = 64;
+	std::size_t       m_Size  = 0;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Utils/SlabAllocator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+enum class ELightChannel : std::uint8_t
+{
+	Block,
+	Sky
+};
+
+// Block and sky light of every voxel in a chunk, 4 bit levels packed into one byte per voxel (block low, sky high).
+// A chunk with the same levels everywhere (open air, solid rock) stores a single byte, the array is created on the first
+// write that breaks uniformity.
+class ChunkLight
+{
+public:
+	static constexpr std::size_t  VoxelCount = 32 * 32 * 32;
+	static constexpr std::uint8_t MaxLevel   = 15;
+
+public:
+	ChunkLight(std::uint8_t block = 0, std::uint8_t sky = 0) { fill(block, sky); }
+
+	std::uint8_t get(ELightChannel channel, std::size_t index) const
+	{
+		std::uint8_t levels = m_Levels.empty() ? m_Uniform : m_Levels[index];
+		return channel == ELightChannel::Sky ? levels >> 4 : levels & 0xF;
+	}
+
+	void set(ELightChannel channel, std::size_t index, std::uint8_t level)
+	{
+		std::uint8_t shift = channel == ELightChannel::Sky ? 4 : 0;
+		std::uint8_t mask  = static_cast<std::uint8_t>(0xF << shift);
+		if (m_Levels.empty())
+		{
+			if (((m_Uniform & mask) >> shift) == level)
+				return;
+			m_Levels.assign(VoxelCount, m_Uniform);
+		}
+		m_Levels[index] = static_cast<std::uint8_t>((m_Levels[index] & ~mask) | (level << shift));
+	}
+
+	void fill(std::uint8_t block, std::uint8_t sky)
+	{
+		m_Uniform = static_cast<std::uint8_t>((block & 0xF) | (sky << 4));
+		m_Levels.clear();
+		m_Levels.shrink_to_fit();
+	}
+
+	bool isUniform() const { return m_Levels.empty(); }
+	// Only meaningful while isUniform().
+	std::uint8_t getUniform(ELightChannel channel) const { return channel == ELightChannel::Sky ? m_Uniform >> 4 : m_Uniform & 0xF; }
+
+	std::size_t getMemoryUsage() const { return m_Levels.capacity(); }
+
+private:
+	std::vector<std::uint8_t, SlabAllocator<std::uint8_t>> m_Levels; // 32 KiB, from the slab arenas like the packed voxels
+	std::uint8_t                                           m_Uniform = 0;
+};
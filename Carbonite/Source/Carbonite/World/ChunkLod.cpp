@@ -0,0 +1,263 @@
+#include "ChunkLod.h"
+#include "Dimension.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_set>
+
+std::uint64_t ChunkLod::Reduce(const std::array<std::uint64_t, 8>& states, ELodReduction reduction)
+{
+	std::uint64_t best      = Chunk::EmptyState;
+	std::uint32_t bestCount = 0;
+	for (std::uint32_t i = 0; i < 8; ++i)
+	{
+		std::uint64_t state = states[i];
+		if (reduction == ELodReduction::Priority && state == Chunk::EmptyState)
+			continue;
+
+		std::uint32_t count = 0;
+		for (std::uint32_t j = 0; j < 8; ++j)
+			count += states[j] == state;
+		if (count > bestCount || (count == bestCount && best == Chunk::EmptyState))
+		{
+			best      = state;
+			bestCount = count;
+		}
+		if (count > 4)
+			break;
+	}
+	return best;
+}
+
+void ChunkLod::select(const glm::fvec3& focus, std::vector<LodCoord>& nodes)
+{
+	m_Focus = { focus.x / Chunk::Size, focus.y / Chunk::Size, focus.z / Chunk::Size };
+	nodes.clear();
+
+	// Start at the coarsest level needed to reach the view distance and refine towards the focus.
+	std::uint32_t topLevel = 0;
+	while (topLevel < MaxLevel && getLevelDistance(topLevel) < static_cast<float>(m_ViewDistance))
+		++topLevel;
+
+	std::int64_t size   = 1LL << topLevel;
+	std::int64_t focusZ = static_cast<std::int64_t>(std::floor(m_Focus.z));
+	auto         first  = [size](float from) { return static_cast<std::int64_t>(std::floor(from / size)); };
+	for (std::int64_t z = first(static_cast<float>(focusZ - m_VerticalDistance)); z <= first(static_cast<float>(focusZ + m_VerticalDistance)); ++z)
+		for (std::int64_t y = first(m_Focus.y - m_ViewDistance); y <= first(m_Focus.y + m_ViewDistance); ++y)
+			for (std::int64_t x = first(m_Focus.x - m_ViewDistance); x <= first(m_Focus.x + m_ViewDistance); ++x)
+				selectNode({ { x, y, z }, static_cast<std::uint8_t>(topLevel) }, nodes);
+
+	m_Stats.m_Nodes = nodes.size();
+}
+
+void ChunkLod::update(const Dimension& dimension, const std::vector<LodCoord>& nodes)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	std::unordered_set<LodCoord, LodCoordHash> selected(nodes.begin(), nodes.end());
+	std::erase_if(m_Nodes, [&selected](const auto& entry) { return !selected.contains(entry.first); });
+
+	std::vector<std::pair<float, LodCoord>> pending;
+	for (auto& coord : nodes)
+	{
+		if (coord.m_Level == 0)
+			continue;
+
+		auto itr = m_Nodes.find(coord);
+		if (itr == m_Nodes.end() || itr->second.m_Outdated)
+			pending.emplace_back(distance(coord), coord);
+	}
+	std::sort(pending.begin(), pending.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+	// Always build at least one node so a tiny budget still makes progress.
+	std::size_t built = 0;
+	for (auto& [nodeDistance, coord] : pending)
+	{
+		if (built > 0 && std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() >= m_FrameBudget)
+			break;
+
+		auto& node = m_Nodes[coord];
+		if (!node.m_Chunk)
+			node.m_Chunk = std::make_unique<Chunk>(coord.m_Coord);
+		buildNode(dimension, coord, *node.m_Chunk);
+		node.m_Outdated = false;
+		++built;
+
+		// Border faces of the neighbours are culled against this node.
+		for (std::uint32_t i = 0; i < FaceCount; ++i)
+		{
+			auto itr = m_Nodes.find(coord.neighbour(static_cast<EFace>(i)));
+			if (itr != m_Nodes.end() && itr->second.m_Chunk)
+				itr->second.m_Chunk->markDirty();
+		}
+	}
+
+	m_Stats.m_Built       = built;
+	m_Stats.m_Pending     = pending.size() - built;
+	m_Stats.m_MemoryUsage = 0;
+	for (auto& [coord, node] : m_Nodes)
+		if (node.m_Chunk)
+			m_Stats.m_MemoryUsage += node.m_Chunk->getVoxels().getMemoryUsage();
+	m_Stats.m_UpdateMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ChunkLod::chunkChanged(const ChunkCoord& coord)
+{
+	LodCoord node { coord, 0 };
+	for (std::uint32_t level = 1; level <= MaxLevel; ++level)
+	{
+		node     = node.parent();
+		auto itr = m_Nodes.find(node);
+		if (itr != m_Nodes.end())
+			itr->second.m_Outdated = true;
+	}
+}
+
+const Chunk* ChunkLod::getNode(const Dimension& dimension, const LodCoord& coord) const
+{
+	if (coord.m_Level == 0)
+		return dimension.getChunk(coord.m_Coord);
+
+	auto itr = m_Nodes.find(coord);
+	return itr != m_Nodes.end() ? itr->second.m_Chunk.get() : nullptr;
+}
+
+void ChunkLod::setDistances(std::int64_t baseDistance, std::int64_t viewDistance, std::int64_t verticalDistance)
+{
+	m_BaseDistance     = std::max<std::int64_t>(baseDistance, 1);
+	m_ViewDistance     = std::max(viewDistance, m_BaseDistance);
+	m_VerticalDistance = std::max<std::int64_t>(verticalDistance, 0);
+}
+
+void ChunkLod::selectNode(const LodCoord& coord, std::vector<LodCoord>& nodes) const
+{
+	float nodeDistance = distance(coord);
+	if (nodeDistance >= static_cast<float>(m_ViewDistance))
+		return;
+
+	std::int64_t firstZ = coord.getFirstChunk().m_Z;
+	std::int64_t focusZ = static_cast<std::int64_t>(std::floor(m_Focus.z));
+	if (firstZ + coord.getSize() <= focusZ - m_VerticalDistance || firstZ > focusZ + m_VerticalDistance)
+		return;
+
+	if (coord.m_Level > 0 && nodeDistance < getLevelDistance(coord.m_Level - 1))
+	{
+		for (std::uint32_t i = 0; i < 8; ++i)
+			selectNode(coord.child(i), nodes);
+		return;
+	}
+	nodes.push_back(coord);
+}
+
+float ChunkLod::distance(const LodCoord& coord) const
+{
+	ChunkCoord first = coord.getFirstChunk();
+	float      size  = static_cast<float>(coord.getSize());
+	float      minX  = static_cast<float>(first.m_X);
+	float      minY  = static_cast<float>(first.m_Y);
+	float      dx    = std::max({ minX - m_Focus.x, m_Focus.x - (minX + size), 0.0f });
+	float      dy    = std::max({ minY - m_Focus.y, m_Focus.y - (minY + size), 0.0f });
+	return std::sqrt(dx * dx + dy * dy);
+}
+
+float ChunkLod::getLevelDistance(std::uint32_t level) const
+{
+	return static_cast<float>(std::min(m_BaseDistance << level, m_ViewDistance));
+}
+
+void ChunkLod::buildNode(const Dimension& dimension, const LodCoord& coord, Chunk& node)
+{
+	// Reducing a node with unloaded chunks would leave holes, the generator fills those from the terrain noise instead.
+	bool         covered = true;
+	ChunkCoord   first   = coord.getFirstChunk();
+	std::int64_t size    = coord.getSize();
+	for (std::int64_t z = 0; covered && z < size; ++z)
+		for (std::int64_t y = 0; covered && y < size; ++y)
+			for (std::int64_t x = 0; covered && x < size; ++x)
+				covered = dimension.getChunk(first.offset(x, y, z)) != nullptr;
+
+	if (covered || !m_Generator)
+	{
+		reduceNode(dimension, coord, node);
+		return;
+	}
+
+	node.getVoxels().fill(Chunk::EmptyState);
+	m_Generator(node, coord.m_Level);
+	node.markDirty();
+}
+
+void ChunkLod::reduceNode(const Dimension& dimension, const LodCoord& coord, Chunk& node)
+{
+	std::array<std::unique_ptr<Chunk>, 8> reduced;
+	std::array<const Chunk*, 8>           children;
+	for (std::uint32_t i = 0; i < 8; ++i)
+	{
+		LodCoord child = coord.child(i);
+		if (child.m_Level == 0)
+		{
+			children[i] = dimension.getChunk(child.m_Coord);
+			continue;
+		}
+
+		reduced[i] = std::make_unique<Chunk>(child.m_Coord);
+		reduceNode(dimension, child, *reduced[i]);
+		children[i] = reduced[i].get();
+	}
+	downsample(children, node);
+}
+
+void ChunkLod::downsample(const std::array<const Chunk*, 8>& children, Chunk& node)
+{
+	constexpr std::uint32_t Half = Chunk::Size / 2;
+
+	m_Voxels.resize(ChunkStorage::VoxelCount);
+	m_Cells.resize(ChunkStorage::VoxelCount);
+	std::array<std::uint64_t, 8> states;
+	for (std::uint32_t i = 0; i < 8; ++i)
+	{
+		std::uint32_t offsetX = (i & 1) * Half;
+		std::uint32_t offsetY = ((i >> 1) & 1) * Half;
+		std::uint32_t offsetZ = (i >> 2) * Half;
+		const Chunk*  child   = children[i];
+		if (!child || child->getVoxels().isUniform())
+		{
+			std::uint64_t state = child ? child->getVoxels().get(0) : Chunk::EmptyState;
+			for (std::uint32_t z = 0; z < Half; ++z)
+				for (std::uint32_t y = 0; y < Half; ++y)
+					std::fill_n(m_Cells.data() + Chunk::PositionToIndex(offsetX, offsetY + y, offsetZ + z), Half, state);
+			continue;
+		}
+
+		child->getVoxels().forEach([this](std::size_t index, std::uint64_t state) { m_Voxels[index] = state; });
+		for (std::uint32_t z = 0; z < Half; ++z)
+		{
+			for (std::uint32_t y = 0; y < Half; ++y)
+			{
+				for (std::uint32_t x = 0; x < Half; ++x)
+				{
+					for (std::uint32_t j = 0; j < 8; ++j)
+						states[j] = m_Voxels[Chunk::PositionToIndex(x * 2 + (j & 1), y * 2 + ((j >> 1) & 1), z * 2 + (j >> 2))];
+					m_Cells[Chunk::PositionToIndex(offsetX + x, offsetY + y, offsetZ + z)] = Reduce(states, m_Reduction);
+				}
+			}
+		}
+	}
+
+	// Terrain is mostly long runs of the same state, write it a run at a time.
+	auto& voxels = node.getVoxels();
+	voxels.fill(m_Cells[0]);
+	for (std::size_t index = 0; index < ChunkStorage::VoxelCount;)
+	{
+		std::uint64_t state = m_Cells[index];
+		std::size_t   end   = index + 1;
+		while (end < ChunkStorage::VoxelCount && m_Cells[end] == state)
+			++end;
+		if (state != m_Cells[0])
+			voxels.fillRun(index, end - index, state);
+		index = end;
+	}
+	voxels.compact();
+	node.markDirty();
+}
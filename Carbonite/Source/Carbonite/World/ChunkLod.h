@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Chunk.h"
+#include "ChunkCoord.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Dimension;
+
+// A node of the LOD octree, a node of level L covers 2^L chunks along every axis and level 0 nodes are the chunks themselves.
+struct LodCoord
+{
+public:
+	constexpr std::int64_t getSize() const { return 1LL << m_Level; }
+	// First chunk covered by the node.
+	constexpr ChunkCoord getFirstChunk() const { return { m_Coord.m_X * getSize(), m_Coord.m_Y * getSize(), m_Coord.m_Z * getSize() }; }
+
+	constexpr LodCoord parent() const { return { { m_Coord.m_X >> 1, m_Coord.m_Y >> 1, m_Coord.m_Z >> 1 }, static_cast<std::uint8_t>(m_Level + 1) }; }
+	// Children are indexed x + y * 2 + z * 4.
+	constexpr LodCoord child(std::uint32_t index) const
+	{
+		return { { m_Coord.m_X * 2 + (index & 1), m_Coord.m_Y * 2 + ((index >> 1) & 1), m_Coord.m_Z * 2 + (index >> 2) }, static_cast<std::uint8_t>(m_Level - 1) };
+	}
+	constexpr LodCoord neighbour(EFace face) const { return { m_Coord.neighbour(face), m_Level }; }
+
+	friend constexpr bool operator==(const LodCoord& lhs, const LodCoord& rhs) { return lhs.m_Coord == rhs.m_Coord && lhs.m_Level == rhs.m_Level; }
+	friend constexpr bool operator!=(const LodCoord& lhs, const LodCoord& rhs) { return !(lhs == rhs); }
+
+public:
+	ChunkCoord   m_Coord; // In units of the node size
+	std::uint8_t m_Level = 0;
+};
+
+struct LodCoordHash
+{
+public:
+	std::size_t operator()(const LodCoord& coord) const { return ChunkCoordHash {}(coord.m_Coord) ^ (static_cast<std::size_t>(coord.m_Level) * 0xC2B2'AE3D'27D4'EB4FULL); }
+};
+
+enum class ELodReduction : std::uint8_t
+{
+	Majority, // Most common state of the 8 voxels, ties go to non empty states
+	Priority  // Most common non empty state, a single solid voxel keeps the cell solid so thin features survive
+};
+
+struct ChunkLodStats
+{
+public:
+	std::size_t m_Nodes              = 0; // Nodes selected by the last select()
+	std::size_t m_Built              = 0; // Nodes built in the last update
+	std::size_t m_Pending            = 0; // Selected nodes still missing or outdated after the last update
+	std::size_t m_MemoryUsage        = 0; // Voxel storage of every kept node in bytes
+	float       m_UpdateMilliseconds = 0.0f;
+};
+
+// Downsampled copies of the world for distant terrain.
+// A node of level L is a 32^3 grid whose cells are 2^L voxels wide, so it is a Chunk and goes through the regular chunk mesher.
+// select() picks nodes by horizontal distance from the focus: chunks up to the base distance, level L nodes up to
+// base distance * 2^L, capped by the view distance, nodes never overlap.
+// Nodes whose chunks are all loaded are reduced from them 2x2x2 voxels at a time, one level after the other. Other nodes
+// come from the LOD generator, or are reduced with missing chunks treated as empty if there is none.
+// update() builds missing and outdated nodes closest first within the frame budget and drops nodes that are no longer selected.
+class ChunkLod
+{
+public:
+	// Fills node with the terrain of the node coordinate node.getCoord() at the given level.
+	using LodGenerator = std::function<void(Chunk& node, std::uint32_t level)>;
+
+	static constexpr std::uint32_t MaxLevel = 3;
+
+	static std::uint64_t Reduce(const std::array<std::uint64_t, 8>& states, ELodReduction reduction);
+
+public:
+	// Returns the nodes to draw around focus in world coordinates.
+	void select(const glm::fvec3& focus, std::vector<LodCoord>& nodes);
+	// Builds the selected nodes, call with the nodes returned by select().
+	void update(const Dimension& dimension, const std::vector<LodCoord>& nodes);
+
+	// Outdates every node covering the chunk, call after its voxels changed.
+	void chunkChanged(const ChunkCoord& coord);
+
+	// Level 0 returns the loaded chunk, higher levels the node if it was built.
+	const Chunk* getNode(const Dimension& dimension, const LodCoord& coord) const;
+
+	void setGenerator(LodGenerator generator) { m_Generator = std::move(generator); }
+	void setReduction(ELodReduction reduction) { m_Reduction = reduction; }
+	// Distances are in chunks.
+	void setDistances(std::int64_t baseDistance, std::int64_t viewDistance, std::int64_t verticalDistance);
+	void setFrameBudget(float milliseconds) { m_FrameBudget = milliseconds; }
+
+	auto  getReduction() const { return m_Reduction; }
+	auto  getBaseDistance() const { return m_BaseDistance; }
+	auto  getViewDistance() const { return m_ViewDistance; }
+	auto  getVerticalDistance() const { return m_VerticalDistance; }
+	auto  getFrameBudget() const { return m_FrameBudget; }
+	auto& getStats() const { return m_Stats; }
+
+private:
+	struct Node
+	{
+	public:
+		std::unique_ptr<Chunk> m_Chunk;
+		bool                   m_Outdated = true;
+	};
+
+	void selectNode(const LodCoord& coord, std::vector<LodCoord>& nodes) const;
+	// Horizontal distance in chunks from the focus to the closest point of the node.
+	float distance(const LodCoord& coord) const;
+	float getLevelDistance(std::uint32_t level) const;
+
+	void buildNode(const Dimension& dimension, const LodCoord& coord, Chunk& node);
+	void reduceNode(const Dimension& dimension, const LodCoord& coord, Chunk& node);
+	void downsample(const std::array<const Chunk*, 8>& children, Chunk& node);
+
+private:
+	std::int64_t  m_BaseDistance     = 8;
+	std::int64_t  m_ViewDistance     = 32;
+	std::int64_t  m_VerticalDistance = 4;
+	float         m_FrameBudget      = 2.0f;
+	ELodReduction m_Reduction        = ELodReduction::Majority;
+	LodGenerator  m_Generator;
+
+	glm::fvec3                                       m_Focus = { 0.0f, 0.0f, 0.0f }; // In chunks
+	std::unordered_map<LodCoord, Node, LodCoordHash> m_Nodes;
+	std::vector<std::uint64_t>                       m_Voxels; // Decoded child
+	std::vector<std::uint64_t>                       m_Cells;  // Reduced node
+
+	ChunkLodStats m_Stats;
+};
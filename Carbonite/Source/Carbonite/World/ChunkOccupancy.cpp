@@ -0,0 +1,113 @@
+#include "ChunkOccupancy.h"
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Chunk.h"
+
+#include <algorithm>
+
+namespace
+{
+	// Bits from to to inclusive, both below 32.
+	std::uint32_t BitRange(std::uint32_t from, std::uint32_t to)
+	{
+		return static_cast<std::uint32_t>((2ULL << to) - (1ULL << from));
+	}
+} // namespace
+
+void ChunkOccupancy::build(const ChunkStorage& voxels, const BlockStateTable& blockStates, std::uint64_t revision)
+{
+	m_Revision = revision;
+	m_Layers.fill(0);
+
+	auto settle = [this](EOccupancy kind) {
+		m_Kind = kind;
+		m_Rows.clear();
+		m_Rows.shrink_to_fit();
+	};
+
+	if (voxels.isUniform())
+	{
+		settle(blockStates.isSolid(voxels.get(0)) ? EOccupancy::Full : EOccupancy::Empty);
+		return;
+	}
+
+	// Palettes keep entries no voxel uses anymore, only the states in use decide whether the chunk is empty or full.
+	thread_local std::vector<std::uint32_t> counts;
+	thread_local std::vector<std::uint8_t>  solid;
+	auto&                                   palette = voxels.getPalette();
+	bool                                    any     = false;
+	bool                                    all     = true;
+	voxels.histogram(counts);
+	solid.resize(palette.size());
+	for (std::size_t i = 0; i < palette.size(); ++i)
+	{
+		solid[i] = blockStates.isSolid(palette[i]) ? 1 : 0;
+		if (counts[i] == 0)
+			continue;
+		any |= solid[i] != 0;
+		all &= solid[i] != 0;
+	}
+	if (!any || all)
+	{
+		settle(all ? EOccupancy::Full : EOccupancy::Empty);
+		return;
+	}
+
+	// A row is read a word at a time, words holding a single index skip the lookups.
+	m_Kind = EOccupancy::Mixed;
+	m_Rows.assign(Size * Size, 0);
+	auto&         words     = voxels.getWords();
+	std::uint32_t bits      = voxels.getBitsPerIndex();
+	std::uint32_t perWord   = 64 / bits;
+	std::uint32_t step      = std::min(perWord, static_cast<std::uint32_t>(Size));
+	std::uint64_t indexMask = (1ULL << bits) - 1;
+	std::uint64_t stepMask  = step * bits == 64 ? ~0ULL : (1ULL << (step * bits)) - 1;
+	std::uint64_t repeat    = (~0ULL / indexMask) & stepMask;
+	std::uint32_t run       = static_cast<std::uint32_t>((1ULL << step) - 1);
+	for (std::uint32_t z = 0; z < Size; ++z)
+	{
+		for (std::uint32_t y = 0; y < Size; ++y)
+		{
+			std::uint32_t row   = 0;
+			std::size_t   index = Chunk::PositionToIndex(0, y, z);
+			for (std::uint32_t x = 0; x < Size; x += step, index += step)
+			{
+				std::uint64_t word  = (words[index / perWord] >> ((index % perWord) * bits)) & stepMask;
+				std::uint64_t first = word & indexMask;
+				if (word == first * repeat)
+				{
+					row |= solid[static_cast<std::size_t>(first)] ? run << x : 0;
+					continue;
+				}
+
+				for (std::uint32_t j = 0; j < step; ++j, word >>= bits)
+					row |= static_cast<std::uint32_t>(solid[static_cast<std::size_t>(word & indexMask)]) << (x + j);
+			}
+			m_Rows[y + z * Size] = row;
+			m_Layers[z] |= row ? 1U << y : 0;
+		}
+	}
+}
+
+bool ChunkOccupancy::any(const std::uint32_t (&first)[3], const std::uint32_t (&last)[3]) const
+{
+	switch (m_Kind)
+	{
+	case EOccupancy::Empty: return false;
+	case EOccupancy::Full: return true;
+	default: break;
+	}
+
+	std::uint32_t columns = BitRange(first[0], last[0]);
+	std::uint32_t rows    = BitRange(first[1], last[1]);
+	for (std::uint32_t z = first[2]; z <= last[2]; ++z)
+	{
+		if (!(m_Layers[z] & rows))
+			continue;
+
+		const std::uint32_t* layer = m_Rows.data() + z * Size;
+		for (std::uint32_t y = first[1]; y <= last[1]; ++y)
+			if (layer[y] & columns)
+				return true;
+	}
+	return false;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Utils/SlabAllocator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <vector>
+
+class BlockStateTable;
+class ChunkStorage;
+
+enum class EOccupancy : std::uint8_t
+{
+	Empty, // No solid voxel
+	Full,  // Only solid voxels
+	Mixed
+};
+
+// Bitmask of the solid voxels of a chunk (BlockState::m_Solid) for collision, a 32 bit row along x for every y and z and a bit
+// per non-empty row of every z layer on top. Chunks without or with only solid states in use keep no rows.
+// Built on demand for the revision of the chunk it was built from, VoxelCollision rebuilds it once the chunk's revision moved on.
+class ChunkOccupancy
+{
+public:
+	static constexpr std::size_t Size = 32;
+
+public:
+	void build(const ChunkStorage& voxels, const BlockStateTable& blockStates, std::uint64_t revision);
+
+	void invalidate() { m_Revision = ~0ULL; }
+	bool isCurrent(std::uint64_t revision) const { return m_Revision == revision; }
+
+	// Whether a voxel from first to last inclusive is solid, local coordinates below Size.
+	bool any(const std::uint32_t (&first)[3], const std::uint32_t (&last)[3]) const;
+
+	auto getKind() const { return m_Kind; }
+
+private:
+	std::uint64_t                                            m_Revision = ~0ULL;
+	EOccupancy                                               m_Kind     = EOccupancy::Empty;
+	std::array<std::uint32_t, Size>                          m_Layers {}; // Bit y of layer z if row y, z has a solid voxel
+	std::vector<std::uint32_t, SlabAllocator<std::uint32_t>> m_Rows;      // Bit x of row y + z * Size, Mixed only
+};
@@ -0,0 +1,104 @@
+#include "ChunkSnapshot.h"
+#include "Dimension.h"
+
+#include <algorithm>
+
+ChunkSnapshot& ChunkSnapshot::ThreadLocal()
+{
+	thread_local ChunkSnapshot s_Snapshot;
+	return s_Snapshot;
+}
+
+ChunkSnapshot::ChunkSnapshot()
+    : m_Voxels(VoxelCount, Chunk::EmptyState) {}
+
+void ChunkSnapshot::capture(const std::array<const Chunk*, NeighbourCount>& chunks)
+{
+	std::array<const ChunkStorage*, NeighbourCount> voxels;
+	for (std::size_t i = 0; i < NeighbourCount; ++i)
+		voxels[i] = chunks[i] ? &chunks[i]->getVoxels() : nullptr;
+	capture(voxels, chunks[CenterNeighbour]->getRevision());
+}
+
+void ChunkSnapshot::capture(const std::array<const ChunkStorage*, NeighbourCount>& voxels, std::uint64_t revision)
+{
+	constexpr std::int32_t Last = static_cast<std::int32_t>(Chunk::Size) - 1;
+
+	m_Revision = revision;
+	for (std::int32_t dz = -1; dz <= 1; ++dz)
+	{
+		for (std::int32_t dy = -1; dy <= 1; ++dy)
+		{
+			for (std::int32_t dx = -1; dx <= 1; ++dx)
+			{
+				// Only the layer of a neighbour touching the chunk is copied, its last layer for negative offsets and its first for positive ones.
+				std::int32_t offset[3] { dx, dy, dz };
+				std::int32_t from[3];
+				std::int32_t to[3];
+				for (std::uint32_t a = 0; a < 3; ++a)
+				{
+					from[a] = offset[a] < 0 ? Last : 0;
+					to[a]   = offset[a] > 0 ? 0 : Last;
+				}
+				copyBox(voxels[NeighbourIndex(dx, dy, dz)], offset, from, to);
+			}
+		}
+	}
+}
+
+void ChunkSnapshot::capture(const Chunk& chunk, const std::array<const Chunk*, FaceCount>& neighbours)
+{
+	std::array<const Chunk*, NeighbourCount> chunks {};
+	chunks[CenterNeighbour] = &chunk;
+	for (std::uint32_t i = 0; i < FaceCount; ++i)
+		chunks[FaceNeighbourIndex(static_cast<EFace>(i))] = neighbours[i];
+	capture(chunks);
+}
+
+void ChunkSnapshot::capture(const ChunkStorage& voxels, const std::array<const ChunkStorage*, FaceCount>& neighbours, std::uint64_t revision)
+{
+	std::array<const ChunkStorage*, NeighbourCount> storages {};
+	storages[CenterNeighbour] = &voxels;
+	for (std::uint32_t i = 0; i < FaceCount; ++i)
+		storages[FaceNeighbourIndex(static_cast<EFace>(i))] = neighbours[i];
+	capture(storages, revision);
+}
+
+void ChunkSnapshot::capture(const Dimension& dimension, const Chunk& chunk)
+{
+	ChunkCoord                               coord = chunk.getCoord();
+	std::array<const Chunk*, NeighbourCount> chunks;
+	for (std::int32_t dz = -1; dz <= 1; ++dz)
+		for (std::int32_t dy = -1; dy <= 1; ++dy)
+			for (std::int32_t dx = -1; dx <= 1; ++dx)
+				chunks[NeighbourIndex(dx, dy, dz)] = dimension.getChunk(coord.offset(dx, dy, dz));
+	chunks[CenterNeighbour] = &chunk;
+	capture(chunks);
+}
+
+void ChunkSnapshot::copyBox(const ChunkStorage* source, const std::int32_t (&offset)[3], const std::int32_t (&from)[3], const std::int32_t (&to)[3])
+{
+	constexpr std::int32_t ChunkSize = static_cast<std::int32_t>(Chunk::Size);
+
+	std::int32_t width = to[0] - from[0] + 1;
+	for (std::int32_t z = from[2]; z <= to[2]; ++z)
+	{
+		for (std::int32_t y = from[1]; y <= to[1]; ++y)
+		{
+			std::uint64_t* row = m_Voxels.data() + PositionToIndex(from[0] + offset[0] * ChunkSize, y + offset[1] * ChunkSize, z + offset[2] * ChunkSize);
+			if (!source)
+			{
+				std::fill_n(row, width, Chunk::EmptyState);
+				continue;
+			}
+
+			// Whole rows are unpacked straight into the grid, single voxels of the x neighbours go through get().
+			auto&       voxels = *source;
+			std::size_t index  = Chunk::PositionToIndex(static_cast<std::uint32_t>(from[0]), static_cast<std::uint32_t>(y), static_cast<std::uint32_t>(z));
+			if (width == 1)
+				*row = voxels.get(index);
+			else
+				voxels.decode(index, static_cast<std::size_t>(width), row);
+		}
+	}
+}
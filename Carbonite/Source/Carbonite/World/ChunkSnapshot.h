@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Chunk.h"
+#include "ChunkCoord.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <vector>
+
+class Dimension;
+
+// A chunk's voxels plus a one voxel border taken from its 26 neighbours, decoded into one contiguous 34^3 grid.
+// Kernels that look at adjacent voxels (meshing, occlusion, lighting) can read (x + dx, y + dy, z + dz) for any voxel of the
+// chunk without checking whether it lies in a neighbour. Missing neighbours read as Chunk::EmptyState.
+// capture() only reads the chunks, take it where the chunks are not being edited (the thread that owns them, or copies of
+// them), the snapshot itself can then be handed to any thread.
+class ChunkSnapshot
+{
+public:
+	static constexpr std::int32_t  Size            = static_cast<std::int32_t>(Chunk::Size) + 2;
+	static constexpr std::size_t   VoxelCount      = static_cast<std::size_t>(Size * Size * Size);
+	static constexpr std::size_t   NeighbourCount  = 27;
+	static constexpr std::uint32_t CenterNeighbour = 13;
+
+	// Position relative to the chunk, every axis in [-1, Chunk::Size].
+	static constexpr std::size_t PositionToIndex(std::int32_t x, std::int32_t y, std::int32_t z)
+	{
+		return static_cast<std::size_t>((x + 1) + (y + 1) * Size + (z + 1) * Size * Size);
+	}
+	// Neighbours are indexed by offset, (dx + 1) + (dy + 1) * 3 + (dz + 1) * 9 for offsets in [-1, 1].
+	static constexpr std::uint32_t NeighbourIndex(std::int32_t dx, std::int32_t dy, std::int32_t dz)
+	{
+		return static_cast<std::uint32_t>((dx + 1) + (dy + 1) * 3 + (dz + 1) * 9);
+	}
+	static constexpr std::uint32_t FaceNeighbourIndex(EFace face)
+	{
+		std::int32_t offset[3] { 0, 0, 0 };
+		offset[getFaceAxis(face)] = isPositiveFace(face) ? 1 : -1;
+		return NeighbourIndex(offset[0], offset[1], offset[2]);
+	}
+
+	// Scratch snapshot of the calling thread, for kernels that do not keep their own.
+	static ChunkSnapshot& ThreadLocal();
+
+public:
+	ChunkSnapshot();
+
+	// chunks[CenterNeighbour] is the chunk itself and must not be nullptr.
+	void capture(const std::array<const Chunk*, NeighbourCount>& chunks);
+	// Face neighbours only, the edges and corners of the border read as empty.
+	void capture(const Chunk& chunk, const std::array<const Chunk*, FaceCount>& neighbours);
+	void capture(const Dimension& dimension, const Chunk& chunk);
+	// Same as above from voxel storages alone, e.g. copy on write copies of chunks taken on another thread.
+	void capture(const std::array<const ChunkStorage*, NeighbourCount>& voxels, std::uint64_t revision);
+	void capture(const ChunkStorage& voxels, const std::array<const ChunkStorage*, FaceCount>& neighbours, std::uint64_t revision);
+
+	std::uint64_t get(std::int32_t x, std::int32_t y, std::int32_t z) const { return m_Voxels[PositionToIndex(x, y, z)]; }
+
+	// Rows along x are contiguous, the border voxels of a row sit right before and after it.
+	const std::uint64_t* getRow(std::int32_t y, std::int32_t z) const { return m_Voxels.data() + PositionToIndex(0, y, z); }
+
+	auto& getVoxels() const { return m_Voxels; }
+	// Revision of the center chunk when it was captured.
+	auto  getRevision() const { return m_Revision; }
+
+private:
+	// Copies the voxels of source in [from, to] (source coordinates) to the same box shifted by offset chunk sizes.
+	void copyBox(const ChunkStorage* source, const std::int32_t (&offset)[3], const std::int32_t (&from)[3], const std::int32_t (&to)[3]);
+
+private:
+	std::vector<std::uint64_t> m_Voxels;
+	std::uint64_t              m_Revision = 0;
+};
@@ -0,0 +1,430 @@
+#include "ChunkStorage.h"
+#include "VoxelKernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+	std::uint64_t HashWords(const std::uint64_t* words, std::size_t count, std::uint64_t hash)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			hash = std::rotl((hash ^ words[i]) * 0x87C3'7B91'1142'53D5ULL, 31);
+		return hash;
+	}
+} // namespace
+
+struct ChunkStorage::SharedBlocks
+{
+public:
+	std::mutex                                                  m_Mutex;
+	std::unordered_map<std::uint64_t, std::shared_ptr<Data>>    m_Uniform; // By state
+	std::unordered_multimap<std::uint64_t, std::weak_ptr<Data>> m_Blocks;  // By content hash, expired entries are swept lazily
+	std::size_t                                                 m_Swept  = 0;
+	std::uint64_t                                               m_Shares = 0;
+};
+
+std::uint32_t ChunkStorage::BitsForPaletteSize(std::size_t paletteSize)
+{
+	std::uint32_t bits = 0;
+	while ((1ULL << bits) < paletteSize)
+		bits = bits == 0 ? 1 : bits * 2;
+	return bits;
+}
+
+ChunkSharingStats ChunkStorage::GetSharingStats()
+{
+	SharedBlocks&               shared = GetSharedBlocks();
+	std::lock_guard<std::mutex> lock(shared.m_Mutex);
+
+	ChunkSharingStats stats;
+	stats.m_UniformBlocks = shared.m_Uniform.size();
+	stats.m_Shares        = shared.m_Shares;
+	for (auto& [state, block] : shared.m_Uniform)
+		stats.m_SharedMemoryUsage += sizeof(Data) + block->m_Palette.capacity() * sizeof(std::uint64_t);
+	for (auto& [hash, entry] : shared.m_Blocks)
+	{
+		if (auto block = entry.lock())
+		{
+			++stats.m_SharedBlocks;
+			stats.m_SharedMemoryUsage += sizeof(Data) + block->m_Palette.capacity() * sizeof(std::uint64_t) + block->m_Words.capacity() * sizeof(std::uint64_t);
+		}
+	}
+	return stats;
+}
+
+ChunkStorage::ChunkStorage(std::uint64_t state)
+    : m_Data(Uniform(state)) {}
+
+void ChunkStorage::set(std::size_t index, std::uint64_t state)
+{
+	if (m_Data->m_Bits == 0 && m_Data->m_Palette[0] == state)
+		return;
+
+	std::uint32_t paletteIndex = findOrAddState(state);
+	SetPaletteIndex(*m_Data, index, paletteIndex);
+}
+
+void ChunkStorage::fillRun(std::size_t index, std::size_t count, std::uint64_t state)
+{
+	if (count == 0 || (m_Data->m_Bits == 0 && m_Data->m_Palette[0] == state))
+		return;
+	if (count == VoxelCount)
+	{
+		fill(state);
+		return;
+	}
+
+	std::uint32_t paletteIndex   = findOrAddState(state);
+	Data&         data           = *m_Data;
+	std::size_t   indicesPerWord = 64 / data.m_Bits;
+	std::size_t   end            = index + count;
+	std::uint64_t pattern        = paletteIndex * (~0ULL / ((1ULL << data.m_Bits) - 1));
+
+	for (; index < end && index % indicesPerWord != 0; ++index)
+		SetPaletteIndex(data, index, paletteIndex);
+	for (; index + indicesPerWord <= end; index += indicesPerWord)
+		data.m_Words[index / indicesPerWord] = pattern;
+	for (; index < end; ++index)
+		SetPaletteIndex(data, index, paletteIndex);
+}
+
+void ChunkStorage::decode(std::size_t index, std::size_t count, std::uint64_t* out) const
+{
+	const Data& data = *m_Data;
+	if (data.m_Bits == 0)
+	{
+		std::fill_n(out, count, data.m_Palette[0]);
+		return;
+	}
+
+	std::size_t          indicesPerWord = 64 / data.m_Bits;
+	std::uint64_t        mask           = (1ULL << data.m_Bits) - 1;
+	const std::uint64_t* word           = data.m_Words.data() + index / indicesPerWord;
+	std::size_t          left           = indicesPerWord - index % indicesPerWord;
+	std::uint64_t        bits           = *word >> ((index % indicesPerWord) * data.m_Bits);
+	for (std::size_t i = 0; i < count; ++i, --left, bits >>= data.m_Bits)
+	{
+		if (left == 0)
+		{
+			bits = *++word;
+			left = indicesPerWord;
+		}
+		out[i] = data.m_Palette[static_cast<std::size_t>(bits & mask)];
+	}
+}
+
+std::size_t ChunkStorage::count(std::uint64_t state) const
+{
+	const Data& data = *m_Data;
+	auto        itr  = std::find(data.m_Palette.begin(), data.m_Palette.end(), state);
+	if (itr == data.m_Palette.end())
+		return 0;
+	if (data.m_Bits == 0)
+		return VoxelCount;
+
+	// Stale palette entries may hold the same state twice.
+	std::size_t total = 0;
+	for (; itr != data.m_Palette.end(); itr = std::find(itr + 1, data.m_Palette.end(), state))
+		total += VoxelKernels::count(data.m_Words.data(), data.m_Words.size(), data.m_Bits, static_cast<std::uint32_t>(itr - data.m_Palette.begin()));
+	return total;
+}
+
+std::size_t ChunkStorage::findFirst(std::uint64_t state) const
+{
+	const Data& data  = *m_Data;
+	std::size_t first = VoxelCount;
+	for (auto itr = std::find(data.m_Palette.begin(), data.m_Palette.end(), state); itr != data.m_Palette.end(); itr = std::find(itr + 1, data.m_Palette.end(), state))
+	{
+		if (data.m_Bits == 0)
+			return 0;
+		first = std::min(first, VoxelKernels::findFirst(data.m_Words.data(), data.m_Words.size(), data.m_Bits, static_cast<std::uint32_t>(itr - data.m_Palette.begin())));
+	}
+	return first;
+}
+
+std::size_t ChunkStorage::replace(std::uint64_t from, std::uint64_t to)
+{
+	if (from == to)
+		return count(from);
+	if (std::find(m_Data->m_Palette.begin(), m_Data->m_Palette.end(), from) == m_Data->m_Palette.end())
+		return 0;
+
+	Data&       data    = edit();
+	std::size_t changed = 0;
+	auto        target  = std::find(data.m_Palette.begin(), data.m_Palette.end(), to);
+	for (std::size_t i = 0; i < data.m_Palette.size(); ++i)
+	{
+		if (data.m_Palette[i] != from)
+			continue;
+		if (data.m_Bits == 0)
+		{
+			data.m_Palette[0] = to;
+			return VoxelCount;
+		}
+
+		// Renaming the palette entry is enough unless to already has one, then the indices are merged into that.
+		if (target == data.m_Palette.end())
+		{
+			changed += VoxelKernels::count(data.m_Words.data(), data.m_Words.size(), data.m_Bits, static_cast<std::uint32_t>(i));
+			data.m_Palette[i] = to;
+			target            = data.m_Palette.begin() + static_cast<std::ptrdiff_t>(i);
+		}
+		else
+		{
+			changed += VoxelKernels::replace(data.m_Words.data(), data.m_Words.size(), data.m_Bits, static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(target - data.m_Palette.begin()));
+		}
+	}
+	return changed;
+}
+
+void ChunkStorage::histogram(std::vector<std::uint32_t>& counts) const
+{
+	const Data& data = *m_Data;
+	counts.resize(data.m_Palette.size());
+	if (data.m_Bits == 0)
+		counts[0] = static_cast<std::uint32_t>(VoxelCount);
+	else
+		VoxelKernels::histogram(data.m_Words.data(), data.m_Words.size(), data.m_Bits, counts.data(), counts.size());
+}
+
+void ChunkStorage::fill(std::uint64_t state)
+{
+	// Nothing of the old voxels survives, so the storage simply moves over to the uniform block.
+	m_Data = Uniform(state);
+}
+
+void ChunkStorage::assign(std::vector<std::uint64_t>&& palette, Words&& words)
+{
+	auto data       = std::make_shared<Data>();
+	data->m_Palette = std::move(palette);
+	data->m_Words   = std::move(words);
+	data->m_Bits    = BitsForPaletteSize(data->m_Palette.size());
+	m_Data          = std::move(data);
+}
+
+void ChunkStorage::compact()
+{
+	const Data& current = *m_Data;
+	if (current.m_Bits == 0)
+		return;
+
+	std::uint32_t              indicesPerWord = 64 / current.m_Bits;
+	std::uint64_t              mask           = (1ULL << current.m_Bits) - 1;
+	std::vector<std::uint32_t> remap;
+	histogram(remap);
+
+	std::vector<std::uint64_t> palette;
+	for (std::size_t i = 0; i < current.m_Palette.size(); ++i)
+	{
+		if (remap[i])
+		{
+			remap[i] = static_cast<std::uint32_t>(palette.size());
+			palette.push_back(current.m_Palette[i]);
+		}
+	}
+
+	if (palette.size() == current.m_Palette.size())
+		return;
+
+	std::uint32_t bits = BitsForPaletteSize(palette.size());
+	if (bits == 0)
+	{
+		fill(palette[0]);
+		return;
+	}
+
+	Words         words(VoxelCount / (64 / bits), 0);
+	std::uint32_t newIndicesPerWord = 64 / bits;
+	std::size_t   index             = 0;
+	for (std::uint64_t word : current.m_Words)
+	{
+		for (std::uint32_t i = 0; i < indicesPerWord; ++i, ++index, word >>= current.m_Bits)
+			words[index / newIndicesPerWord] |= static_cast<std::uint64_t>(remap[static_cast<std::size_t>(word & mask)]) << ((index % newIndicesPerWord) * bits);
+	}
+
+	// Both arrays are rebuilt anyway, so this never copies the shared ones first.
+	assign(std::move(palette), std::move(words));
+}
+
+void ChunkStorage::share()
+{
+	if (m_Data->m_Shared)
+		return;
+	if (m_Data->m_Bits == 0)
+	{
+		m_Data = Uniform(m_Data->m_Palette[0]);
+		return;
+	}
+	// Copies may be read by other threads, which must not see the block turn shared under them.
+	if (m_Data.use_count() != 1)
+		return;
+
+	const Data&   data = *m_Data;
+	std::uint64_t hash = HashWords(data.m_Palette.data(), data.m_Palette.size(), data.m_Bits);
+	hash               = HashWords(data.m_Words.data(), data.m_Words.size(), hash);
+
+	SharedBlocks&               shared = GetSharedBlocks();
+	std::lock_guard<std::mutex> lock(shared.m_Mutex);
+	auto [begin, end] = shared.m_Blocks.equal_range(hash);
+	for (auto itr = begin; itr != end; ++itr)
+	{
+		auto block = itr->second.lock();
+		if (block && block->m_Bits == data.m_Bits && block->m_Palette == data.m_Palette && block->m_Words == data.m_Words)
+		{
+			m_Data = std::move(block);
+			++shared.m_Shares;
+			return;
+		}
+	}
+
+	// Expired entries are dropped whenever the table doubled since the last sweep.
+	if (shared.m_Blocks.size() >= 2 * shared.m_Swept + 64)
+	{
+		std::erase_if(shared.m_Blocks, [](auto& entry) { return entry.second.expired(); });
+		shared.m_Swept = shared.m_Blocks.size();
+	}
+	m_Data->m_Shared = true;
+	shared.m_Blocks.emplace(hash, m_Data);
+}
+
+std::size_t ChunkStorage::getMemoryUsage() const
+{
+	if (m_Data->m_Shared)
+		return sizeof(*this);
+	return sizeof(*this) + sizeof(Data) + m_Data->m_Palette.capacity() * sizeof(std::uint64_t) + m_Data->m_Words.capacity() * sizeof(std::uint64_t);
+}
+
+void ChunkStorage::serialize(std::vector<std::uint8_t>& data) const
+{
+	const Data&   current     = *m_Data;
+	std::uint32_t paletteSize = static_cast<std::uint32_t>(current.m_Palette.size());
+	std::size_t   offset      = data.size();
+	data.resize(offset + 1 + sizeof(paletteSize) + current.m_Palette.size() * sizeof(std::uint64_t) + current.m_Words.size() * sizeof(std::uint64_t));
+
+	std::uint8_t* out = data.data() + offset;
+	*out++            = static_cast<std::uint8_t>(current.m_Bits);
+	std::memcpy(out, &paletteSize, sizeof(paletteSize));
+	out += sizeof(paletteSize);
+	std::memcpy(out, current.m_Palette.data(), current.m_Palette.size() * sizeof(std::uint64_t));
+	out += current.m_Palette.size() * sizeof(std::uint64_t);
+	if (!current.m_Words.empty())
+		std::memcpy(out, current.m_Words.data(), current.m_Words.size() * sizeof(std::uint64_t));
+}
+
+bool ChunkStorage::deserialize(const std::uint8_t* data, std::size_t size)
+{
+	std::uint32_t paletteSize;
+	if (size < 1 + sizeof(paletteSize))
+		return false;
+
+	std::uint32_t bits = data[0];
+	std::memcpy(&paletteSize, data + 1, sizeof(paletteSize));
+	if ((bits != 0 && bits != 1 && bits != 2 && bits != 4 && bits != 8 && bits != 16) || paletteSize == 0 || paletteSize > (1ULL << bits))
+		return false;
+
+	std::size_t wordCount = bits == 0 ? 0 : VoxelCount / (64 / bits);
+	if (size != 1 + sizeof(paletteSize) + (paletteSize + wordCount) * sizeof(std::uint64_t))
+		return false;
+
+	const std::uint8_t*        in = data + 1 + sizeof(paletteSize);
+	std::vector<std::uint64_t> palette(paletteSize);
+	std::memcpy(palette.data(), in, paletteSize * sizeof(std::uint64_t));
+	in += paletteSize * sizeof(std::uint64_t);
+	Words                      words(wordCount);
+	if (wordCount)
+		std::memcpy(words.data(), in, wordCount * sizeof(std::uint64_t));
+	assign(std::move(palette), std::move(words));
+	m_Data->m_Bits = bits;
+
+	// Indices pointing outside the palette would read out of bounds later on.
+	for (std::size_t i = 0; i < VoxelCount && bits != 0; ++i)
+	{
+		if (getPaletteIndex(i) >= paletteSize)
+		{
+			fill(DefaultState);
+			return false;
+		}
+	}
+	return true;
+}
+
+ChunkStorage::Data& ChunkStorage::edit()
+{
+	// Only the owning thread creates new references to private voxels, so a count of one cannot go up behind our back.
+	// The fence orders our writes after the reads other threads made before dropping their reference.
+	if (m_Data->m_Shared || m_Data.use_count() != 1)
+	{
+		auto data      = std::make_shared<Data>(*m_Data);
+		data->m_Shared = false;
+		m_Data         = std::move(data);
+	}
+	else
+	{
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+	return *m_Data;
+}
+
+ChunkStorage::SharedBlocks& ChunkStorage::GetSharedBlocks()
+{
+	static SharedBlocks s_Blocks;
+	return s_Blocks;
+}
+
+std::shared_ptr<ChunkStorage::Data> ChunkStorage::Uniform(std::uint64_t state)
+{
+	// Nearly every storage starts out as air, the last block of each thread skips the lock.
+	thread_local std::shared_ptr<Data> s_Last;
+	if (s_Last && s_Last->m_Palette[0] == state)
+		return s_Last;
+
+	SharedBlocks&               shared = GetSharedBlocks();
+	std::lock_guard<std::mutex> lock(shared.m_Mutex);
+	auto&                       block = shared.m_Uniform[state];
+	if (!block)
+	{
+		block = std::make_shared<Data>();
+		block->m_Palette.push_back(state);
+		block->m_Shared = true;
+	}
+	s_Last = block;
+	return block;
+}
+
+std::uint32_t ChunkStorage::findOrAddState(std::uint64_t state)
+{
+	Data& data = edit();
+	auto  itr  = std::find(data.m_Palette.begin(), data.m_Palette.end(), state);
+	if (itr != data.m_Palette.end())
+		return static_cast<std::uint32_t>(itr - data.m_Palette.begin());
+
+	// Unused entries pile up when voxels get overwritten, drop them before the palette overflows.
+	// compact() replaces the data, so start over on the new one.
+	if (data.m_Palette.size() == MaxPalette)
+	{
+		compact();
+		if (m_Data->m_Palette.size() != MaxPalette)
+			return findOrAddState(state);
+	}
+
+	data.m_Palette.push_back(state);
+	if (data.m_Palette.size() > (1ULL << data.m_Bits))
+		resize(data, BitsForPaletteSize(data.m_Palette.size()));
+	return static_cast<std::uint32_t>(data.m_Palette.size() - 1);
+}
+
+void ChunkStorage::resize(Data& data, std::uint32_t bits)
+{
+	Words         words(VoxelCount / (64 / bits), 0);
+	std::uint32_t indicesPerWord = 64 / bits;
+	for (std::size_t i = 0; i < VoxelCount; ++i)
+		words[i / indicesPerWord] |= static_cast<std::uint64_t>(getPaletteIndex(i)) << ((i % indicesPerWord) * bits);
+
+	data.m_Words = std::move(words);
+	data.m_Bits  = bits;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Utils/SlabAllocator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+struct ChunkSharingStats
+{
+public:
+	std::size_t   m_UniformBlocks     = 0; // One per state a uniform storage was created with, kept forever
+	std::size_t   m_SharedBlocks      = 0; // Live non-uniform blocks
+	std::size_t   m_SharedMemoryUsage = 0; // Bytes of every shared block, counted once
+	std::uint64_t m_Shares            = 0; // share() calls that found an identical block
+};
+
+// Palette compressed voxel storage.
+// Every voxel stores an index into a per chunk palette of block state ids, the indices are bit packed into 64 bit words.
+// The index width widens from 0 bits (the whole chunk is one state) to 16 bits as unique states are added.
+// Widths are always powers of two so an index never straddles two words.
+// Copies are copy on write: they share the palette and words until either side is modified, so taking a snapshot of a
+// chunk for another thread costs one reference count. Only one thread may modify a storage, copies held by other threads
+// can be read and dropped at any time.
+// Uniform storages and storages passed through share() point at immutable blocks shared by every storage with the same
+// voxels, keyed by content hash. The first modification gives the storage a private copy again.
+class ChunkStorage
+{
+public:
+	static constexpr std::size_t   VoxelCount   = 32 * 32 * 32;
+	static constexpr std::uint32_t MaxBits      = 16;
+	static constexpr std::size_t   MaxPalette   = 1ULL << MaxBits;
+	static constexpr std::uint64_t DefaultState = ~0ULL;
+
+	// Packed indices are 4 to 64 KiB, they come from the slab arenas so chunk churn doesn't fragment the heap.
+	using Words = std::vector<std::uint64_t, SlabAllocator<std::uint64_t>>;
+
+public:
+	// Smallest supported index width able to address paletteSize entries.
+	static std::uint32_t BitsForPaletteSize(std::size_t paletteSize);
+
+	static ChunkSharingStats GetSharingStats();
+
+public:
+	ChunkStorage(std::uint64_t state = DefaultState);
+
+	std::uint64_t get(std::size_t index) const
+	{
+		return m_Data->m_Bits == 0 ? m_Data->m_Palette[0] : m_Data->m_Palette[getPaletteIndex(index)];
+	}
+
+	void set(std::size_t index, std::uint64_t state);
+	// Sets count voxels starting at index, whole words are written at once.
+	void fillRun(std::size_t index, std::size_t count, std::uint64_t state);
+	void fill(std::uint64_t state);
+	// Takes over already packed indices, words must hold VoxelCount indices BitsForPaletteSize(palette.size()) bits wide.
+	void assign(std::vector<std::uint64_t>&& palette, Words&& words);
+
+	// Removes palette entries no voxel references anymore and narrows the index width if possible.
+	void compact();
+	// Points the storage at the shared block holding the same voxels, or publishes its own voxels as that block.
+	// Voxels only match with the same palette order, so compact() first. Storages still shared with a copy stay as they are.
+	void share();
+
+	// Calls func(index, state) for every voxel in index order, decoding a whole word at a time.
+	template <class F>
+	void forEach(F&& func) const
+	{
+		const Data& data = *m_Data;
+		if (data.m_Bits == 0)
+		{
+			std::uint64_t state = data.m_Palette[0];
+			for (std::size_t i = 0; i < VoxelCount; ++i)
+				func(i, state);
+			return;
+		}
+
+		std::uint32_t indicesPerWord = 64 / data.m_Bits;
+		std::uint64_t mask           = (1ULL << data.m_Bits) - 1;
+		std::size_t   index          = 0;
+		for (std::uint64_t word : data.m_Words)
+		{
+			for (std::uint32_t i = 0; i < indicesPerWord; ++i, ++index, word >>= data.m_Bits)
+				func(index, data.m_Palette[static_cast<std::size_t>(word & mask)]);
+		}
+	}
+
+	// Writes the states of count voxels starting at index to out, unpacking one word at a time.
+	void decode(std::size_t index, std::size_t count, std::uint64_t* out) const;
+
+	// Bulk queries run on the packed indices with the VoxelKernels, the state is looked up in the palette once.
+	std::size_t count(std::uint64_t state) const;
+	// Index of the first voxel of state, VoxelCount if there is none.
+	std::size_t findFirst(std::uint64_t state) const;
+	bool        contains(std::uint64_t state) const { return findFirst(state) != VoxelCount; }
+	bool        isFilledWith(std::uint64_t state) const { return count(state) == VoxelCount; }
+	// Turns every voxel of state from into to, returns how many voxels changed.
+	std::size_t replace(std::uint64_t from, std::uint64_t to);
+	// counts[i] is set to the number of voxels using palette entry i, entries no voxel uses anymore count 0.
+	void        histogram(std::vector<std::uint32_t>& counts) const;
+
+	bool  isUniform() const { return m_Data->m_Bits == 0; }
+	auto  getBitsPerIndex() const { return m_Data->m_Bits; }
+	auto& getPalette() const { return std::as_const(m_Data->m_Palette); }
+	auto& getWords() const { return std::as_const(m_Data->m_Words); }
+	// Whether both storages still share their voxels, i.e. neither was modified since one was copied from the other.
+	bool  isSharedWith(const ChunkStorage& other) const { return m_Data == other.m_Data; }
+	// Whether the voxels are an immutable block from share() or a uniform one.
+	bool  isShared() const { return m_Data->m_Shared; }
+
+	// Shared blocks are not included, GetSharingStats() counts each of them once.
+	std::size_t getMemoryUsage() const;
+
+	// Appends the palette and packed indices to data, deserialize() returns false on malformed input.
+	void serialize(std::vector<std::uint8_t>& data) const;
+	bool deserialize(const std::uint8_t* data, std::size_t size);
+
+	std::uint32_t getPaletteIndex(std::size_t index) const
+	{
+		const Data& data = *m_Data;
+		if (data.m_Bits == 0)
+			return 0;
+		std::uint32_t shift = static_cast<std::uint32_t>((index & (64 / data.m_Bits - 1)) * data.m_Bits);
+		return static_cast<std::uint32_t>((data.m_Words[index / (64 / data.m_Bits)] >> shift) & ((1ULL << data.m_Bits) - 1));
+	}
+
+private:
+	struct Data
+	{
+	public:
+		std::vector<std::uint64_t> m_Palette;
+		Words                      m_Words;
+		std::uint32_t              m_Bits   = 0;
+		bool                       m_Shared = false; // Set before the block is published, never cleared
+	};
+
+	struct SharedBlocks;
+
+	static SharedBlocks&         GetSharedBlocks();
+	static std::shared_ptr<Data> Uniform(std::uint64_t state);
+
+	static void SetPaletteIndex(Data& data, std::size_t index, std::uint32_t paletteIndex)
+	{
+		std::uint32_t  shift = static_cast<std::uint32_t>((index & (64 / data.m_Bits - 1)) * data.m_Bits);
+		std::uint64_t  mask  = ((1ULL << data.m_Bits) - 1) << shift;
+		std::uint64_t& word  = data.m_Words[index / (64 / data.m_Bits)];
+		word                 = (word & ~mask) | (static_cast<std::uint64_t>(paletteIndex) << shift);
+	}
+
+	// Gives this storage its own copy of the voxels if a copy or a shared block uses them, every modification goes through here.
+	Data& edit();
+
+	// Makes the data private as well, callers must only take *m_Data afterwards.
+	std::uint32_t findOrAddState(std::uint64_t state);
+	void          resize(Data& data, std::uint32_t bits);
+
+private:
+	std::shared_ptr<Data> m_Data;
+};
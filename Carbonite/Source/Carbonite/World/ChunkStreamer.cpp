@@ -0,0 +1,159 @@
+#include "ChunkStreamer.h"
+#include "Dimension.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_set>
+
+void ChunkStreamer::update(Dimension& dimension, const std::vector<glm::fvec3>& focuses)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	m_Stats.m_Loads   = 0;
+	m_Stats.m_Unloads = 0;
+
+	// Without a camera there is nothing to follow, leave the chunks to whoever loaded them.
+	if (focuses.empty())
+		return;
+
+	std::vector<ChunkCoord> focusChunks;
+	focusChunks.reserve(focuses.size());
+	for (auto& focus : focuses)
+	{
+		focusChunks.push_back({ static_cast<std::int64_t>(std::floor(focus.x / Chunk::Size)),
+		                        static_cast<std::int64_t>(std::floor(focus.y / Chunk::Size)),
+		                        static_cast<std::int64_t>(std::floor(focus.z / Chunk::Size)) });
+	}
+
+	// Chunks loaded or unloaded behind our back also invalidate the queues.
+	if (focusChunks != m_Focuses || dimension.getLoadedChunkCount() != m_KnownChunkCount)
+	{
+		m_Focuses = std::move(focusChunks);
+		m_Dirty   = true;
+	}
+	if (m_Dirty)
+	{
+		rebuildQueues(dimension);
+		m_Dirty = false;
+		++m_Stats.m_Rebuilds;
+	}
+
+	// Always do at least one operation so a tiny budget still makes progress.
+	auto withinBudget = [&]() {
+		if (m_Stats.m_Loads + m_Stats.m_Unloads == 0)
+			return true;
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() < m_FrameBudget;
+	};
+
+	// Unload first so memory use does not overshoot while moving.
+	while (!m_UnloadQueue.empty() && withinBudget())
+	{
+		ChunkCoord coord = m_UnloadQueue.back();
+		m_UnloadQueue.pop_back();
+		if (dimension.unloadChunk(coord))
+			++m_Stats.m_Unloads;
+	}
+
+	while (!m_LoadQueue.empty() && withinBudget())
+	{
+		std::pop_heap(m_LoadQueue.begin(), m_LoadQueue.end());
+		ChunkCoord coord = m_LoadQueue.back().m_Coord;
+		m_LoadQueue.pop_back();
+		if (dimension.getChunk(coord))
+			continue;
+
+		bool restored = false;
+		dimension.loadChunk(coord, &restored);
+		++m_Stats.m_Loads;
+		if (restored)
+			++m_Stats.m_TotalRestored;
+	}
+
+	m_KnownChunkCount = dimension.getLoadedChunkCount();
+
+	m_Stats.m_PendingLoads   = m_LoadQueue.size();
+	m_Stats.m_PendingUnloads = m_UnloadQueue.size();
+	m_Stats.m_TotalLoads += m_Stats.m_Loads;
+	m_Stats.m_TotalUnloads += m_Stats.m_Unloads;
+	m_Stats.m_UpdateMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ChunkStreamer::setRadius(std::int64_t radius, std::int64_t verticalRadius)
+{
+	m_Radius         = std::max<std::int64_t>(radius, 0);
+	m_VerticalRadius = std::max<std::int64_t>(verticalRadius, 0);
+	m_Dirty          = true;
+}
+
+void ChunkStreamer::setHysteresis(std::int64_t hysteresis)
+{
+	m_Hysteresis = std::max<std::int64_t>(hysteresis, 0);
+	m_Dirty      = true;
+}
+
+void ChunkStreamer::rebuildQueues(const Dimension& dimension)
+{
+	m_LoadQueue.clear();
+	m_UnloadQueue.clear();
+
+	std::unordered_set<ChunkCoord, ChunkCoordHash> queued;
+	for (auto& focus : m_Focuses)
+	{
+		for (std::int64_t z = -m_VerticalRadius; z <= m_VerticalRadius; ++z)
+		{
+			for (std::int64_t y = -m_Radius; y <= m_Radius; ++y)
+			{
+				for (std::int64_t x = -m_Radius; x <= m_Radius; ++x)
+				{
+					if (x * x + y * y > m_Radius * m_Radius)
+						continue;
+
+					ChunkCoord coord = focus.offset(x, y, z);
+					if (dimension.getChunk(coord) || !queued.insert(coord).second)
+						continue;
+					m_LoadQueue.push_back({ distanceSquared(coord), coord });
+				}
+			}
+		}
+	}
+	std::make_heap(m_LoadQueue.begin(), m_LoadQueue.end());
+
+	std::vector<QueueEntry> unloads;
+	dimension.forEachChunk([this, &unloads](const Chunk& chunk) {
+		if (!isInRange(chunk.getCoord(), m_Hysteresis))
+			unloads.push_back({ distanceSquared(chunk.getCoord()), chunk.getCoord() });
+	});
+	std::sort(unloads.begin(), unloads.end(), [](const QueueEntry& lhs, const QueueEntry& rhs) { return lhs.m_DistanceSquared < rhs.m_DistanceSquared; });
+	m_UnloadQueue.reserve(unloads.size());
+	for (auto& entry : unloads)
+		m_UnloadQueue.push_back(entry.m_Coord);
+}
+
+bool ChunkStreamer::isInRange(const ChunkCoord& coord, std::int64_t margin) const
+{
+	std::int64_t radius         = m_Radius + margin;
+	std::int64_t verticalRadius = m_VerticalRadius + margin;
+	for (auto& focus : m_Focuses)
+	{
+		std::int64_t x = coord.m_X - focus.m_X;
+		std::int64_t y = coord.m_Y - focus.m_Y;
+		std::int64_t z = coord.m_Z - focus.m_Z;
+		if (x * x + y * y <= radius * radius && z >= -verticalRadius && z <= verticalRadius)
+			return true;
+	}
+	return false;
+}
+
+std::int64_t ChunkStreamer::distanceSquared(const ChunkCoord& coord) const
+{
+	std::int64_t closest = INT64_MAX;
+	for (auto& focus : m_Focuses)
+	{
+		std::int64_t x = coord.m_X - focus.m_X;
+		std::int64_t y = coord.m_Y - focus.m_Y;
+		std::int64_t z = coord.m_Z - focus.m_Z;
+		closest        = std::min(closest, x * x + y * y + z * z);
+	}
+	return closest;
+}
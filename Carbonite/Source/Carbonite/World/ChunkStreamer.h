@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ChunkCoord.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Dimension;
+
+struct ChunkStreamerStats
+{
+public:
+	std::size_t   m_PendingLoads       = 0; // Queue depth left after the last update
+	std::size_t   m_PendingUnloads     = 0;
+	std::size_t   m_Loads              = 0; // Chunks loaded in the last update
+	std::size_t   m_Unloads            = 0;
+	std::uint64_t m_TotalLoads         = 0;
+	std::uint64_t m_TotalRestored      = 0; // Loads served by the chunk cache or the region files instead of generation
+	std::uint64_t m_TotalUnloads       = 0;
+	std::uint64_t m_Rebuilds           = 0; // Times the queues were rebuilt because a focus crossed a chunk border
+	float         m_UpdateMilliseconds = 0.0f;
+};
+
+// Keeps the chunks around a set of focus points (the cameras) loaded.
+// The loaded area is a cylinder per focus, radius chunks around it horizontally and verticalRadius chunks up and down.
+// Missing chunks are queued closest first, chunks only get unloaded once they are further than the radius plus the hysteresis,
+// so walking back and forth over a chunk border does not load and unload the same chunks every frame.
+// Every update stops issuing loads and unloads once the frame budget is spent, the remaining work carries over.
+class ChunkStreamer
+{
+public:
+	void update(Dimension& dimension, const std::vector<glm::fvec3>& focuses);
+
+	void setRadius(std::int64_t radius, std::int64_t verticalRadius);
+	void setHysteresis(std::int64_t hysteresis);
+	void setFrameBudget(float milliseconds) { m_FrameBudget = milliseconds; }
+
+	auto  getRadius() const { return m_Radius; }
+	auto  getVerticalRadius() const { return m_VerticalRadius; }
+	auto  getHysteresis() const { return m_Hysteresis; }
+	auto  getFrameBudget() const { return m_FrameBudget; }
+	auto& getStats() const { return m_Stats; }
+
+private:
+	struct QueueEntry
+	{
+	public:
+		std::int64_t m_DistanceSquared;
+		ChunkCoord   m_Coord;
+
+		// std::push_heap builds a max heap, invert so the closest chunk is on top.
+		friend bool operator<(const QueueEntry& lhs, const QueueEntry& rhs) { return lhs.m_DistanceSquared > rhs.m_DistanceSquared; }
+	};
+
+	void         rebuildQueues(const Dimension& dimension);
+	bool         isInRange(const ChunkCoord& coord, std::int64_t margin) const;
+	std::int64_t distanceSquared(const ChunkCoord& coord) const;
+
+private:
+	std::int64_t m_Radius         = 8;
+	std::int64_t m_VerticalRadius = 4;
+	std::int64_t m_Hysteresis     = 2;
+	float        m_FrameBudget    = 4.0f;
+
+	std::vector<ChunkCoord> m_Focuses;
+	std::vector<QueueEntry> m_LoadQueue;
+	std::vector<ChunkCoord> m_UnloadQueue; // Farthest last, popped first
+	std::size_t             m_KnownChunkCount = 0;
+	bool                    m_Dirty           = true;
+
+	ChunkStreamerStats m_Stats;
+};
@@ -0,0 +1,107 @@
+#include "ColumnHeightmaps.h"
+#include "Chunk.h"
+
+#include <algorithm>
+
+void ColumnHeightmaps::chunkLoaded(const Chunk& chunk)
+{
+	auto [itr, inserted] = m_Columns.try_emplace(GetColumnCoord(chunk));
+	Column& column       = itr->second;
+	if (inserted)
+		for (auto& heights : column.m_Heights)
+			heights.fill(NoHeight);
+
+	auto position = std::find_if(column.m_Chunks.begin(), column.m_Chunks.end(), [&chunk](const Chunk* other) { return other->m_ChunkZ < chunk.m_ChunkZ; });
+	column.m_Chunks.insert(position, &chunk);
+
+	std::int64_t base = chunk.m_ChunkZ * static_cast<std::int64_t>(Chunk::Size);
+	for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+	{
+		auto& heights = chunk.getHeightmap().getHeights(static_cast<EHeightmap>(i));
+		for (std::size_t j = 0; j < ChunkHeightmap::ColumnCount; ++j)
+			if (heights[j] != 0)
+				column.m_Heights[i][j] = std::max(column.m_Heights[i][j], base + heights[j]);
+	}
+}
+
+void ColumnHeightmaps::chunkUnloaded(const Chunk& chunk)
+{
+	auto itr = m_Columns.find(GetColumnCoord(chunk));
+	if (itr == m_Columns.end())
+		return;
+
+	Column& column = itr->second;
+	std::erase(column.m_Chunks, &chunk);
+	if (column.m_Chunks.empty())
+	{
+		m_Columns.erase(itr);
+		return;
+	}
+
+	// Only heights the chunk provided have to be looked for further down.
+	for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+		for (std::size_t j = 0; j < ChunkHeightmap::ColumnCount; ++j)
+			if (column.m_Heights[i][j] != NoHeight && (column.m_Heights[i][j] - 1) >> 5 == chunk.m_ChunkZ)
+				Refresh(column, i, j);
+}
+
+void ColumnHeightmaps::columnChanged(const Chunk& chunk, std::uint32_t x, std::uint32_t y, std::uint32_t mask)
+{
+	auto itr = m_Columns.find(GetColumnCoord(chunk));
+	if (itr == m_Columns.end())
+		return;
+
+	// Changes below the chunk holding the top of the column don't show.
+	std::size_t index = ChunkHeightmap::ColumnIndex(x, y);
+	for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+	{
+		std::int64_t height = itr->second.m_Heights[i][index];
+		if (((mask >> i) & 1) && (height == NoHeight || (height - 1) >> 5 <= chunk.m_ChunkZ))
+			Refresh(itr->second, i, index);
+	}
+}
+
+void ColumnHeightmaps::chunkChanged(const Chunk& chunk)
+{
+	auto itr = m_Columns.find(GetColumnCoord(chunk));
+	if (itr == m_Columns.end())
+		return;
+
+	for (std::uint32_t i = 0; i < HeightmapCount; ++i)
+	{
+		for (std::size_t j = 0; j < ChunkHeightmap::ColumnCount; ++j)
+		{
+			std::int64_t height = itr->second.m_Heights[i][j];
+			if (height == NoHeight || (height - 1) >> 5 <= chunk.m_ChunkZ)
+				Refresh(itr->second, i, j);
+		}
+	}
+}
+
+std::int64_t ColumnHeightmaps::getHeight(EHeightmap heightmap, std::int64_t x, std::int64_t y) const
+{
+	auto itr = m_Columns.find({ x >> 5, y >> 5, 0 });
+	if (itr == m_Columns.end())
+		return NoHeight;
+	return itr->second.m_Heights[static_cast<std::size_t>(heightmap)][ChunkHeightmap::ColumnIndex(static_cast<std::uint32_t>(x & 31), static_cast<std::uint32_t>(y & 31))];
+}
+
+ChunkCoord ColumnHeightmaps::GetColumnCoord(const Chunk& chunk)
+{
+	return { chunk.m_ChunkX, chunk.m_ChunkY, 0 };
+}
+
+void ColumnHeightmaps::Refresh(Column& column, std::uint32_t heightmap, std::size_t index)
+{
+	// Chunks above the surface hold nothing, the walk ends at the first chunk with a height.
+	for (const Chunk* chunk : column.m_Chunks)
+	{
+		std::uint8_t height = chunk->getHeightmap().getHeights(static_cast<EHeightmap>(heightmap))[index];
+		if (height != 0)
+		{
+			column.m_Heights[heightmap][index] = chunk->m_ChunkZ * static_cast<std::int64_t>(Chunk::Size) + height;
+			return;
+		}
+	}
+	column.m_Heights[heightmap][index] = NoHeight;
+}
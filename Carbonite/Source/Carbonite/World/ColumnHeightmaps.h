@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ChunkCoord.h"
+#include "ChunkHeightmap.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+struct Chunk;
+
+// Heightmaps of chunk columns, the loaded chunks sharing a chunk x and y, merged from the ChunkHeightmap of every chunk.
+// A height is the world z of the highest matching voxel + 1. Only loaded chunks count, so a column whose surface chunk is not
+// loaded reports the top of what is. Updates only walk the chunks of a column when its highest chunk may have changed.
+class ColumnHeightmaps
+{
+public:
+	static constexpr std::int64_t NoHeight = std::numeric_limits<std::int64_t>::min();
+
+public:
+	// The chunk's heightmap must be valid while it is part of a column.
+	void chunkLoaded(const Chunk& chunk);
+	void chunkUnloaded(const Chunk& chunk);
+	// After the chunk's heightmaps changed in column x, y (local to the chunk) for the EHeightmap bits of mask.
+	void columnChanged(const Chunk& chunk, std::uint32_t x, std::uint32_t y, std::uint32_t mask);
+	// After the chunk's heightmaps were rebuilt.
+	void chunkChanged(const Chunk& chunk);
+	void clear() { m_Columns.clear(); }
+
+	// World coordinates, NoHeight if no loaded voxel of the column matches.
+	std::int64_t getHeight(EHeightmap heightmap, std::int64_t x, std::int64_t y) const;
+
+	auto getColumnCount() const { return m_Columns.size(); }
+
+private:
+	struct Column
+	{
+	public:
+		std::vector<const Chunk*>                                                         m_Chunks; // Highest first
+		std::array<std::array<std::int64_t, ChunkHeightmap::ColumnCount>, HeightmapCount> m_Heights;
+	};
+
+	static ChunkCoord GetColumnCoord(const Chunk& chunk);
+	static void       Refresh(Column& column, std::uint32_t heightmap, std::size_t index);
+
+private:
+	std::unordered_map<ChunkCoord, Column, ChunkCoordHash> m_Columns;
+};
@@ -1,5 +1,280 @@
 #include "Dimension.h"
 
-Dimension::Dimension() {}
+Dimension::Dimension()
+    : m_Workers(std::make_unique<WorkerPool>()), m_Lighting(std::make_unique<LightingEngine>(*m_Workers)), m_Ticker(std::make_unique<BlockTicker>(*m_Workers)), m_Collision(std::make_unique<VoxelCollision>(*m_Workers)), m_Fluids(std::make_unique<FluidSimulation>(*m_Workers)) {}
 
-Dimension::~Dimension() {}
\ No newline at end of file
+Dimension::~Dimension()
+{
+	unloadAllChunks();
+}
+
+std::array<Chunk*, FaceCount> Dimension::getNeighbours(const ChunkCoord& coord) const
+{
+	std::array<Chunk*, FaceCount> neighbours;
+	for (std::uint32_t i = 0; i < FaceCount; ++i)
+		neighbours[i] = getChunk(coord.neighbour(static_cast<EFace>(i)));
+	return neighbours;
+}
+
+std::uint64_t Dimension::getVoxel(std::int64_t x, std::int64_t y, std::int64_t z) const
+{
+	Chunk* chunk = getChunk(x >> 5, y >> 5, z >> 5);
+	if (!chunk)
+		return Chunk::EmptyState;
+	return chunk->getVoxels().get(Chunk::PositionToIndex(x & 31, y & 31, z & 31));
+}
+
+std::uint8_t Dimension::getFluid(std::int64_t x, std::int64_t y, std::int64_t z) const
+{
+	Chunk* chunk = getChunk(x >> 5, y >> 5, z >> 5);
+	if (!chunk)
+		return 0;
+	return chunk->getFluid().get(Chunk::PositionToIndex(x & 31, y & 31, z & 31));
+}
+
+bool Dimension::setFluid(std::int64_t x, std::int64_t y, std::int64_t z, std::uint8_t cell)
+{
+	Chunk* chunk = getChunk(x >> 5, y >> 5, z >> 5);
+	if (!chunk)
+		return false;
+
+	std::size_t index = Chunk::PositionToIndex(x & 31, y & 31, z & 31);
+	if (chunk->getFluid().get(index) == cell)
+		return true;
+
+	chunk->getFluid().set(index, cell);
+	chunk->markUnsaved();
+	m_Fluids->voxelChanged(chunk->getCoord(), index);
+	return true;
+}
+
+bool Dimension::setVoxel(std::int64_t x, std::int64_t y, std::int64_t z, std::uint64_t state)
+{
+	Chunk* chunk = getChunk(x >> 5, y >> 5, z >> 5);
+	if (!chunk)
+		return false;
+
+	std::uint32_t localX   = static_cast<std::uint32_t>(x & 31);
+	std::uint32_t localY   = static_cast<std::uint32_t>(y & 31);
+	std::uint32_t localZ   = static_cast<std::uint32_t>(z & 31);
+	std::size_t   index    = Chunk::PositionToIndex(localX, localY, localZ);
+	std::uint64_t oldState = chunk->getVoxels().get(index);
+	if (oldState == state)
+		return true;
+
+	chunk->set(localX, localY, localZ, state);
+	updateHeightmap(*chunk, localX, localY, localZ);
+	m_Lighting->voxelChanged(chunk->getCoord(), index, oldState);
+	m_Fluids->voxelChanged(chunk->getCoord(), index);
+	m_Lod.chunkChanged(chunk->getCoord());
+
+	// Border voxels are part of the neighbour's meshing input.
+	std::uint32_t local[3] { localX, localY, localZ };
+	for (std::uint32_t i = 0; i < FaceCount; ++i)
+	{
+		EFace face = static_cast<EFace>(i);
+		if (local[getFaceAxis(face)] != (isPositiveFace(face) ? Chunk::Size - 1 : 0))
+			continue;
+		if (Chunk* neighbour = getNeighbour(*chunk, face))
+			neighbour->markDirty();
+	}
+	return true;
+}
+
+BlockEditResult Dimension::applyEdits(const BlockEditBatch& batch)
+{
+	BlockEditResult result;
+	ChunkEditResult chunkResult;
+	batch.forEachChunk([this, &result, &chunkResult](const ChunkCoord& coord, const std::vector<BlockEdit>& edits) {
+		Chunk* chunk = getChunk(coord);
+		if (!chunk)
+		{
+			++result.m_SkippedChunks;
+			return;
+		}
+
+		chunkResult.m_DirtySections = 0;
+		chunkResult.m_Written       = 0;
+		chunkResult.m_Bulk          = false;
+		chunkResult.m_Changes.clear();
+		BlockEditBatch::Apply(*chunk, edits, chunkResult);
+		if (chunkResult.m_DirtySections == 0)
+			return;
+
+		++result.m_Chunks;
+		result.m_Written += chunkResult.m_Written;
+		m_Lod.chunkChanged(coord);
+		if (chunkResult.m_Bulk)
+		{
+			chunk->getHeightmap().build(chunk->getVoxels(), *m_BlockStates);
+			m_Heightmaps.chunkChanged(*chunk);
+			m_Lighting->regionChanged(coord, chunkResult.m_DirtySections);
+			m_Fluids->regionChanged(coord);
+		}
+		else
+		{
+			// Every edit is already applied, the heightmap looks at the final voxels but still only rescans removed tops.
+			for (auto& [index, oldState] : chunkResult.m_Changes)
+			{
+				updateHeightmap(*chunk, static_cast<std::uint32_t>(index % Chunk::Size), static_cast<std::uint32_t>((index / Chunk::Size) % Chunk::Size), static_cast<std::uint32_t>(index / (Chunk::Size * Chunk::Size)));
+				m_Lighting->voxelChanged(coord, index, oldState);
+				m_Fluids->voxelChanged(coord, index);
+			}
+		}
+
+		for (std::uint32_t i = 0; i < FaceCount; ++i)
+		{
+			EFace face = static_cast<EFace>(i);
+			if (chunkResult.m_DirtySections & ChunkEditResult::FaceSections(face))
+				if (Chunk* neighbour = getNeighbour(*chunk, face))
+					neighbour->markDirty();
+		}
+	});
+	return result;
+}
+
+Chunk* Dimension::loadChunk(const ChunkCoord& coord, bool* restored)
+{
+	Chunk* chunk = m_ChunkIndex.find(coord);
+	if (chunk)
+	{
+		if (restored)
+			*restored = false;
+		return chunk;
+	}
+
+	chunk = m_ChunkPool.allocate(coord);
+	m_ChunkIndex.insert(coord, chunk);
+
+	// Snapshots still waiting for the save thread are newer than the region files.
+	bool loaded = m_ChunkCache.restore(*chunk) || (m_Saver && m_Saver->restore(*chunk)) || (m_Storage && m_Storage->loadChunk(*chunk));
+	if (restored)
+		*restored = loaded;
+	if (!loaded && m_Generator)
+		m_Generator(*chunk);
+	// Open air, solid rock and other repeated chunks keep one copy of their voxels until edited.
+	chunk->getVoxels().share();
+	// Region files written before heightmaps were persisted restore the voxels only.
+	if (!loaded || !chunk->getHeightmap().isValid())
+		chunk->getHeightmap().build(chunk->getVoxels(), *m_BlockStates);
+	m_Heightmaps.chunkLoaded(*chunk);
+	m_Lighting->chunkLoaded(coord);
+	m_Fluids->chunkLoaded(coord);
+	// Restored chunks may hold edits the LOD nodes built from the generator do not know about.
+	if (loaded)
+		m_Lod.chunkChanged(coord);
+
+	markNeighboursDirty(coord);
+	return chunk;
+}
+
+bool Dimension::unloadChunk(const ChunkCoord& coord)
+{
+	Chunk* chunk = m_ChunkIndex.erase(coord);
+	if (!chunk)
+		return false;
+
+	if (chunk->isUnsaved())
+		saveChunk(*chunk);
+	m_ChunkCache.store(*chunk);
+	m_Ticker->chunkUnloaded(coord);
+	m_Fluids->chunkUnloaded(coord);
+	m_Heightmaps.chunkUnloaded(*chunk);
+	m_ChunkPool.free(chunk);
+	markNeighboursDirty(coord);
+	return true;
+}
+
+void Dimension::unloadAllChunks()
+{
+	saveAllChunks();
+	if (m_Ticker)
+		forEachChunk([this](const Chunk& chunk) { m_Ticker->chunkUnloaded(chunk.getCoord()); });
+	if (m_Fluids)
+		m_Fluids->clear();
+	m_ChunkIndex.clear();
+	m_Heightmaps.clear();
+	m_ChunkPool.clear();
+}
+
+void Dimension::setSaveDirectory(const std::filesystem::path& directory)
+{
+	m_Saver.reset();
+	if (m_Storage)
+		m_Storage->flush();
+	m_Storage = std::make_unique<RegionStorage>(directory);
+	m_Saver   = std::make_unique<RegionSaver>(*m_Storage);
+	m_ChunkCache.clear();
+}
+
+void Dimension::setBlockStates(const BlockStateTable* blockStates)
+{
+	m_BlockStates = blockStates;
+	m_Lighting->setBlockStates(blockStates);
+	m_Ticker->setBlockStates(blockStates);
+
+	// Heights, occupancy and where fluid may flow depend on which states are opaque and solid.
+	forEachChunk([this](Chunk& chunk) {
+		chunk.getHeightmap().build(chunk.getVoxels(), *m_BlockStates);
+		chunk.getOccupancy().invalidate();
+		m_Heightmaps.chunkChanged(chunk);
+		if (!chunk.getFluid().isEmpty())
+			m_Fluids->regionChanged(chunk.getCoord());
+	});
+}
+
+bool Dimension::saveChunk(Chunk& chunk)
+{
+	if (!m_Saver)
+		return false;
+
+	// Edits after this point mark the chunk unsaved again, the snapshot keeps the voxels as they are now.
+	m_Saver->enqueue(chunk);
+	chunk.markSaved();
+	return true;
+}
+
+std::size_t Dimension::saveAllChunks()
+{
+	if (!m_Saver)
+		return 0;
+
+	std::size_t saved = 0;
+	forEachChunk([this, &saved](Chunk& chunk) {
+		if (chunk.isUnsaved() && saveChunk(chunk))
+			++saved;
+	});
+	m_Saver->submit();
+	return saved;
+}
+
+void Dimension::updateSaving()
+{
+	if (!m_Saver)
+		return;
+
+	// Failed saves are retried by the saver itself.
+	m_Saver->submit();
+}
+
+void Dimension::waitForSaves()
+{
+	if (!m_Saver)
+		return;
+
+	m_Saver->wait();
+	updateSaving();
+}
+
+void Dimension::updateHeightmap(Chunk& chunk, std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+	if (std::uint32_t changed = chunk.getHeightmap().voxelChanged(chunk.getVoxels(), *m_BlockStates, x, y, z))
+		m_Heightmaps.columnChanged(chunk, x, y, changed);
+}
+
+void Dimension::markNeighboursDirty(const ChunkCoord& coord)
+{
+	for (Chunk* neighbour : getNeighbours(coord))
+		if (neighbour)
+			neighbour->markDirty();
+}
@@ -1,15 +1,157 @@
 #pragma once
 
+#include "BlockEditBatch.h"
+#include "BlockTicker.h"
+#include "Carbonite/Block/BlockStateTable.h"
 #include "Chunk.h"
+#include "ChunkCache.h"
+#include "ChunkCoord.h"
+#include "ChunkIndex.h"
+#include "ChunkLod.h"
+#include "ChunkStreamer.h"
+#include "ColumnHeightmaps.h"
+#include "FluidSimulation.h"
+#include "LightingEngine.h"
+#include "Region/RegionSaver.h"
+#include "Region/RegionStorage.h"
+#include "VoxelCollision.h"
+#include "VoxelQuery.h"
+#include "Utils/Pool.h"
+#include "Utils/WorkerPool.h"
 
+#include <array>
+#include <filesystem>
+#include <functional>
+#include <memory>
 #include <vector>
 
 class Dimension
 {
+public:
+	using ChunkGenerator = std::function<void(Chunk& chunk)>;
+
 public:
 	Dimension();
+	Dimension(const Dimension&) = delete;
+	Dimension(Dimension&&)      = delete;
 	~Dimension();
 
+	Dimension& operator=(const Dimension&) = delete;
+	Dimension& operator=(Dimension&&) = delete;
+
+	Chunk* getChunk(const ChunkCoord& coord) const { return m_ChunkIndex.find(coord); }
+	Chunk* getChunk(std::int64_t chunkX, std::int64_t chunkY, std::int64_t chunkZ) const { return getChunk({ chunkX, chunkY, chunkZ }); }
+	Chunk* getNeighbour(const Chunk& chunk, EFace face) const { return getChunk(chunk.getCoord().neighbour(face)); }
+
+	// Fills neighbours in EFace order, missing chunks are nullptr.
+	std::array<Chunk*, FaceCount> getNeighbours(const ChunkCoord& coord) const;
+
+	// Voxel access in world coordinates, voxels of chunks that are not loaded read as empty and cannot be set.
+	std::uint64_t getVoxel(std::int64_t x, std::int64_t y, std::int64_t z) const;
+	bool          setVoxel(std::int64_t x, std::int64_t y, std::int64_t z, std::uint64_t state);
+
+	// Fluid cells in world coordinates (see ChunkFluid), cells of chunks that are not loaded are dry and cannot be set.
+	std::uint8_t getFluid(std::int64_t x, std::int64_t y, std::int64_t z) const;
+	bool         setFluid(std::int64_t x, std::int64_t y, std::int64_t z, std::uint8_t cell);
+
+	// Applies every edit of the batch to the loaded chunks, chunks that are not loaded are skipped.
+	BlockEditResult applyEdits(const BlockEditBatch& batch);
+
+	// World z above the highest opaque or motion blocking voxel of the column, ColumnHeightmaps::NoHeight if no loaded chunk
+	// of the column has one. Reads the heightmaps only.
+	std::int64_t getHeight(EHeightmap heightmap, std::int64_t x, std::int64_t y) const { return m_Heightmaps.getHeight(heightmap, x, y); }
+
+	bool raycast(const VoxelRay& ray, VoxelHit& hit) const { return VoxelQuery::raycast(*this, ray, hit); }
+	// On the worker pool of the dimension, not while one of its updates runs.
+	void raycast(const std::vector<VoxelRay>& rays, std::vector<VoxelHit>& hits) const { VoxelQuery::raycast(*this, rays, hits, m_Workers.get()); }
+	bool sweep(const glm::fvec3& min, const glm::fvec3& max, const glm::fvec3& motion, VoxelHit& hit) const { return VoxelQuery::sweep(*this, min, max, motion, hit); }
+	// Moves every body by its motion, stopping and sliding at solid voxels (see VoxelCollision).
+	void collide(std::vector<CollisionBody>& bodies) { m_Collision->collide(*this, bodies); }
+
+	// Returns the loaded chunk, restores it from the chunk cache or the region files or generates a new one.
+	// restored is set to whether the chunk came from the chunk cache or the region files.
+	Chunk* loadChunk(const ChunkCoord& coord, bool* restored = nullptr);
+	// Unloading queues unsaved chunks for saving and keeps a compressed copy in the chunk cache.
+	bool unloadChunk(const ChunkCoord& coord);
+	void unloadAllChunks();
+
+	// Enables persistence, chunks are stored in region files inside directory.
+	void        setSaveDirectory(const std::filesystem::path& directory);
+	// Saving only snapshots the chunks (see RegionSaver), the region files are written on the save thread.
+	// saveChunk() adds the chunk to the open batch, saveAllChunks() adds every unsaved chunk and submits the batch so
+	// they reach the disk as one point in time view. Returns the number of chunks queued.
+	bool        saveChunk(Chunk& chunk);
+	std::size_t saveAllChunks();
+	// Submits the chunks queued since the last call, failed saves go out again with it.
+	void        updateSaving();
+	// Blocks until every queued chunk is on disk.
+	void        waitForSaves();
+
+	// Fills chunks that could not be restored, without a generator they stay empty.
+	void setGenerator(ChunkGenerator generator) { m_Generator = std::move(generator); }
+
+	// Properties of the voxel states for lighting and queries, must outlive the dimension.
+	void setBlockStates(const BlockStateTable* blockStates);
+
+	// Loads and unloads chunks around the focuses within the streamer's frame budget.
+	void updateStreaming(const std::vector<glm::fvec3>& focuses) { m_Streamer.update(*this, focuses); }
+
+	// Settles light for the chunks loaded and the voxels set since the last call.
+	std::size_t updateLighting() { return m_Lighting->update(*this); }
+
+	// Runs one round of random and scheduled block ticks over the loaded chunks, returns the number of handler calls.
+	std::size_t tick() { return m_Ticker->tick(*this); }
+
+	// Runs one step of the fluid simulation, returns the number of fluid cells that changed.
+	std::size_t updateFluids() { return m_Fluids->update(*this); }
+
+	auto& getStreamer() { return m_Streamer; }
+	auto& getStreamer() const { return m_Streamer; }
+	auto  getStorage() const { return m_Storage.get(); }
+	auto  getSaver() const { return m_Saver.get(); }
+	auto& getChunkCache() { return m_ChunkCache; }
+	auto& getChunkCache() const { return m_ChunkCache; }
+	auto& getWorkers() const { return *m_Workers; }
+	auto& getLighting() { return *m_Lighting; }
+	auto& getLighting() const { return *m_Lighting; }
+	auto& getLod() { return m_Lod; }
+	auto& getTicker() { return *m_Ticker; }
+	auto& getTicker() const { return *m_Ticker; }
+	auto& getCollision() { return *m_Collision; }
+	auto& getCollision() const { return *m_Collision; }
+	auto& getFluids() { return *m_Fluids; }
+	auto& getFluids() const { return *m_Fluids; }
+	auto& getLod() const { return m_Lod; }
+	auto& getBlockStates() const { return *m_BlockStates; }
+	auto& getHeightmaps() const { return m_Heightmaps; }
+
+	template <class F>
+	void forEachChunk(F&& func) const
+	{
+		m_ChunkIndex.forEach([&func](const ChunkCoord&, Chunk* chunk) { func(*chunk); });
+	}
+
+	auto getLoadedChunkCount() const { return m_ChunkIndex.getSize(); }
+
 private:
-	std::vector<Chunk> m_LoadedChunks;
+	void markNeighboursDirty(const ChunkCoord& coord);
+	void updateHeightmap(Chunk& chunk, std::uint32_t x, std::uint32_t y, std::uint32_t z);
+
+private:
+	Pool<Chunk>                    m_ChunkPool;
+	ChunkIndex                     m_ChunkIndex;
+	ColumnHeightmaps               m_Heightmaps;
+	std::unique_ptr<RegionStorage> m_Storage;
+	std::unique_ptr<RegionSaver>   m_Saver; // Declared after m_Storage, it finishes its batches before the storage closes
+	ChunkCache                     m_ChunkCache;
+	ChunkStreamer                  m_Streamer;
+	ChunkGenerator                 m_Generator;
+	const BlockStateTable*         m_BlockStates = &BlockStateTable::Default();
+
+	std::unique_ptr<WorkerPool>      m_Workers; // Shared by the subsystems below, declared first so it outlives them
+	std::unique_ptr<LightingEngine>  m_Lighting;
+	std::unique_ptr<BlockTicker>     m_Ticker;
+	std::unique_ptr<VoxelCollision>  m_Collision;
+	std::unique_ptr<FluidSimulation> m_Fluids;
+	ChunkLod                         m_Lod;
 };
@@ -0,0 +1,351 @@
+#include "FluidSimulation.h"
+#include "Dimension.h"
+
+#include <chrono>
+
+namespace
+{
+	constexpr std::int32_t Size = static_cast<std::int32_t>(Chunk::Size);
+
+	// The cell and its six neighbours, then the cells one up and one sideways, which spread over the cell.
+	constexpr std::int32_t Offsets[11][3] {
+		{ 0, 0, 0 },
+		{ -1, 0, 0 },
+		{ 1, 0, 0 },
+		{ 0, -1, 0 },
+		{ 0, 1, 0 },
+		{ 0, 0, -1 },
+		{ 0, 0, 1 },
+		{ -1, 0, 1 },
+		{ 1, 0, 1 },
+		{ 0, -1, 1 },
+		{ 0, 1, 1 }
+	};
+
+	// The neighbours in x and y, Offsets 1 to 4.
+	constexpr std::int32_t Sideways[4][2] {
+		{ -1, 0 },
+		{ 1, 0 },
+		{ 0, -1 },
+		{ 0, 1 }
+	};
+
+	bool IsInside(std::int32_t x, std::int32_t y, std::int32_t z)
+	{
+		return static_cast<std::uint32_t>(x | y | z) < static_cast<std::uint32_t>(Size);
+	}
+
+	std::uint16_t LocalIndex(std::int32_t x, std::int32_t y, std::int32_t z)
+	{
+		return static_cast<std::uint16_t>(Chunk::PositionToIndex(static_cast<std::uint32_t>(x & 31), static_cast<std::uint32_t>(y & 31), static_cast<std::uint32_t>(z & 31)));
+	}
+} // namespace
+
+FluidSimulation::FluidSimulation(WorkerPool& workers)
+    : m_Workers(workers)
+{
+}
+
+void FluidSimulation::clear()
+{
+	m_Chunks.clear();
+	m_PendingCells.clear();
+	m_PendingRegions.clear();
+}
+
+std::size_t FluidSimulation::update(Dimension& dimension)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	++m_Tick;
+	m_Stats        = {};
+	m_Stats.m_Tick = m_Tick;
+	m_Dimension    = &dimension;
+	processPending(dimension);
+
+	m_Ticking.clear();
+	for (auto& [coord, fluids] : m_Chunks)
+	{
+		fluids.m_Active.swap(fluids.m_Next);
+		fluids.m_Next.clear();
+		for (std::uint16_t index : fluids.m_Active)
+			fluids.m_Queued[index >> 6] &= ~(1ULL << (index & 63));
+		for (std::int64_t z = -1, i = 0; z <= 1; ++z)
+			for (std::int64_t y = -1; y <= 1; ++y)
+				for (std::int64_t x = -1; x <= 1; ++x, ++i)
+					fluids.m_Neighbourhood[i] = dimension.getChunk(coord.offset(x, y, z));
+		if (!fluids.m_Neighbourhood[13] || fluids.m_Active.empty())
+			continue;
+
+		m_Ticking.push_back(&fluids);
+		m_Stats.m_ActiveCells += fluids.m_Active.size();
+	}
+	m_Stats.m_Chunks = m_Ticking.size();
+
+	m_Workers.parallelFor(m_Ticking.size(), [this](std::size_t index) { compute(*m_Ticking[index]); });
+	m_Workers.parallelFor(m_Ticking.size(), [this](std::size_t index) { apply(*m_Ticking[index]); });
+
+	// Wakes the cells of neighbouring chunks only now, while no chunk is running.
+	for (ChunkFluids* fluids : m_Ticking)
+	{
+		m_Stats.m_Changed += fluids->m_Changes.size();
+		for (auto& activation : fluids->m_Outbox)
+			if (ChunkFluids* target = getFluids(dimension, activation.m_Chunk))
+				Queue(*target, activation.m_Index);
+		fluids->m_Outbox.clear();
+	}
+	for (auto itr = m_Chunks.begin(); itr != m_Chunks.end();)
+	{
+		if (itr->second.m_Next.empty())
+			itr = m_Chunks.erase(itr);
+		else
+			++itr;
+	}
+	m_Dimension = nullptr;
+
+	m_Stats.m_Milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return m_Stats.m_Changed;
+}
+
+std::size_t FluidSimulation::getActiveCellCount() const
+{
+	std::size_t count = 0;
+	for (auto& [coord, fluids] : m_Chunks)
+		count += fluids.m_Next.size();
+	return count;
+}
+
+void FluidSimulation::Queue(ChunkFluids& fluids, std::uint16_t index)
+{
+	std::uint64_t& word = fluids.m_Queued[index >> 6];
+	std::uint64_t  bit  = 1ULL << (index & 63);
+	if (word & bit)
+		return;
+	word |= bit;
+	fluids.m_Next.push_back(index);
+}
+
+FluidSimulation::ChunkFluids* FluidSimulation::getFluids(const Dimension& dimension, const ChunkCoord& coord)
+{
+	if (!dimension.getChunk(coord))
+		return nullptr;
+
+	ChunkFluids& fluids = m_Chunks[coord];
+	if (fluids.m_Queued.empty())
+	{
+		fluids.m_Coord = coord;
+		fluids.m_Queued.assign(ChunkFluid::VoxelCount / 64, 0);
+	}
+	return &fluids;
+}
+
+void FluidSimulation::activateAround(const Dimension& dimension, ChunkFluids& fluids, std::int32_t x, std::int32_t y, std::int32_t z)
+{
+	for (auto& offset : Offsets)
+	{
+		std::int32_t nx = x + offset[0];
+		std::int32_t ny = y + offset[1];
+		std::int32_t nz = z + offset[2];
+		if (IsInside(nx, ny, nz))
+		{
+			Queue(fluids, LocalIndex(nx, ny, nz));
+			continue;
+		}
+		if (ChunkFluids* neighbour = getFluids(dimension, fluids.m_Coord.offset(nx >> 5, ny >> 5, nz >> 5)))
+			Queue(*neighbour, LocalIndex(nx, ny, nz));
+	}
+}
+
+void FluidSimulation::activateFluid(const Dimension& dimension, const Chunk& chunk, const std::uint32_t (&first)[3], const std::uint32_t (&last)[3])
+{
+	auto&        fluid  = chunk.getFluid();
+	ChunkFluids* fluids = nullptr;
+	for (std::uint32_t z = first[2]; z <= last[2]; ++z)
+	{
+		for (std::uint32_t y = first[1]; y <= last[1]; ++y)
+		{
+			for (std::uint32_t x = first[0]; x <= last[0]; ++x)
+			{
+				if (!fluid.get(Chunk::PositionToIndex(x, y, z)))
+					continue;
+				if (!fluids)
+					fluids = getFluids(dimension, chunk.getCoord());
+				activateAround(dimension, *fluids, static_cast<std::int32_t>(x), static_cast<std::int32_t>(y), static_cast<std::int32_t>(z));
+			}
+		}
+	}
+}
+
+void FluidSimulation::processPending(const Dimension& dimension)
+{
+	for (auto& pending : m_PendingCells)
+	{
+		const Chunk* chunk = dimension.getChunk(pending.m_Chunk);
+		if (!chunk)
+			continue;
+
+		// Edits away from any fluid, most of them, wake nothing.
+		std::int32_t x   = pending.m_Index % Size;
+		std::int32_t y   = (pending.m_Index / Size) % Size;
+		std::int32_t z   = pending.m_Index / (Size * Size);
+		bool         wet = false;
+		for (std::size_t i = 0; i < 7 && !wet; ++i)
+		{
+			std::int32_t nx = x + Offsets[i][0];
+			std::int32_t ny = y + Offsets[i][1];
+			std::int32_t nz = z + Offsets[i][2];
+			if (IsInside(nx, ny, nz))
+			{
+				wet = chunk->getFluid().get(LocalIndex(nx, ny, nz)) != 0;
+				continue;
+			}
+			const Chunk* neighbour = dimension.getChunk(pending.m_Chunk.offset(nx >> 5, ny >> 5, nz >> 5));
+			wet                    = neighbour && neighbour->getFluid().get(LocalIndex(nx, ny, nz)) != 0;
+		}
+		if (wet)
+			activateAround(dimension, *getFluids(dimension, pending.m_Chunk), x, y, z);
+	}
+	m_PendingCells.clear();
+
+	// Every fluid cell of the chunk and of the neighbours' layers touching it.
+	constexpr std::uint32_t Last = static_cast<std::uint32_t>(Size - 1);
+	for (auto& coord : m_PendingRegions)
+	{
+		if (const Chunk* chunk = dimension.getChunk(coord); chunk && !chunk->getFluid().isEmpty())
+			activateFluid(dimension, *chunk, { 0, 0, 0 }, { Last, Last, Last });
+
+		for (std::uint32_t i = 0; i < FaceCount; ++i)
+		{
+			EFace        face      = static_cast<EFace>(i);
+			const Chunk* neighbour = dimension.getChunk(coord.neighbour(face));
+			if (!neighbour || neighbour->getFluid().isEmpty())
+				continue;
+
+			std::uint32_t axis  = getFaceAxis(face);
+			std::uint32_t layer = isPositiveFace(face) ? 0 : Last;
+			std::uint32_t first[3] { 0, 0, 0 };
+			std::uint32_t last[3] { Last, Last, Last };
+			first[axis] = layer;
+			last[axis]  = layer;
+			activateFluid(dimension, *neighbour, first, last);
+		}
+	}
+	m_PendingRegions.clear();
+}
+
+void FluidSimulation::compute(ChunkFluids& fluids)
+{
+	auto&        blockStates = m_Dimension->getBlockStates();
+	const Chunk& chunk       = *fluids.m_Neighbourhood[13];
+
+	// Coordinates up to one outside the chunk, chunks that are not loaded are solid and dry.
+	auto sample = [&](std::int32_t x, std::int32_t y, std::int32_t z, bool& solid) -> std::uint8_t {
+		const Chunk* owner = fluids.m_Neighbourhood[static_cast<std::size_t>(((x >> 5) + 1) + ((y >> 5) + 1) * 3 + ((z >> 5) + 1) * 9)];
+		if (!owner)
+		{
+			solid = true;
+			return 0;
+		}
+		std::uint16_t index = LocalIndex(x, y, z);
+		solid               = blockStates.isSolid(owner->getVoxels().get(index));
+		return owner->getFluid().get(index);
+	};
+
+	fluids.m_Changes.clear();
+	for (std::uint16_t index : fluids.m_Active)
+	{
+		std::int32_t x       = index % Size;
+		std::int32_t y       = (index / Size) % Size;
+		std::int32_t z       = index / (Size * Size);
+		std::uint8_t current = chunk.getFluid().get(index);
+		std::uint8_t next    = 0;
+		bool         solid   = blockStates.isSolid(chunk.getVoxels().get(index));
+		if (solid)
+		{
+			next = 0;
+		}
+		else if (ChunkFluid::IsSource(current))
+		{
+			next = current;
+		}
+		else if (std::uint8_t above = sample(x, y, z + 1, solid); ChunkFluid::GetLevel(above))
+		{
+			next = ChunkFluid::Make(ChunkFluid::GetKind(above), ChunkFluid::MaxLevel, false);
+		}
+		else
+		{
+			// Fluid only spreads sideways from sources and from cells resting on something, falling fluid in mid air does not.
+			// Only falling cells are full without being a source, the sideways spread always decays.
+			std::uint8_t best     = 0;
+			std::uint8_t bestKind = 0;
+			for (auto& offset : Sideways)
+			{
+				std::uint8_t neighbour = sample(x + offset[0], y + offset[1], z, solid);
+				std::uint8_t level     = ChunkFluid::GetLevel(neighbour);
+				if (!level)
+					continue;
+				if (!ChunkFluid::IsSource(neighbour))
+				{
+					std::uint8_t below     = sample(x + offset[0], y + offset[1], z - 1, solid);
+					bool         full      = ChunkFluid::GetLevel(below) == ChunkFluid::MaxLevel;
+					bool         falling   = level == ChunkFluid::MaxLevel;
+					bool         onFalling = full && !ChunkFluid::IsSource(below);
+					if (!solid && (!full || (falling && onFalling)))
+						continue;
+				}
+
+				std::uint8_t kind  = ChunkFluid::GetKind(neighbour);
+				std::uint8_t decay = m_Properties[kind].m_Decay;
+				if (level <= decay)
+					continue;
+				std::uint8_t spread = static_cast<std::uint8_t>(level - decay);
+				if (spread > best || (spread == best && kind < bestKind))
+				{
+					best     = spread;
+					bestKind = kind;
+				}
+			}
+			next = ChunkFluid::Make(bestKind, best, false);
+		}
+
+		if (next == current)
+			continue;
+
+		// Slow fluids stay active until their turn comes.
+		std::uint32_t interval = m_Properties[ChunkFluid::GetKind(next ? next : current)].m_Interval;
+		if (interval > 1 && m_Tick % interval != 0)
+		{
+			Queue(fluids, index);
+			continue;
+		}
+		fluids.m_Changes.push_back({ index, next });
+	}
+}
+
+void FluidSimulation::apply(ChunkFluids& fluids)
+{
+	if (fluids.m_Changes.empty())
+		return;
+
+	Chunk& chunk = *fluids.m_Neighbourhood[13];
+	auto&  fluid = chunk.getFluid();
+	for (auto& [index, cell] : fluids.m_Changes)
+	{
+		fluid.set(index, cell);
+
+		std::int32_t x = index % Size;
+		std::int32_t y = (index / Size) % Size;
+		std::int32_t z = index / (Size * Size);
+		for (auto& offset : Offsets)
+		{
+			std::int32_t nx = x + offset[0];
+			std::int32_t ny = y + offset[1];
+			std::int32_t nz = z + offset[2];
+			if (IsInside(nx, ny, nz))
+				Queue(fluids, LocalIndex(nx, ny, nz));
+			else
+				fluids.m_Outbox.push_back({ fluids.m_Coord.offset(nx >> 5, ny >> 5, nz >> 5), LocalIndex(nx, ny, nz) });
+		}
+	}
+	chunk.markUnsaved();
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "ChunkCoord.h"
+#include "ChunkFluid.h"
+#include "Utils/SlabAllocator.h"
+#include "Utils/WorkerPool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+class Dimension;
+struct Chunk;
+
+struct FluidProperties
+{
+public:
+	std::uint8_t  m_Decay    = 1; // Levels lost per voxel of sideways spread
+	std::uint32_t m_Interval = 1; // Ticks between updates of a cell, slow fluids wait while staying active
+};
+
+struct FluidStats
+{
+public:
+	std::uint64_t m_Tick         = 0;
+	std::size_t   m_Chunks       = 0; // Chunks with active cells in the last update
+	std::size_t   m_ActiveCells  = 0;
+	std::size_t   m_Changed      = 0;
+	float         m_Milliseconds = 0.0f;
+};
+
+// Cellular automaton over the ChunkFluid of the loaded chunks, in the style of block games: sources keep their level,
+// a fluid cell with fluid above is full and falling, otherwise it takes the highest level a sideways neighbour spreads to it,
+// minus the neighbour's decay. A neighbour only spreads sideways if it is a source or the voxel below it is solid or full
+// fluid, except falling fluid over falling fluid, so a falling column only spreads where it lands.
+// Chunks that are not loaded are solid and dry.
+// Only active cells are evaluated, a cell whose fluid changed activates itself, its six neighbours
+// and the four cells that spread over it for the next update.
+// Chunks whose cells settled drop out of the active set, so still fluid costs nothing. Edits reported through voxelChanged(),
+// regionChanged() and chunkLoaded() wake the fluid around them on the next update.
+// An update evaluates every active chunk in parallel against the fluid as it was when the update started and only then
+// writes the changes, chunk borders included, so the result does not depend on the order the threads run in.
+// Chunks are jobs of the dimension's WorkerPool, update() blocks until the tick is done. No chunk may be modified meanwhile.
+class FluidSimulation
+{
+public:
+	FluidSimulation(WorkerPool& workers);
+
+	void setProperties(std::uint8_t kind, const FluidProperties& properties) { m_Properties[kind] = properties; }
+	auto& getProperties(std::uint8_t kind) const { return m_Properties[kind]; }
+
+	// The fluid or the voxel at index changed.
+	void voxelChanged(const ChunkCoord& coord, std::size_t index) { m_PendingCells.push_back({ coord, static_cast<std::uint16_t>(index) }); }
+	// Many voxels of the chunk changed at once.
+	void regionChanged(const ChunkCoord& coord) { m_PendingRegions.push_back(coord); }
+	// Wakes the fluid restored with the chunk and the fluid at the borders of the neighbours, which may flow into it.
+	void chunkLoaded(const ChunkCoord& coord) { m_PendingRegions.push_back(coord); }
+	void chunkUnloaded(const ChunkCoord& coord) { m_Chunks.erase(coord); }
+	void clear();
+
+	// Runs one tick over the active cells, returns the number of cells whose fluid changed.
+	std::size_t update(Dimension& dimension);
+
+	std::size_t getActiveCellCount() const;
+
+	auto  getActiveChunkCount() const { return m_Chunks.size(); }
+	auto  getTick() const { return m_Tick; }
+	auto  getWorkerCount() const { return m_Workers.getWorkerCount(); }
+	auto& getStats() const { return m_Stats; }
+
+private:
+	struct Activation
+	{
+	public:
+		ChunkCoord    m_Chunk;
+		std::uint16_t m_Index;
+	};
+
+	struct ChunkFluids
+	{
+	public:
+		ChunkCoord                                               m_Coord;
+		std::array<Chunk*, 27>                                   m_Neighbourhood {}; // 3x3x3 around the chunk, x fastest
+		std::vector<std::uint16_t>                               m_Active;           // Evaluated this update
+		std::vector<std::uint16_t>                               m_Next;             // Evaluated next update
+		std::vector<std::uint64_t, SlabAllocator<std::uint64_t>> m_Queued;           // Bit per cell in m_Next
+
+		// Only touched by the thread running the chunk.
+		std::vector<std::pair<std::uint16_t, std::uint8_t>> m_Changes;
+		std::vector<Activation>                             m_Outbox; // Cells of other chunks to activate
+	};
+
+	static void Queue(ChunkFluids& fluids, std::uint16_t index);
+
+	ChunkFluids* getFluids(const Dimension& dimension, const ChunkCoord& coord);
+	// Activates the cell at local x, y, z of the chunk and the cells it affects, coordinates may lie one outside the chunk.
+	void         activateAround(const Dimension& dimension, ChunkFluids& fluids, std::int32_t x, std::int32_t y, std::int32_t z);
+	void         activateFluid(const Dimension& dimension, const Chunk& chunk, const std::uint32_t (&first)[3], const std::uint32_t (&last)[3]);
+	void         processPending(const Dimension& dimension);
+
+	void compute(ChunkFluids& fluids);
+	void apply(ChunkFluids& fluids);
+
+private:
+	WorkerPool& m_Workers;
+
+	std::unordered_map<ChunkCoord, ChunkFluids, ChunkCoordHash> m_Chunks;
+	std::vector<ChunkFluids*>                                   m_Ticking;
+	std::vector<Activation>                                     m_PendingCells;
+	std::vector<ChunkCoord>                                     m_PendingRegions;
+
+	std::array<FluidProperties, ChunkFluid::KindCount> m_Properties {};
+	const Dimension*                                   m_Dimension = nullptr;
+	std::uint64_t                                      m_Tick      = 0;
+	FluidStats                                         m_Stats;
+};
@@ -0,0 +1,440 @@
+#include "Noise.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+// A multiply followed by an add may be fused where FMA is available, in the lanes and the scalar tail differently.
+// The rounding would then depend on the row length, so contraction stays off for the whole file.
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+namespace
+{
+	constexpr std::uint32_t PrimeX         = 501125321U;
+	constexpr std::uint32_t PrimeY         = 1136930381U;
+	constexpr std::uint32_t PrimeZ         = 1720413743U;
+	constexpr std::uint32_t HashMultiplier = 0x27D4EB2DU;
+	constexpr std::uint32_t OctaveSeedStep = 0x9E3779B9U;
+
+	constexpr float SimplexSkew   = 0.36602540378f; // (sqrt(3) - 1) / 2
+	constexpr float SimplexUnskew = 0.21132486540f; // (3 - sqrt(3)) / 6
+	constexpr float SimplexScale  = 70.0f;
+
+	// Every lane type offers the same operations, the kernels below are written once against them.
+	struct ScalarLanes
+	{
+	public:
+		using F = float;
+		using I = std::uint32_t;
+		using M = bool;
+
+		static constexpr std::size_t Width = 1;
+
+		static F    Set(float value) { return value; }
+		static I    SetI(std::uint32_t value) { return value; }
+		static I    Index(std::size_t first) { return static_cast<I>(first); }
+		static void Store(float* out, F value) { *out = value; }
+
+		static F Add(F lhs, F rhs) { return lhs + rhs; }
+		static F Sub(F lhs, F rhs) { return lhs - rhs; }
+		static F Mul(F lhs, F rhs) { return lhs * rhs; }
+		static F Max(F lhs, F rhs) { return lhs > rhs ? lhs : rhs; }
+		static F Floor(F value)
+		{
+			F truncated = static_cast<float>(static_cast<std::int32_t>(value));
+			return truncated > value ? truncated - 1.0f : truncated;
+		}
+		static I ToInt(F value) { return static_cast<I>(static_cast<std::int32_t>(value)); }
+		static F ToFloat(I value) { return static_cast<float>(static_cast<std::int32_t>(value)); }
+
+		static M LessThan(F lhs, F rhs) { return lhs < rhs; }
+		static M IsZero(I value) { return value == 0; }
+		static M Equal(I lhs, I rhs) { return lhs == rhs; }
+		static F Select(M mask, F lhs, F rhs) { return mask ? lhs : rhs; }
+		static F XorBits(F value, I bits) { return std::bit_cast<float>(std::bit_cast<std::uint32_t>(value) ^ bits); }
+
+		static I IAdd(I lhs, I rhs) { return lhs + rhs; }
+		static I IMul(I lhs, I rhs) { return lhs * rhs; }
+		static I IXor(I lhs, I rhs) { return lhs ^ rhs; }
+		static I IAnd(I lhs, I rhs) { return lhs & rhs; }
+		template <int N>
+		static I IShr(I value)
+		{
+			return value >> N;
+		}
+		template <int N>
+		static I IShl(I value)
+		{
+			return value << N;
+		}
+	};
+
+#if defined(__AVX2__)
+	struct WideLanes
+	{
+	public:
+		using F = __m256;
+		using I = __m256i;
+		using M = __m256;
+
+		static constexpr std::size_t Width = 8;
+
+		static F    Set(float value) { return _mm256_set1_ps(value); }
+		static I    SetI(std::uint32_t value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+		static I    Index(std::size_t first) { return _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); }
+		static void Store(float* out, F value) { _mm256_storeu_ps(out, value); }
+
+		static F Add(F lhs, F rhs) { return _mm256_add_ps(lhs, rhs); }
+		static F Sub(F lhs, F rhs) { return _mm256_sub_ps(lhs, rhs); }
+		static F Mul(F lhs, F rhs) { return _mm256_mul_ps(lhs, rhs); }
+		static F Max(F lhs, F rhs) { return _mm256_max_ps(lhs, rhs); }
+		static F Floor(F value)
+		{
+			F truncated = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(value));
+			return _mm256_sub_ps(truncated, _mm256_and_ps(_mm256_cmp_ps(truncated, value, _CMP_GT_OQ), _mm256_set1_ps(1.0f)));
+		}
+		static I ToInt(F value) { return _mm256_cvttps_epi32(value); }
+		static F ToFloat(I value) { return _mm256_cvtepi32_ps(value); }
+
+		static M LessThan(F lhs, F rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ); }
+		static M IsZero(I value) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(value, _mm256_setzero_si256())); }
+		static M Equal(I lhs, I rhs) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(lhs, rhs)); }
+		static F Select(M mask, F lhs, F rhs) { return _mm256_blendv_ps(rhs, lhs, mask); }
+		static F XorBits(F value, I bits) { return _mm256_xor_ps(value, _mm256_castsi256_ps(bits)); }
+
+		static I IAdd(I lhs, I rhs) { return _mm256_add_epi32(lhs, rhs); }
+		static I IMul(I lhs, I rhs) { return _mm256_mullo_epi32(lhs, rhs); }
+		static I IXor(I lhs, I rhs) { return _mm256_xor_si256(lhs, rhs); }
+		static I IAnd(I lhs, I rhs) { return _mm256_and_si256(lhs, rhs); }
+		template <int N>
+		static I IShr(I value)
+		{
+			return _mm256_srli_epi32(value, N);
+		}
+		template <int N>
+		static I IShl(I value)
+		{
+			return _mm256_slli_epi32(value, N);
+		}
+	};
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+	struct WideLanes
+	{
+	public:
+		using F = __m128;
+		using I = __m128i;
+		using M = __m128;
+
+		static constexpr std::size_t Width = 4;
+
+		static F    Set(float value) { return _mm_set1_ps(value); }
+		static I    SetI(std::uint32_t value) { return _mm_set1_epi32(static_cast<int>(value)); }
+		static I    Index(std::size_t first) { return _mm_add_epi32(_mm_set1_epi32(static_cast<int>(first)), _mm_setr_epi32(0, 1, 2, 3)); }
+		static void Store(float* out, F value) { _mm_storeu_ps(out, value); }
+
+		static F Add(F lhs, F rhs) { return _mm_add_ps(lhs, rhs); }
+		static F Sub(F lhs, F rhs) { return _mm_sub_ps(lhs, rhs); }
+		static F Mul(F lhs, F rhs) { return _mm_mul_ps(lhs, rhs); }
+		static F Max(F lhs, F rhs) { return _mm_max_ps(lhs, rhs); }
+		static F Floor(F value)
+		{
+			F truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+			return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f)));
+		}
+		static I ToInt(F value) { return _mm_cvttps_epi32(value); }
+		static F ToFloat(I value) { return _mm_cvtepi32_ps(value); }
+
+		static M LessThan(F lhs, F rhs) { return _mm_cmplt_ps(lhs, rhs); }
+		static M IsZero(I value) { return _mm_castsi128_ps(_mm_cmpeq_epi32(value, _mm_setzero_si128())); }
+		static M Equal(I lhs, I rhs) { return _mm_castsi128_ps(_mm_cmpeq_epi32(lhs, rhs)); }
+		static F Select(M mask, F lhs, F rhs) { return _mm_or_ps(_mm_and_ps(mask, lhs), _mm_andnot_ps(mask, rhs)); }
+		static F XorBits(F value, I bits) { return _mm_xor_ps(value, _mm_castsi128_ps(bits)); }
+
+		static I IAdd(I lhs, I rhs) { return _mm_add_epi32(lhs, rhs); }
+		static I IXor(I lhs, I rhs) { return _mm_xor_si128(lhs, rhs); }
+		static I IAnd(I lhs, I rhs) { return _mm_and_si128(lhs, rhs); }
+		static I IMul(I lhs, I rhs)
+		{
+			// SSE2 has no 32 bit multiply, multiply the even and odd lanes as 64 bit and interleave the low halves.
+			I even = _mm_mul_epu32(lhs, rhs);
+			I odd  = _mm_mul_epu32(_mm_srli_epi64(lhs, 32), _mm_srli_epi64(rhs, 32));
+			return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		}
+		template <int N>
+		static I IShr(I value)
+		{
+			return _mm_srli_epi32(value, N);
+		}
+		template <int N>
+		static I IShl(I value)
+		{
+			return _mm_slli_epi32(value, N);
+		}
+	};
+#else
+	using WideLanes = ScalarLanes;
+#endif
+
+	template <class V>
+	typename V::F Fade(typename V::F t)
+	{
+		return V::Mul(V::Mul(V::Mul(t, t), t), V::Add(V::Mul(t, V::Sub(V::Mul(t, V::Set(6.0f)), V::Set(15.0f))), V::Set(10.0f)));
+	}
+
+	template <class V>
+	typename V::F Lerp(typename V::F a, typename V::F b, typename V::F t)
+	{
+		return V::Add(a, V::Mul(t, V::Sub(b, a)));
+	}
+
+	template <class V>
+	typename V::I FinishHash(typename V::I hash)
+	{
+		hash = V::IMul(hash, V::SetI(HashMultiplier));
+		return V::IXor(hash, V::template IShr<15>(hash));
+	}
+
+	// Perlin rows keep y and z fixed, their lattice terms are computed once per row on the scalar path.
+	struct LatticeAxis
+	{
+	public:
+		float         m_Offset0; // Distance from the lower lattice line
+		float         m_Offset1; // Distance from the upper lattice line
+		float         m_Fade;
+		std::uint32_t m_Prime0; // Lower lattice coordinate * prime
+		std::uint32_t m_Prime1;
+	};
+
+	// Diagonal gradients, bit 2 swaps the axes and bits 0 and 1 flip the signs.
+	template <class V>
+	typename V::F Gradient(typename V::I hash, typename V::F x, typename V::F y)
+	{
+		typename V::M swap = V::IsZero(V::IAnd(hash, V::SetI(4)));
+		typename V::F u    = V::Select(swap, x, y);
+		typename V::F v    = V::Select(swap, y, x);
+		return V::Add(V::XorBits(u, V::template IShl<31>(hash)), V::XorBits(v, V::template IShl<30>(V::IAnd(hash, V::SetI(2)))));
+	}
+
+	// The 12 cube edge gradients from improved Perlin noise.
+	template <class V>
+	typename V::F Gradient(typename V::I hash, typename V::F x, typename V::F y, typename V::F z)
+	{
+		typename V::F u = V::Select(V::IsZero(V::IAnd(hash, V::SetI(8))), x, y);
+		typename V::F v = V::Select(V::IsZero(V::IAnd(hash, V::SetI(12))), y, V::Select(V::Equal(V::IAnd(hash, V::SetI(13)), V::SetI(12)), x, z));
+		return V::Add(V::XorBits(u, V::template IShl<31>(hash)), V::XorBits(v, V::template IShl<30>(V::IAnd(hash, V::SetI(2)))));
+	}
+
+	LatticeAxis MakeLatticeAxis(float value, std::uint32_t prime)
+	{
+		using V = ScalarLanes;
+
+		float         lower  = V::Floor(value);
+		float         offset = V::Sub(value, lower);
+		std::uint32_t prime0 = V::IMul(V::ToInt(lower), prime);
+		return { offset, V::Sub(offset, 1.0f), Fade<V>(offset), prime0, V::IAdd(prime0, prime) };
+	}
+
+	template <class V>
+	typename V::F Perlin(std::uint32_t seed, typename V::F x, const LatticeAxis& y)
+	{
+		typename V::F x0  = V::Floor(x);
+		typename V::F fx0 = V::Sub(x, x0);
+		typename V::F fx1 = V::Sub(fx0, V::Set(1.0f));
+		typename V::F fy0 = V::Set(y.m_Offset0);
+		typename V::F fy1 = V::Set(y.m_Offset1);
+		typename V::F u   = Fade<V>(fx0);
+
+		typename V::I px0 = V::IMul(V::ToInt(x0), V::SetI(PrimeX));
+		typename V::I px1 = V::IAdd(px0, V::SetI(PrimeX));
+		typename V::I s0  = V::SetI(seed ^ y.m_Prime0);
+		typename V::I s1  = V::SetI(seed ^ y.m_Prime1);
+
+		return Lerp<V>(Lerp<V>(Gradient<V>(FinishHash<V>(V::IXor(px0, s0)), fx0, fy0), Gradient<V>(FinishHash<V>(V::IXor(px1, s0)), fx1, fy0), u),
+		               Lerp<V>(Gradient<V>(FinishHash<V>(V::IXor(px0, s1)), fx0, fy1), Gradient<V>(FinishHash<V>(V::IXor(px1, s1)), fx1, fy1), u),
+		               V::Set(y.m_Fade));
+	}
+
+	template <class V>
+	typename V::F Perlin(std::uint32_t seed, typename V::F x, const LatticeAxis& y, const LatticeAxis& z)
+	{
+		typename V::F x0  = V::Floor(x);
+		typename V::F fx0 = V::Sub(x, x0);
+		typename V::F fx1 = V::Sub(fx0, V::Set(1.0f));
+		typename V::F fy0 = V::Set(y.m_Offset0);
+		typename V::F fy1 = V::Set(y.m_Offset1);
+		typename V::F fz0 = V::Set(z.m_Offset0);
+		typename V::F fz1 = V::Set(z.m_Offset1);
+		typename V::F u   = Fade<V>(fx0);
+		typename V::F v   = V::Set(y.m_Fade);
+
+		typename V::I px0 = V::IMul(V::ToInt(x0), V::SetI(PrimeX));
+		typename V::I px1 = V::IAdd(px0, V::SetI(PrimeX));
+		typename V::I s00 = V::SetI(seed ^ y.m_Prime0 ^ z.m_Prime0);
+		typename V::I s10 = V::SetI(seed ^ y.m_Prime1 ^ z.m_Prime0);
+		typename V::I s01 = V::SetI(seed ^ y.m_Prime0 ^ z.m_Prime1);
+		typename V::I s11 = V::SetI(seed ^ y.m_Prime1 ^ z.m_Prime1);
+
+		typename V::F lowerZ = Lerp<V>(Lerp<V>(Gradient<V>(FinishHash<V>(V::IXor(px0, s00)), fx0, fy0, fz0), Gradient<V>(FinishHash<V>(V::IXor(px1, s00)), fx1, fy0, fz0), u),
+		                               Lerp<V>(Gradient<V>(FinishHash<V>(V::IXor(px0, s10)), fx0, fy1, fz0), Gradient<V>(FinishHash<V>(V::IXor(px1, s10)), fx1, fy1, fz0), u),
+		                               v);
+		typename V::F upperZ = Lerp<V>(Lerp<V>(Gradient<V>(FinishHash<V>(V::IXor(px0, s01)), fx0, fy0, fz1), Gradient<V>(FinishHash<V>(V::IXor(px1, s01)), fx1, fy0, fz1), u),
+		                               Lerp<V>(Gradient<V>(FinishHash<V>(V::IXor(px0, s11)), fx0, fy1, fz1), Gradient<V>(FinishHash<V>(V::IXor(px1, s11)), fx1, fy1, fz1), u),
+		                               v);
+		return Lerp<V>(lowerZ, upperZ, V::Set(z.m_Fade));
+	}
+
+	template <class V>
+	typename V::F SimplexCorner(typename V::I hash, typename V::F x, typename V::F y)
+	{
+		typename V::F t = V::Max(V::Sub(V::Set(0.5f), V::Add(V::Mul(x, x), V::Mul(y, y))), V::Set(0.0f));
+		t               = V::Mul(t, t);
+		return V::Mul(V::Mul(t, t), Gradient<V>(hash, x, y));
+	}
+
+	template <class V>
+	typename V::F Simplex(typename V::I seed, typename V::F x, typename V::F y)
+	{
+		typename V::F skew = V::Mul(V::Add(x, y), V::Set(SimplexSkew));
+		typename V::F i    = V::Floor(V::Add(x, skew));
+		typename V::F j    = V::Floor(V::Add(y, skew));
+		typename V::F t    = V::Mul(V::Add(i, j), V::Set(SimplexUnskew));
+		typename V::F x0   = V::Sub(x, V::Sub(i, t));
+		typename V::F y0   = V::Sub(y, V::Sub(j, t));
+
+		// The lower triangle steps along x first, the upper one along y.
+		typename V::M lower = V::LessThan(y0, x0);
+		typename V::F i1    = V::Select(lower, V::Set(1.0f), V::Set(0.0f));
+		typename V::F j1    = V::Select(lower, V::Set(0.0f), V::Set(1.0f));
+		typename V::F x1    = V::Add(V::Sub(x0, i1), V::Set(SimplexUnskew));
+		typename V::F y1    = V::Add(V::Sub(y0, j1), V::Set(SimplexUnskew));
+		typename V::F x2    = V::Add(V::Sub(x0, V::Set(1.0f)), V::Set(2.0f * SimplexUnskew));
+		typename V::F y2    = V::Add(V::Sub(y0, V::Set(1.0f)), V::Set(2.0f * SimplexUnskew));
+
+		typename V::I pi = V::IMul(V::ToInt(i), V::SetI(PrimeX));
+		typename V::I pj = V::IMul(V::ToInt(j), V::SetI(PrimeY));
+		typename V::I h0 = FinishHash<V>(V::IXor(V::IXor(seed, pi), pj));
+		typename V::I h1 = FinishHash<V>(V::IXor(V::IXor(seed, V::IAdd(pi, V::IMul(V::ToInt(i1), V::SetI(PrimeX)))), V::IAdd(pj, V::IMul(V::ToInt(j1), V::SetI(PrimeY)))));
+		typename V::I h2 = FinishHash<V>(V::IXor(V::IXor(seed, V::IAdd(pi, V::SetI(PrimeX))), V::IAdd(pj, V::SetI(PrimeY))));
+
+		typename V::F sum = V::Add(V::Add(SimplexCorner<V>(h0, x0, y0), SimplexCorner<V>(h1, x1, y1)), SimplexCorner<V>(h2, x2, y2));
+		return V::Mul(sum, V::Set(SimplexScale));
+	}
+
+	template <class V, class K>
+	std::size_t RunRow(float x, float step, std::size_t first, std::size_t count, float* out, K& kernel)
+	{
+		std::size_t i = first;
+		for (; i + V::Width <= count; i += V::Width)
+			V::Store(out + i, kernel(V {}, V::Add(V::Set(x), V::Mul(V::ToFloat(V::Index(i)), V::Set(step)))));
+		return i;
+	}
+
+	// Runs kernel(lanes, xs) over the row, wide lanes first and single floats for the tail.
+	template <class K>
+	void Row(float x, float step, std::size_t count, float* out, K&& kernel)
+	{
+		std::size_t i = RunRow<WideLanes>(x, step, 0, count, out, kernel);
+		RunRow<ScalarLanes>(x, step, i, count, out, kernel);
+	}
+
+	void PerlinRow(std::uint32_t seed, float x, float y, float step, std::size_t count, float* out)
+	{
+		LatticeAxis yAxis = MakeLatticeAxis(y, PrimeY);
+		Row(x, step, count, out, [&](auto lanes, auto xs) {
+			using V = decltype(lanes);
+			return Perlin<V>(seed, xs, yAxis);
+		});
+	}
+
+	void PerlinRow(std::uint32_t seed, float x, float y, float z, float step, std::size_t count, float* out)
+	{
+		LatticeAxis yAxis = MakeLatticeAxis(y, PrimeY);
+		LatticeAxis zAxis = MakeLatticeAxis(z, PrimeZ);
+		Row(x, step, count, out, [&](auto lanes, auto xs) {
+			using V = decltype(lanes);
+			return Perlin<V>(seed, xs, yAxis, zAxis);
+		});
+	}
+
+	void SimplexRow(std::uint32_t seed, float x, float y, float step, std::size_t count, float* out)
+	{
+		Row(x, step, count, out, [&](auto lanes, auto xs) {
+			using V = decltype(lanes);
+			return Simplex<V>(V::SetI(seed), xs, V::Set(y));
+		});
+	}
+
+	template <class F>
+	void FractalRow(std::uint32_t seed, const NoiseFractal& fractal, std::size_t count, float* out, F&& octaveRow)
+	{
+		thread_local std::vector<float> octave;
+		octave.resize(count);
+		std::fill_n(out, count, 0.0f);
+
+		float frequency = 1.0f;
+		float amplitude = 1.0f;
+		float total     = 0.0f;
+		for (std::uint32_t i = 0; i < fractal.m_Octaves; ++i)
+		{
+			octaveRow(seed + i * OctaveSeedStep, frequency, octave.data());
+			for (std::size_t j = 0; j < count; ++j)
+				out[j] += octave[j] * amplitude;
+
+			total += amplitude;
+			frequency *= fractal.m_Lacunarity;
+			amplitude *= fractal.m_Gain;
+		}
+
+		if (total > 0.0f)
+		{
+			float scale = 1.0f / total;
+			for (std::size_t j = 0; j < count; ++j)
+				out[j] *= scale;
+		}
+	}
+} // namespace
+
+Noise::Noise(std::uint32_t seed)
+    : m_Seed(seed) {}
+
+void Noise::perlinRow(float x, float y, float step, std::size_t count, float* out) const
+{
+	PerlinRow(m_Seed, x, y, step, count, out);
+}
+
+void Noise::perlinRow(float x, float y, float z, float step, std::size_t count, float* out) const
+{
+	PerlinRow(m_Seed, x, y, z, step, count, out);
+}
+
+void Noise::simplexRow(float x, float y, float step, std::size_t count, float* out) const
+{
+	SimplexRow(m_Seed, x, y, step, count, out);
+}
+
+void Noise::fractalRow(ENoiseType type, const NoiseFractal& fractal, float x, float y, float step, std::size_t count, float* out) const
+{
+	FractalRow(m_Seed, fractal, count, out, [&](std::uint32_t seed, float frequency, float* octave) {
+		if (type == ENoiseType::Simplex)
+			SimplexRow(seed, x * frequency, y * frequency, step * frequency, count, octave);
+		else
+			PerlinRow(seed, x * frequency, y * frequency, step * frequency, count, octave);
+	});
+}
+
+void Noise::fractalRow(const NoiseFractal& fractal, float x, float y, float z, float step, std::size_t count, float* out) const
+{
+	FractalRow(m_Seed, fractal, count, out, [&](std::uint32_t seed, float frequency, float* octave) {
+		PerlinRow(seed, x * frequency, y * frequency, z * frequency, step * frequency, count, octave);
+	});
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class ENoiseType : std::uint8_t
+{
+	Perlin,
+	Simplex
+};
+
+struct NoiseFractal
+{
+public:
+	std::uint32_t m_Octaves    = 4;
+	float         m_Lacunarity = 2.0f; // Frequency multiplier per octave
+	float         m_Gain       = 0.5f; // Amplitude multiplier per octave
+};
+
+// Seeded gradient (Perlin) and simplex noise, evaluated a row at a time.
+// A row is count samples starting at (x, y[, z]) and stepping step along x. The bulk of a row runs 8 (AVX2) or 4 (SSE2)
+// samples per iteration, the tail runs the same operations on single floats, so results do not depend on the
+// instruction set or the row length. Results are roughly within [-1, 1].
+class Noise
+{
+public:
+	Noise(std::uint32_t seed = 0);
+
+	void perlinRow(float x, float y, float step, std::size_t count, float* out) const;
+	void perlinRow(float x, float y, float z, float step, std::size_t count, float* out) const;
+	void simplexRow(float x, float y, float step, std::size_t count, float* out) const;
+
+	// Sums octaves of type, every octave uses its own seed. The result is normalised by the total amplitude.
+	void fractalRow(ENoiseType type, const NoiseFractal& fractal, float x, float y, float step, std::size_t count, float* out) const;
+	void fractalRow(const NoiseFractal& fractal, float x, float y, float z, float step, std::size_t count, float* out) const;
+
+	auto getSeed() const { return m_Seed; }
+
+private:
+	std::uint32_t m_Seed;
+};
@@ -0,0 +1,258 @@
+#include "TerrainGenerator.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// Generated chunks are packed with a fixed palette at 4 bits per voxel and compacted afterwards.
+	enum ETerrainIndex : std::uint64_t
+	{
+		Air = 0,
+		Stone,
+		Dirt,
+		Grass,
+		Water
+	};
+
+	constexpr std::uint32_t IndexBits      = 4;
+	constexpr std::size_t   IndicesPerWord = 64 / IndexBits;
+
+	// Cave noise is sampled every CaveStep voxels and interpolated in between.
+	constexpr std::uint32_t CaveStep    = 4;
+	constexpr std::uint32_t CaveSamples = Chunk::Size / CaveStep + 1;
+
+	// Noise positions are computed in double so far away chunks keep their offset, the row itself steps in float.
+	float NoisePosition(std::int64_t voxel, float frequency)
+	{
+		return static_cast<float>(static_cast<double>(voxel) * frequency);
+	}
+} // namespace
+
+TerrainGenerator::TerrainGenerator(const TerrainSettings& settings, std::size_t maxCachedColumns)
+    : m_Settings(settings),
+      m_HeightNoise(settings.m_Seed),
+      m_CaveNoise(settings.m_Seed ^ 0x5BD1'E995U),
+      m_MaxCachedColumns(std::max<std::size_t>(maxCachedColumns, 1)) {}
+
+void TerrainGenerator::generate(Chunk& chunk)
+{
+	ChunkCoord coord  = chunk.getCoord();
+	auto       column = getColumn(coord.m_X, coord.m_Y);
+
+	bool         hasWater = m_Settings.m_WaterState != Chunk::EmptyState;
+	bool         hasCaves = m_Settings.m_CaveThreshold > 0.0f;
+	std::int64_t baseZ    = coord.m_Z * static_cast<std::int64_t>(Chunk::Size);
+	std::int64_t top      = hasWater ? std::max(column->m_MaxHeight, m_Settings.m_SeaLevel) : column->m_MaxHeight;
+	if (baseZ >= top)
+		return;
+
+	if (!hasCaves && baseZ + static_cast<std::int64_t>(Chunk::Size) <= column->m_MinHeight - 1 - m_Settings.m_DirtDepth)
+	{
+		chunk.fill(m_Settings.m_StoneState);
+		return;
+	}
+
+	ChunkStorage::Words                                        words(ChunkStorage::VoxelCount / IndicesPerWord, 0);
+	std::array<std::uint64_t, Chunk::Size>                     indices;
+	std::array<float, CaveSamples * CaveSamples * CaveSamples> caveGrid;
+	std::array<float, CaveSamples>                             caveRow;
+
+	// Stone only exists below the dirt layer of the highest column.
+	hasCaves = hasCaves && baseZ < column->m_MaxHeight - 1 - m_Settings.m_DirtDepth;
+	if (hasCaves)
+	{
+		float frequency = m_Settings.m_CaveFrequency;
+		float caveX     = NoisePosition(coord.m_X * static_cast<std::int64_t>(Chunk::Size), frequency);
+		for (std::uint32_t z = 0; z < CaveSamples; ++z)
+		{
+			float caveZ = NoisePosition(baseZ + z * CaveStep, frequency);
+			for (std::uint32_t y = 0; y < CaveSamples; ++y)
+			{
+				float caveY = NoisePosition(coord.m_Y * static_cast<std::int64_t>(Chunk::Size) + y * CaveStep, frequency);
+				m_CaveNoise.perlinRow(caveX, caveY, caveZ, frequency * CaveStep, CaveSamples, caveGrid.data() + (y + z * CaveSamples) * CaveSamples);
+			}
+		}
+	}
+
+	for (std::uint32_t z = 0; z < Chunk::Size; ++z)
+	{
+		std::int64_t worldZ = baseZ + z;
+		for (std::uint32_t y = 0; y < Chunk::Size; ++y)
+		{
+			bool anyStone = false;
+			for (std::uint32_t x = 0; x < Chunk::Size; ++x)
+			{
+				std::int64_t height = column->m_Heights[x + y * Chunk::Size];
+				if (worldZ >= height)
+					indices[x] = hasWater && worldZ < m_Settings.m_SeaLevel ? Water : Air;
+				else if (worldZ == height - 1)
+					indices[x] = Grass;
+				else if (worldZ >= height - 1 - m_Settings.m_DirtDepth)
+					indices[x] = Dirt;
+				else
+					indices[x] = Stone;
+				anyStone |= indices[x] == Stone;
+			}
+
+			// Caves only carve stone, so the surface stays closed.
+			if (hasCaves && anyStone)
+			{
+				std::uint32_t gy = y / CaveStep;
+				std::uint32_t gz = z / CaveStep;
+				float         ty = static_cast<float>(y % CaveStep) / CaveStep;
+				float         tz = static_cast<float>(z % CaveStep) / CaveStep;
+				for (std::uint32_t i = 0; i < CaveSamples; ++i)
+				{
+					auto  sample = [&](std::uint32_t sy, std::uint32_t sz) { return caveGrid[i + (sy + sz * CaveSamples) * CaveSamples]; };
+					float lowerZ = sample(gy, gz) + (sample(gy + 1, gz) - sample(gy, gz)) * ty;
+					float upperZ = sample(gy, gz + 1) + (sample(gy + 1, gz + 1) - sample(gy, gz + 1)) * ty;
+					caveRow[i]   = lowerZ + (upperZ - lowerZ) * tz;
+				}
+
+				for (std::uint32_t x = 0; x < Chunk::Size; ++x)
+				{
+					std::uint32_t gx   = x / CaveStep;
+					float         tx   = static_cast<float>(x % CaveStep) / CaveStep;
+					float         cave = caveRow[gx] + (caveRow[gx + 1] - caveRow[gx]) * tx;
+					if (indices[x] == Stone && std::fabs(cave) < m_Settings.m_CaveThreshold)
+						indices[x] = Air;
+				}
+			}
+
+			std::size_t first = Chunk::PositionToIndex(0, y, z);
+			for (std::uint32_t x = 0; x < Chunk::Size; ++x)
+				words[(first + x) / IndicesPerWord] |= indices[x] << (((first + x) % IndicesPerWord) * IndexBits);
+		}
+	}
+
+	auto& voxels = chunk.getVoxels();
+	voxels.assign({ Chunk::EmptyState, m_Settings.m_StoneState, m_Settings.m_DirtState, m_Settings.m_GrassState, m_Settings.m_WaterState }, std::move(words));
+	voxels.compact();
+	chunk.markDirty();
+	chunk.markUnsaved();
+}
+
+void TerrainGenerator::generateLod(Chunk& node, std::uint32_t level)
+{
+	if (level == 0)
+	{
+		generate(node);
+		return;
+	}
+
+	ChunkCoord   coord    = node.getCoord();
+	std::int64_t cellSize = 1LL << level;
+	std::int64_t nodeSize = cellSize * static_cast<std::int64_t>(Chunk::Size);
+
+	// Heights are sampled at the cell centres, so a node costs as much noise as a single chunk column.
+	std::array<std::int32_t, Chunk::Size * Chunk::Size> heights;
+	std::array<float, Chunk::Size>                      row;
+	std::int32_t                                        maxHeight = INT32_MIN;
+	float                                               frequency = m_Settings.m_HeightFrequency;
+	std::int64_t                                        originX   = coord.m_X * nodeSize + cellSize / 2;
+	std::int64_t                                        originY   = coord.m_Y * nodeSize + cellSize / 2;
+	for (std::uint32_t y = 0; y < Chunk::Size; ++y)
+	{
+		m_HeightNoise.fractalRow(ENoiseType::Simplex, m_Settings.m_HeightFractal, NoisePosition(originX, frequency), NoisePosition(originY + y * cellSize, frequency), frequency * cellSize, Chunk::Size, row.data());
+		for (std::uint32_t i = 0; i < Chunk::Size; ++i)
+		{
+			std::int32_t height             = static_cast<std::int32_t>(std::floor(m_Settings.m_BaseHeight + row[i] * m_Settings.m_HeightAmplitude));
+			heights[i + y * Chunk::Size] = height;
+			maxHeight                    = std::max(maxHeight, height);
+		}
+	}
+
+	bool         hasWater = m_Settings.m_WaterState != Chunk::EmptyState;
+	std::int64_t baseZ    = coord.m_Z * nodeSize;
+	if (baseZ >= (hasWater ? std::max(maxHeight, m_Settings.m_SeaLevel) : maxHeight))
+		return;
+
+	ChunkStorage::Words words(ChunkStorage::VoxelCount / IndicesPerWord, 0);
+	for (std::uint32_t z = 0; z < Chunk::Size; ++z)
+	{
+		std::int64_t cellZ = baseZ + z * cellSize;
+		for (std::uint32_t y = 0; y < Chunk::Size; ++y)
+		{
+			std::size_t first = Chunk::PositionToIndex(0, y, z);
+			for (std::uint32_t x = 0; x < Chunk::Size; ++x)
+			{
+				// The highest solid voxel of the cell decides between grass, dirt and stone.
+				std::int64_t  height = heights[x + y * Chunk::Size];
+				std::int64_t  top    = std::min(cellZ + cellSize, height) - 1;
+				std::uint64_t index;
+				if ((top - cellZ + 1) * 2 < cellSize)
+					index = hasWater && cellZ + cellSize / 2 < m_Settings.m_SeaLevel ? Water : Air;
+				else if (top == height - 1)
+					index = Grass;
+				else if (top >= height - 1 - m_Settings.m_DirtDepth)
+					index = Dirt;
+				else
+					index = Stone;
+				words[(first + x) / IndicesPerWord] |= index << (((first + x) % IndicesPerWord) * IndexBits);
+			}
+		}
+	}
+
+	auto& voxels = node.getVoxels();
+	voxels.assign({ Chunk::EmptyState, m_Settings.m_StoneState, m_Settings.m_DirtState, m_Settings.m_GrassState, m_Settings.m_WaterState }, std::move(words));
+	voxels.compact();
+	node.markDirty();
+}
+
+std::array<std::int32_t, Chunk::Size * Chunk::Size> TerrainGenerator::getHeights(std::int64_t chunkX, std::int64_t chunkY)
+{
+	return getColumn(chunkX, chunkY)->m_Heights;
+}
+
+std::shared_ptr<const TerrainGenerator::Column> TerrainGenerator::getColumn(std::int64_t chunkX, std::int64_t chunkY)
+{
+	ChunkCoord key { chunkX, chunkY, 0 };
+	{
+		std::lock_guard lock(m_ColumnMutex);
+		auto            itr = m_Columns.find(key);
+		if (itr != m_Columns.end())
+			return itr->second;
+	}
+
+	// Built outside the lock, two threads racing on the same column compute identical data.
+	auto column = buildColumn(chunkX, chunkY);
+
+	std::lock_guard lock(m_ColumnMutex);
+	auto [itr, inserted] = m_Columns.try_emplace(key, std::move(column));
+	if (inserted)
+	{
+		m_ColumnOrder.push_back(key);
+		while (m_Columns.size() > m_MaxCachedColumns)
+		{
+			m_Columns.erase(m_ColumnOrder.front());
+			m_ColumnOrder.pop_front();
+		}
+	}
+	return itr->second;
+}
+
+std::shared_ptr<const TerrainGenerator::Column> TerrainGenerator::buildColumn(std::int64_t chunkX, std::int64_t chunkY) const
+{
+	auto column         = std::make_shared<Column>();
+	column->m_MinHeight = INT32_MAX;
+	column->m_MaxHeight = INT32_MIN;
+
+	float                          frequency = m_Settings.m_HeightFrequency;
+	float                          x         = NoisePosition(chunkX * static_cast<std::int64_t>(Chunk::Size), frequency);
+	std::array<float, Chunk::Size> row;
+	for (std::uint32_t y = 0; y < Chunk::Size; ++y)
+	{
+		m_HeightNoise.fractalRow(ENoiseType::Simplex, m_Settings.m_HeightFractal, x, NoisePosition(chunkY * static_cast<std::int64_t>(Chunk::Size) + y, frequency), frequency, Chunk::Size, row.data());
+		for (std::uint32_t i = 0; i < Chunk::Size; ++i)
+		{
+			std::int32_t height                    = static_cast<std::int32_t>(std::floor(m_Settings.m_BaseHeight + row[i] * m_Settings.m_HeightAmplitude));
+			column->m_Heights[i + y * Chunk::Size] = height;
+			column->m_MinHeight                    = std::min(column->m_MinHeight, height);
+			column->m_MaxHeight                    = std::max(column->m_MaxHeight, height);
+		}
+	}
+	return column;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Carbonite/World/Chunk.h"
+#include "Carbonite/World/ChunkCoord.h"
+#include "Noise.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct TerrainSettings
+{
+public:
+	std::uint32_t m_Seed = 0;
+
+	// Surface height in voxels: m_BaseHeight + fractal simplex noise * m_HeightAmplitude.
+	NoiseFractal m_HeightFractal   = { 5, 2.0f, 0.5f };
+	float        m_HeightFrequency = 1.0f / 256.0f;
+	float        m_BaseHeight      = 0.0f;
+	float        m_HeightAmplitude = 48.0f;
+	std::int32_t m_DirtDepth       = 3;
+	std::int32_t m_SeaLevel        = 0;
+
+	// Tunnels are carved where |perlin noise| < m_CaveThreshold, 0 disables caves.
+	float m_CaveFrequency = 1.0f / 40.0f;
+	float m_CaveThreshold = 0.06f;
+
+	std::uint64_t m_StoneState = 0;
+	std::uint64_t m_DirtState  = 1;
+	std::uint64_t m_GrassState = 2;
+	std::uint64_t m_WaterState = Chunk::EmptyState; // EmptyState leaves everything below sea level dry
+};
+
+// Fills new chunks with terrain: a 2D heightmap of stone, dirt and grass, water up to sea level and 3D noise caves.
+// The heightmap of a chunk column is computed once and cached, every chunk stacked in that column shares it.
+// Output only depends on the settings and the chunk coordinate, generate() may be called from any number of threads.
+class TerrainGenerator
+{
+public:
+	TerrainGenerator(const TerrainSettings& settings = {}, std::size_t maxCachedColumns = 1024);
+
+	void generate(Chunk& chunk);
+	// Fills a LOD node (see ChunkLod) of the given level straight from the heightmap. Every cell takes the height at its centre
+	// column and is solid when at least half of it is below the surface, caves are left out.
+	void generateLod(Chunk& node, std::uint32_t level);
+
+	// Surface height (world z of the first air voxel) of every column in the chunk column, indexed x + y * Chunk::Size.
+	std::array<std::int32_t, Chunk::Size * Chunk::Size> getHeights(std::int64_t chunkX, std::int64_t chunkY);
+
+	auto& getSettings() const { return m_Settings; }
+
+private:
+	struct Column
+	{
+	public:
+		std::array<std::int32_t, Chunk::Size * Chunk::Size> m_Heights;
+		std::int32_t                                        m_MinHeight;
+		std::int32_t                                        m_MaxHeight;
+	};
+
+	std::shared_ptr<const Column> getColumn(std::int64_t chunkX, std::int64_t chunkY);
+	std::shared_ptr<const Column> buildColumn(std::int64_t chunkX, std::int64_t chunkY) const;
+
+private:
+	TerrainSettings m_Settings;
+	Noise           m_HeightNoise;
+	Noise           m_CaveNoise;
+
+	std::mutex                                                                    m_ColumnMutex;
+	std::unordered_map<ChunkCoord, std::shared_ptr<const Column>, ChunkCoordHash> m_Columns;
+	std::deque<ChunkCoord>                                                        m_ColumnOrder; // Oldest first
+	std::size_t                                                                   m_MaxCachedColumns;
+};
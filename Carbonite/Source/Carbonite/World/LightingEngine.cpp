@@ -0,0 +1,541 @@
+#include "LightingEngine.h"
+#include "Dimension.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+	constexpr std::uint32_t LastSlice = Chunk::Size - 1;
+
+	// Index of the voxel at (u, v) on the given face of a chunk, u and v are the other two axes in ascending order.
+	std::size_t BorderIndex(EFace face, std::uint32_t u, std::uint32_t v)
+	{
+		std::uint32_t slice = isPositiveFace(face) ? LastSlice : 0;
+		switch (getFaceAxis(face))
+		{
+		case 0: return Chunk::PositionToIndex(slice, u, v);
+		case 1: return Chunk::PositionToIndex(u, slice, v);
+		default: return Chunk::PositionToIndex(u, v, slice);
+		}
+	}
+
+	// Steps index one voxel towards face, returns false if that leaves the chunk. index then refers to the neighbouring chunk.
+	bool StepIndex(std::size_t& index, EFace face)
+	{
+		std::uint32_t position[3] { static_cast<std::uint32_t>(index % Chunk::Size), static_cast<std::uint32_t>((index / Chunk::Size) % Chunk::Size), static_cast<std::uint32_t>(index / (Chunk::Size * Chunk::Size)) };
+		std::uint32_t axis   = getFaceAxis(face);
+		bool          inside = true;
+		if (isPositiveFace(face))
+		{
+			inside         = position[axis] < LastSlice;
+			position[axis] = inside ? position[axis] + 1 : 0;
+		}
+		else
+		{
+			inside         = position[axis] > 0;
+			position[axis] = inside ? position[axis] - 1 : LastSlice;
+		}
+		index = Chunk::PositionToIndex(position[0], position[1], position[2]);
+		return inside;
+	}
+
+	// Level a voxel at level passes on towards face, full sky light falls straight down without dimming.
+	std::uint8_t PassedLevel(ELightChannel channel, std::uint8_t level, EFace face)
+	{
+		if (channel == ELightChannel::Sky && level == ChunkLight::MaxLevel && face == EFace::NegativeZ)
+			return level;
+		return level > 0 ? level - 1 : 0;
+	}
+} // namespace
+
+LightingEngine::LightingEngine(WorkerPool& workers)
+    : m_Workers(workers)
+{
+}
+
+void LightingEngine::chunkLoaded(const ChunkCoord& coord)
+{
+	m_Events.push_back({ coord, 0, 0, EEventType::Loaded });
+}
+
+void LightingEngine::voxelChanged(const ChunkCoord& coord, std::size_t index, std::uint64_t oldState)
+{
+	m_Events.push_back({ coord, oldState, static_cast<std::uint16_t>(index), EEventType::Voxel });
+}
+
+void LightingEngine::regionChanged(const ChunkCoord& coord, std::uint64_t sections)
+{
+	if (sections != 0)
+		m_Events.push_back({ coord, sections, 0, EEventType::Region });
+}
+
+std::size_t LightingEngine::update(const Dimension& dimension)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	m_Stats.m_Events  = m_Events.size();
+	m_Stats.m_Updates = 0;
+	m_Stats.m_Chunks  = 0;
+	if (m_Events.empty())
+	{
+		m_Stats.m_UpdateMilliseconds = 0.0f;
+		return 0;
+	}
+
+	m_Dimension = &dimension;
+	m_Updates   = 0;
+
+	// Seeding runs on this thread only, workers are idle until the first pass.
+	std::vector<ChunkWork*> loaded;
+	for (auto& event : m_Events)
+	{
+		ChunkWork* work = getWork(event.m_Coord);
+		if (!work)
+			continue;
+
+		switch (event.m_Type)
+		{
+		case EEventType::Loaded:
+			seedChunk(*work);
+			loaded.push_back(work);
+			break;
+		case EEventType::Voxel:
+			seedVoxel(*work, event.m_Index, event.m_Data);
+			break;
+		case EEventType::Region:
+			seedRegion(*work, event.m_Data);
+			break;
+		}
+	}
+	m_Events.clear();
+
+	runPass(false);
+	runPass(true);
+
+	// A chunk loaded on top of lit chunks may cut off sky light they assumed to be open.
+	bool shadowed = false;
+	for (ChunkWork* work : loaded)
+		shadowed |= fixShadowedColumns(*work);
+	if (shadowed)
+	{
+		runPass(false);
+		runPass(true);
+	}
+
+	m_Stats.m_Updates = m_Updates;
+	m_Stats.m_Chunks  = m_Works.size();
+	m_Stats.m_TotalUpdates += m_Stats.m_Updates;
+	m_Works.clear();
+	m_Dimension = nullptr;
+
+	m_Stats.m_UpdateMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return m_Stats.m_Updates;
+}
+
+LightingEngine::ChunkWork* LightingEngine::getWork(const ChunkCoord& coord)
+{
+	std::lock_guard lock(m_WorkMutex);
+	auto            itr = m_Works.find(coord);
+	if (itr != m_Works.end())
+		return &itr->second;
+
+	Chunk* chunk = m_Dimension->getChunk(coord);
+	if (!chunk)
+		return nullptr;
+
+	ChunkWork& work = m_Works[coord];
+	work.m_Chunk    = chunk;
+	work.m_Coord    = coord;
+	return &work;
+}
+
+LightingEngine::ChunkWork* LightingEngine::getNeighbourWork(ChunkWork& work, EFace face)
+{
+	std::uint32_t i = static_cast<std::uint32_t>(face);
+	if (!work.m_Resolved[i])
+	{
+		work.m_Neighbours[i] = getWork(work.m_Coord.neighbour(face));
+		work.m_Resolved[i]   = true;
+	}
+	return work.m_Neighbours[i];
+}
+
+void LightingEngine::seedChunk(ChunkWork& work)
+{
+	auto& voxels = work.m_Chunk->getVoxels();
+	auto& light  = work.m_Chunk->getLight();
+
+	ChunkWork* above   = getNeighbourWork(work, EFace::PositiveZ);
+	bool       openSky = !above || (above->m_Chunk->getLight().isUniform() && above->m_Chunk->getLight().getUniform(ELightChannel::Sky) == ChunkLight::MaxLevel);
+	if (voxels.isUniform() && !isOpaque(voxels.get(0)) && getEmission(voxels.get(0)) == 0 && openSky)
+	{
+		// Open air under the sky, no need to flood it voxel by voxel.
+		light.fill(0, ChunkLight::MaxLevel);
+		for (std::uint32_t f = 0; f < FaceCount; ++f)
+		{
+			EFace face = static_cast<EFace>(f);
+			if (!getNeighbourWork(work, face))
+				continue;
+
+			std::uint8_t level = PassedLevel(ELightChannel::Sky, ChunkLight::MaxLevel, face);
+			for (std::uint32_t v = 0; v < Chunk::Size; ++v)
+				for (std::uint32_t u = 0; u < Chunk::Size; ++u)
+					send(work, BorderIndex(face, u, v), face, { 0, level, ELightChannel::Sky, ELightOp::Offer, face }, false);
+		}
+	}
+	else
+	{
+		light.fill(0, 0);
+		if (!above)
+		{
+			for (std::uint32_t v = 0; v < Chunk::Size; ++v)
+				for (std::uint32_t u = 0; u < Chunk::Size; ++u)
+					post(work, { static_cast<std::uint16_t>(BorderIndex(EFace::PositiveZ, u, v)), ChunkLight::MaxLevel, ELightChannel::Sky, ELightOp::Offer, EFace::NegativeZ });
+		}
+
+		if (std::any_of(voxels.getPalette().begin(), voxels.getPalette().end(), [this](std::uint64_t state) { return getEmission(state) > 0; }))
+		{
+			voxels.forEach([this, &work](std::size_t index, std::uint64_t state) {
+				if (std::uint8_t emission = getEmission(state))
+					post(work, { static_cast<std::uint16_t>(index), emission, ELightChannel::Block, ELightOp::Source, EFace::PositiveZ });
+			});
+		}
+	}
+
+	// Pull in the light of loaded neighbours.
+	for (std::uint32_t f = 0; f < FaceCount; ++f)
+	{
+		EFace      face      = static_cast<EFace>(f);
+		ChunkWork* neighbour = getNeighbourWork(work, face);
+		if (!neighbour)
+			continue;
+
+		EFace travel         = getOppositeFace(face);
+		auto& neighbourLight = neighbour->m_Chunk->getLight();
+		for (std::uint32_t v = 0; v < Chunk::Size; ++v)
+		{
+			for (std::uint32_t u = 0; u < Chunk::Size; ++u)
+			{
+				std::size_t   from  = BorderIndex(travel, u, v);
+				std::uint16_t index = static_cast<std::uint16_t>(BorderIndex(face, u, v));
+				for (ELightChannel channel : { ELightChannel::Block, ELightChannel::Sky })
+					if (std::uint8_t level = PassedLevel(channel, neighbourLight.get(channel, from), travel))
+						post(work, { index, level, channel, ELightOp::Offer, travel });
+			}
+		}
+	}
+}
+
+void LightingEngine::seedVoxel(ChunkWork& work, std::size_t index, std::uint64_t oldState)
+{
+	auto&         light    = work.m_Chunk->getLight();
+	std::uint64_t newState = work.m_Chunk->getVoxels().get(index);
+	if (newState == oldState)
+		return;
+
+	bool         oldOpaque   = isOpaque(oldState);
+	bool         newOpaque   = isOpaque(newState);
+	std::uint8_t oldEmission = getEmission(oldState);
+	std::uint8_t newEmission = getEmission(newState);
+
+	if (light.get(ELightChannel::Block, index) > 0 && (newOpaque || oldEmission > 0))
+		startRemoval(work, index, ELightChannel::Block);
+	if (newOpaque && light.get(ELightChannel::Sky, index) > 0)
+		startRemoval(work, index, ELightChannel::Sky);
+
+	if (newEmission > 0)
+		post(work, { static_cast<std::uint16_t>(index), newEmission, ELightChannel::Block, ELightOp::Source, EFace::PositiveZ });
+
+	if (oldOpaque && !newOpaque)
+	{
+		// Let the light around flow into the opened voxel.
+		for (std::uint32_t f = 0; f < FaceCount; ++f)
+		{
+			for (ELightChannel channel : { ELightChannel::Block, ELightChannel::Sky })
+				send(work, index, static_cast<EFace>(f), { 0, 0, channel, ELightOp::Spread, static_cast<EFace>(f) }, false);
+		}
+
+		std::size_t above = index;
+		if (!StepIndex(above, EFace::PositiveZ) && !getNeighbourWork(work, EFace::PositiveZ))
+			post(work, { static_cast<std::uint16_t>(index), ChunkLight::MaxLevel, ELightChannel::Sky, ELightOp::Offer, EFace::NegativeZ });
+	}
+}
+
+void LightingEngine::seedRegion(ChunkWork& work, std::uint64_t sections)
+{
+	constexpr std::uint32_t SectionSize = 8;
+
+	auto& voxels = work.m_Chunk->getVoxels();
+	auto& light  = work.m_Chunk->getLight();
+
+	auto inRegion = [sections](std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+		return (sections >> (x / SectionSize + (y / SectionSize) * 4 + (z / SectionSize) * 16)) & 1;
+	};
+	auto forEachVoxel = [sections](auto&& func) {
+		for (std::uint32_t section = 0; section < 64; ++section)
+		{
+			if (!((sections >> section) & 1))
+				continue;
+
+			std::uint32_t baseX = (section % 4) * SectionSize;
+			std::uint32_t baseY = ((section / 4) % 4) * SectionSize;
+			std::uint32_t baseZ = (section / 16) * SectionSize;
+			for (std::uint32_t z = baseZ; z < baseZ + SectionSize; ++z)
+				for (std::uint32_t y = baseY; y < baseY + SectionSize; ++y)
+					for (std::uint32_t x = baseX; x < baseX + SectionSize; ++x)
+						func(x, y, z);
+		}
+	};
+
+	// Light inside the region is cleared outright, only its boundary has to tell the outside what it lost. Outside voxels
+	// that kept their light flow back in during the add pass.
+	forEachVoxel([&](std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+		std::size_t   index = Chunk::PositionToIndex(x, y, z);
+		std::uint32_t position[3] { x, y, z };
+		for (std::uint32_t f = 0; f < FaceCount; ++f)
+		{
+			EFace         face = static_cast<EFace>(f);
+			std::uint32_t axis = getFaceAxis(face);
+			if (isPositiveFace(face) ? position[axis] < Chunk::Size - 1 : position[axis] > 0)
+			{
+				std::uint32_t next[3] { x, y, z };
+				next[axis] += isPositiveFace(face) ? 1 : -1;
+				if (inRegion(next[0], next[1], next[2]))
+					continue;
+			}
+
+			for (ELightChannel channel : { ELightChannel::Block, ELightChannel::Sky })
+			{
+				std::uint8_t level = light.get(channel, index);
+				if (level > 0)
+					send(work, index, face, { 0, level, channel, ELightOp::Remove, face }, false);
+				else
+					send(work, index, face, { 0, 0, channel, ELightOp::Spread, face }, false);
+			}
+		}
+	});
+
+	if (sections == ~0ULL)
+	{
+		light.fill(0, 0);
+	}
+	else
+	{
+		forEachVoxel([&](std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+			std::size_t index = Chunk::PositionToIndex(x, y, z);
+			light.set(ELightChannel::Block, index, 0);
+			light.set(ELightChannel::Sky, index, 0);
+		});
+	}
+
+	bool hasEmitters = std::any_of(voxels.getPalette().begin(), voxels.getPalette().end(), [this](std::uint64_t state) { return getEmission(state) > 0; });
+	bool openSky     = !getNeighbourWork(work, EFace::PositiveZ);
+	if (!hasEmitters && !openSky)
+		return;
+
+	forEachVoxel([&](std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+		std::uint16_t index = static_cast<std::uint16_t>(Chunk::PositionToIndex(x, y, z));
+		if (openSky && z == Chunk::Size - 1)
+			post(work, { index, ChunkLight::MaxLevel, ELightChannel::Sky, ELightOp::Offer, EFace::NegativeZ });
+		if (hasEmitters)
+			if (std::uint8_t emission = getEmission(voxels.get(index)))
+				post(work, { index, emission, ELightChannel::Block, ELightOp::Source, EFace::PositiveZ });
+	});
+}
+
+bool LightingEngine::fixShadowedColumns(ChunkWork& work)
+{
+	ChunkWork* below = getNeighbourWork(work, EFace::NegativeZ);
+	if (!below)
+		return false;
+
+	auto& light      = work.m_Chunk->getLight();
+	auto& belowLight = below->m_Chunk->getLight();
+	bool  shadowed   = false;
+	for (std::uint32_t v = 0; v < Chunk::Size; ++v)
+	{
+		for (std::uint32_t u = 0; u < Chunk::Size; ++u)
+		{
+			std::size_t index = BorderIndex(EFace::PositiveZ, u, v);
+			if (belowLight.get(ELightChannel::Sky, index) == ChunkLight::MaxLevel && light.get(ELightChannel::Sky, BorderIndex(EFace::NegativeZ, u, v)) != ChunkLight::MaxLevel)
+			{
+				startRemoval(*below, index, ELightChannel::Sky);
+				shadowed = true;
+			}
+		}
+	}
+	return shadowed;
+}
+
+void LightingEngine::startRemoval(ChunkWork& work, std::size_t index, ELightChannel channel)
+{
+	auto&        light = work.m_Chunk->getLight();
+	std::uint8_t level = light.get(channel, index);
+	if (level == 0)
+		return;
+
+	light.set(channel, index, 0);
+	++m_Updates;
+	for (std::uint32_t f = 0; f < FaceCount; ++f)
+		send(work, index, static_cast<EFace>(f), { 0, level, channel, ELightOp::Remove, static_cast<EFace>(f) }, false);
+}
+
+void LightingEngine::post(ChunkWork& work, const LightNode& node)
+{
+	// Re-adds found while darkening wait for the add pass, otherwise they could be cleared again by the same removal.
+	bool deferred = node.m_Op != ELightOp::Remove && !m_AddPass;
+	bool schedule = false;
+	{
+		std::lock_guard lock(work.m_InboxMutex);
+		if (deferred)
+		{
+			work.m_Deferred.push_back(node);
+			return;
+		}
+
+		work.m_Inbox.push_back(node);
+		if (!m_InPass)
+			return; // Seeding, runPass() schedules
+
+		schedule         = !work.m_Scheduled;
+		work.m_Scheduled = true;
+	}
+	if (schedule)
+		this->schedule(work);
+}
+
+void LightingEngine::send(ChunkWork& work, std::size_t index, EFace face, LightNode node, bool owner)
+{
+	if (StepIndex(index, face))
+	{
+		node.m_Index = static_cast<std::uint16_t>(index);
+		if (owner && (node.m_Op == ELightOp::Remove) != m_AddPass)
+			work.m_Queue.push_back(node);
+		else
+			post(work, node);
+		return;
+	}
+
+	ChunkWork* neighbour = getNeighbourWork(work, face);
+	if (!neighbour)
+		return;
+
+	node.m_Index = static_cast<std::uint16_t>(index);
+	post(*neighbour, node);
+}
+
+void LightingEngine::schedule(ChunkWork& work)
+{
+	m_Workers.submit([this, &work]() { process(work); });
+}
+
+void LightingEngine::runPass(bool addPass)
+{
+	m_AddPass = addPass;
+	m_InPass  = true;
+
+	std::vector<ChunkWork*> pending;
+	for (auto& [coord, work] : m_Works)
+	{
+		if (addPass)
+		{
+			work.m_Inbox.insert(work.m_Inbox.end(), work.m_Deferred.begin(), work.m_Deferred.end());
+			work.m_Deferred.clear();
+		}
+		if (!work.m_Inbox.empty())
+		{
+			work.m_Scheduled = true;
+			pending.push_back(&work);
+		}
+	}
+	// Workers may add to m_Works once scheduled, so the map is not iterated past this point.
+	for (ChunkWork* work : pending)
+		schedule(*work);
+	m_Workers.wait();
+	m_AddPass = false;
+	m_InPass  = false;
+}
+
+void LightingEngine::process(ChunkWork& work)
+{
+	std::size_t updates = 0;
+	while (true)
+	{
+		{
+			std::lock_guard lock(work.m_InboxMutex);
+			if (work.m_Inbox.empty())
+			{
+				work.m_Scheduled = false;
+				break;
+			}
+			std::swap(work.m_Queue, work.m_Inbox);
+		}
+
+		// Nodes for this chunk are appended while iterating, so index instead of holding references.
+		for (std::size_t i = 0; i < work.m_Queue.size(); ++i)
+			processNode(work, LightNode { work.m_Queue[i] }, updates);
+		work.m_Queue.clear();
+	}
+	m_Updates += updates;
+}
+
+void LightingEngine::processNode(ChunkWork& work, const LightNode& node, std::size_t& updates)
+{
+	auto&        light   = work.m_Chunk->getLight();
+	std::uint8_t current = light.get(node.m_Channel, node.m_Index);
+	switch (node.m_Op)
+	{
+	case ELightOp::Remove:
+	{
+		if (current == 0)
+			break;
+
+		bool litByNode = current < node.m_Level || PassedLevel(node.m_Channel, node.m_Level, node.m_Face) == current;
+		if (!litByNode)
+		{
+			// Brighter than anything the removed light could have given, this voxel has its own source.
+			post(work, { node.m_Index, 0, node.m_Channel, ELightOp::Spread, node.m_Face });
+			break;
+		}
+
+		light.set(node.m_Channel, node.m_Index, 0);
+		++updates;
+		for (std::uint32_t f = 0; f < FaceCount; ++f)
+			send(work, node.m_Index, static_cast<EFace>(f), { 0, current, node.m_Channel, ELightOp::Remove, static_cast<EFace>(f) }, true);
+
+		if (node.m_Channel == ELightChannel::Block)
+			if (std::uint8_t emission = getEmission(work.m_Chunk->getVoxels().get(node.m_Index)))
+				post(work, { node.m_Index, emission, ELightChannel::Block, ELightOp::Source, node.m_Face });
+		break;
+	}
+	case ELightOp::Offer:
+		if (current >= node.m_Level || isOpaque(work.m_Chunk->getVoxels().get(node.m_Index)))
+			break;
+		light.set(node.m_Channel, node.m_Index, node.m_Level);
+		++updates;
+		spread(work, node.m_Index, node.m_Channel, node.m_Level);
+		break;
+	case ELightOp::Source:
+		if (current >= node.m_Level)
+			break;
+		light.set(node.m_Channel, node.m_Index, node.m_Level);
+		++updates;
+		spread(work, node.m_Index, node.m_Channel, node.m_Level);
+		break;
+	case ELightOp::Spread:
+		if (current > 0)
+			spread(work, node.m_Index, node.m_Channel, current);
+		break;
+	}
+}
+
+void LightingEngine::spread(ChunkWork& work, std::size_t index, ELightChannel channel, std::uint8_t level)
+{
+	for (std::uint32_t f = 0; f < FaceCount; ++f)
+	{
+		EFace face = static_cast<EFace>(f);
+		if (std::uint8_t passed = PassedLevel(channel, level, face))
+			send(work, index, face, { 0, passed, channel, ELightOp::Offer, face }, true);
+	}
+}
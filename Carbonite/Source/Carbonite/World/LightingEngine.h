@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Chunk.h"
+#include "ChunkCoord.h"
+#include "ChunkLight.h"
+#include "Utils/WorkerPool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class Dimension;
+
+struct LightingStats
+{
+public:
+	std::size_t   m_Events             = 0; // Chunk loads and voxel edits handled in the last update
+	std::size_t   m_Updates            = 0; // Voxel light writes in the last update
+	std::size_t   m_Chunks             = 0; // Chunks touched in the last update
+	std::uint64_t m_TotalUpdates       = 0;
+	float         m_UpdateMilliseconds = 0.0f;
+};
+
+// Incremental block and sky light propagation.
+// Loads and edits are queued as events and resolved in update() by breadth first flood fills that cross chunk borders.
+// Darkening runs first: removed light is cleared outwards until brighter light from another source is reached, those voxels
+// are re-added afterwards. Sky light of level 15 travels down without falling off, a chunk without a loaded chunk above is
+// treated as open to the sky.
+// Every chunk touched by an update has its own inbox, a chunk is only ever processed by one thread at a time and light
+// crossing a border is posted to the neighbour's inbox, so workers never write into a chunk they do not own.
+// Chunks are processed as jobs of the dimension's WorkerPool, update() blocks until all queued light has settled.
+class LightingEngine
+{
+public:
+	LightingEngine(WorkerPool& workers);
+
+	// Opacity and emission of the states, must outlive the engine and not change during update().
+	void setBlockStates(const BlockStateTable* blockStates) { m_BlockStates = blockStates; }
+
+	// Recomputes the light of the chunk and pulls in light from loaded neighbours.
+	void chunkLoaded(const ChunkCoord& coord);
+	// Call after the voxel at index changed from oldState.
+	void voxelChanged(const ChunkCoord& coord, std::size_t index, std::uint64_t oldState);
+	// Call after bulk edits, relights the 8x8x8 sections set in sections (bit x + y * 4 + z * 16) and whatever they lit.
+	void regionChanged(const ChunkCoord& coord, std::uint64_t sections);
+
+	// Settles all queued events, returns the number of voxel light writes.
+	std::size_t update(const Dimension& dimension);
+
+	bool  hasPendingEvents() const { return !m_Events.empty(); }
+	auto  getWorkerCount() const { return m_Workers.getWorkerCount(); }
+	auto& getStats() const { return m_Stats; }
+
+private:
+	enum class ELightOp : std::uint8_t
+	{
+		Remove, // A neighbour lost m_Level, clear this voxel if it was lit by it
+		Offer,  // A neighbour offers m_Level, take it if brighter and transparent
+		Source, // This voxel emits m_Level regardless of opacity
+		Spread  // Offer the current level of this voxel to its neighbours
+	};
+
+	struct LightNode
+	{
+	public:
+		std::uint16_t m_Index;
+		std::uint8_t  m_Level;
+		ELightChannel m_Channel;
+		ELightOp      m_Op;
+		EFace         m_Face; // Direction the node travelled in
+	};
+
+	struct ChunkWork
+	{
+	public:
+		Chunk*     m_Chunk = nullptr;
+		ChunkCoord m_Coord;
+
+		// Only touched by the thread owning the chunk.
+		std::array<ChunkWork*, FaceCount> m_Neighbours {};
+		std::array<bool, FaceCount>       m_Resolved {};
+		std::vector<LightNode>            m_Queue;
+
+		std::mutex             m_InboxMutex;
+		std::vector<LightNode> m_Inbox;
+		std::vector<LightNode> m_Deferred; // Re-adds collected while darkening, processed in the add pass
+		bool                   m_Scheduled = false;
+	};
+
+	enum class EEventType : std::uint8_t
+	{
+		Loaded,
+		Voxel,
+		Region
+	};
+
+	struct Event
+	{
+	public:
+		ChunkCoord    m_Coord;
+		std::uint64_t m_Data; // Old state of a voxel event, section mask of a region event
+		std::uint16_t m_Index;
+		EEventType    m_Type;
+	};
+
+	ChunkWork* getWork(const ChunkCoord& coord);
+	ChunkWork* getNeighbourWork(ChunkWork& work, EFace face);
+
+	void seedChunk(ChunkWork& work);
+	void seedVoxel(ChunkWork& work, std::size_t index, std::uint64_t oldState);
+	void seedRegion(ChunkWork& work, std::uint64_t sections);
+	bool fixShadowedColumns(ChunkWork& work);
+	void startRemoval(ChunkWork& work, std::size_t index, ELightChannel channel);
+
+	void post(ChunkWork& work, const LightNode& node);
+	// Moves node one voxel from index towards face, owner is set when called by the thread processing work.
+	void send(ChunkWork& work, std::size_t index, EFace face, LightNode node, bool owner);
+	void schedule(ChunkWork& work);
+	void runPass(bool addPass);
+	void process(ChunkWork& work);
+	void processNode(ChunkWork& work, const LightNode& node, std::size_t& updates);
+	void spread(ChunkWork& work, std::size_t index, ELightChannel channel, std::uint8_t level);
+
+	bool         isOpaque(std::uint64_t state) const { return m_BlockStates->isOpaque(state); }
+	std::uint8_t getEmission(std::uint64_t state) const { return m_BlockStates->getEmission(state); }
+
+private:
+	WorkerPool& m_Workers;
+
+	const Dimension*                                          m_Dimension = nullptr;
+	std::mutex                                                m_WorkMutex;
+	std::unordered_map<ChunkCoord, ChunkWork, ChunkCoordHash> m_Works;
+	std::atomic<std::size_t>                                  m_Updates = 0;
+	bool                                                      m_AddPass = false;
+	bool                                                      m_InPass  = false;
+
+	std::vector<Event>     m_Events;
+	const BlockStateTable* m_BlockStates = &BlockStateTable::Default();
+	LightingStats          m_Stats;
+};
@@ -0,0 +1,257 @@
+#include "RegionFile.h"
+#include "Carbonite/World/Chunk.h"
+#include "Carbonite/World/ChunkCodec.h"
+
+#include <cstring>
+
+namespace
+{
+	// Every chunk blob starts with its payload length and format.
+	constexpr std::size_t BlobHeaderSize = sizeof(std::uint32_t) + sizeof(std::uint8_t);
+} // namespace
+
+bool RegionFile::open(const std::filesystem::path& path, bool create)
+{
+	close();
+	if (!m_File.open(path, create))
+		return false;
+
+	if (m_File.getSize() < HeaderSectors * SectorSize)
+	{
+		if (!m_File.resize(HeaderSectors * SectorSize))
+		{
+			m_File.close();
+			return false;
+		}
+		std::memset(m_File.getData(), 0, HeaderSectors * SectorSize);
+	}
+
+	m_UsedSectors.assign(HeaderSectors, false);
+	m_UsedSectorCount = 0;
+	markSectors(0, HeaderSectors, true);
+
+	std::size_t fileSectors = m_File.getSize() / SectorSize;
+	for (std::size_t i = 0; i < ChunkCount; ++i)
+	{
+		std::uint32_t entry = getEntry(i);
+		if (entry == 0)
+			continue;
+
+		std::size_t first = entry >> 8;
+		std::size_t count = entry & 0xFF;
+		if (first < HeaderSectors || count == 0 || first + count > fileSectors)
+		{
+			// Points outside the file, treat the chunk as missing.
+			setEntry(i, 0);
+			continue;
+		}
+		markSectors(first, count, true);
+	}
+	return true;
+}
+
+void RegionFile::close()
+{
+	m_File.close();
+	m_UsedSectors.clear();
+	m_UsedSectorCount = 0;
+}
+
+bool RegionFile::flush()
+{
+	return m_File.flush();
+}
+
+bool RegionFile::readChunk(Chunk& chunk) const
+{
+	std::uint32_t entry = getEntry(GetEntryIndex(chunk.getCoord()));
+	if (entry == 0)
+		return false;
+
+	const std::uint8_t* blob = m_File.getData() + (entry >> 8) * SectorSize;
+	std::uint32_t       length;
+	std::memcpy(&length, blob, sizeof(length));
+	if (length + BlobHeaderSize > (entry & 0xFF) * SectorSize)
+		return false;
+
+	const std::uint8_t* payload = blob + BlobHeaderSize;
+	chunk.getHeightmap().invalidate();
+	chunk.getFluid().clear();
+	switch (static_cast<EChunkFormat>(blob[sizeof(length)]))
+	{
+	case EChunkFormat::Raw: return chunk.getVoxels().deserialize(payload, length);
+	case EChunkFormat::Compressed: return ChunkCodec::decode(payload, length, chunk.getVoxels());
+	case EChunkFormat::CompressedHeightmaps:
+	{
+		std::uint32_t voxelSize;
+		if (length < sizeof(voxelSize))
+			return false;
+		std::memcpy(&voxelSize, payload, sizeof(voxelSize));
+		if (voxelSize > length - sizeof(voxelSize) || !ChunkCodec::decode(payload + sizeof(voxelSize), voxelSize, chunk.getVoxels()))
+			return false;
+		// A broken heightmap is rebuilt from the voxels, no reason to lose the chunk over it.
+		chunk.getHeightmap().deserialize(payload + sizeof(voxelSize) + voxelSize, length - sizeof(voxelSize) - voxelSize);
+		return true;
+	}
+	case EChunkFormat::CompressedFluid:
+	{
+		std::uint32_t voxelSize, heightmapSize;
+		if (length < sizeof(voxelSize) + sizeof(heightmapSize))
+			return false;
+		std::memcpy(&voxelSize, payload, sizeof(voxelSize));
+		if (voxelSize > length - sizeof(voxelSize) - sizeof(heightmapSize) || !ChunkCodec::decode(payload + sizeof(voxelSize), voxelSize, chunk.getVoxels()))
+			return false;
+
+		const std::uint8_t* heightmap = payload + sizeof(voxelSize) + voxelSize;
+		std::size_t         remaining = length - sizeof(voxelSize) - voxelSize;
+		std::memcpy(&heightmapSize, heightmap, sizeof(heightmapSize));
+		if (heightmapSize > remaining - sizeof(heightmapSize))
+			return false;
+		chunk.getHeightmap().deserialize(heightmap + sizeof(heightmapSize), heightmapSize);
+		// Losing the fluid is not worth losing the chunk either.
+		chunk.getFluid().deserialize(heightmap + sizeof(heightmapSize) + heightmapSize, remaining - sizeof(heightmapSize) - heightmapSize);
+		return true;
+	}
+	default: return false;
+	}
+}
+
+void RegionFile::EncodeChunk(const ChunkStorage& voxels, const ChunkHeightmap& heightmap, const ChunkFluid& fluid, std::vector<std::uint8_t>& blob)
+{
+	blob.resize(BlobHeaderSize + sizeof(std::uint32_t));
+	ChunkCodec::encode(voxels, blob);
+	std::uint32_t voxelSize = static_cast<std::uint32_t>(blob.size() - BlobHeaderSize - sizeof(voxelSize));
+	std::memcpy(blob.data() + BlobHeaderSize, &voxelSize, sizeof(voxelSize));
+
+	std::size_t heightmapOffset = blob.size();
+	blob.resize(heightmapOffset + sizeof(std::uint32_t));
+	heightmap.serialize(blob);
+	std::uint32_t heightmapSize = static_cast<std::uint32_t>(blob.size() - heightmapOffset - sizeof(heightmapSize));
+	std::memcpy(blob.data() + heightmapOffset, &heightmapSize, sizeof(heightmapSize));
+	fluid.serialize(blob);
+
+	std::uint32_t length = static_cast<std::uint32_t>(blob.size() - BlobHeaderSize);
+	std::memcpy(blob.data(), &length, sizeof(length));
+	blob[sizeof(length)] = static_cast<std::uint8_t>(EChunkFormat::CompressedFluid);
+}
+
+bool RegionFile::writeChunk(const Chunk& chunk)
+{
+	EncodeChunk(chunk.getVoxels(), chunk.getHeightmap(), chunk.getFluid(), m_Buffer);
+	std::uint32_t entry = writeBlob(m_Buffer);
+	return entry != 0 && commitChunk(chunk.getCoord(), entry);
+}
+
+std::uint32_t RegionFile::writeBlob(const std::vector<std::uint8_t>& blob)
+{
+	std::size_t count = (blob.size() + SectorSize - 1) / SectorSize;
+	if (count > 0xFF)
+		return 0;
+
+	std::size_t first = allocateSectors(count);
+	if (first == 0)
+		return 0;
+
+	std::memcpy(m_File.getData() + first * SectorSize, blob.data(), blob.size());
+	return static_cast<std::uint32_t>((first << 8) | count);
+}
+
+void RegionFile::discardBlob(std::uint32_t entry)
+{
+	if (entry != 0)
+		markSectors(entry >> 8, entry & 0xFF, false);
+}
+
+bool RegionFile::commitChunk(const ChunkCoord& coord, std::uint32_t entry)
+{
+	std::size_t first = entry >> 8;
+	std::size_t count = entry & 0xFF;
+	if (first < HeaderSectors || count == 0 || (first + count) * SectorSize > m_File.getSize())
+		return false;
+
+	std::size_t   index    = GetEntryIndex(coord);
+	std::uint32_t oldEntry = getEntry(index);
+	if (oldEntry == entry)
+		return true;
+
+	setEntry(index, entry);
+	if (oldEntry != 0)
+		markSectors(oldEntry >> 8, oldEntry & 0xFF, false);
+	markSectors(first, count, true);
+	return true;
+}
+
+bool RegionFile::eraseChunk(const ChunkCoord& coord)
+{
+	std::size_t   index = GetEntryIndex(coord);
+	std::uint32_t entry = getEntry(index);
+	if (entry == 0)
+		return false;
+
+	setEntry(index, 0);
+	markSectors(entry >> 8, entry & 0xFF, false);
+	return true;
+}
+
+std::uint32_t RegionFile::getEntry(std::size_t index) const
+{
+	std::uint32_t entry;
+	std::memcpy(&entry, m_File.getData() + index * sizeof(entry), sizeof(entry));
+	return entry;
+}
+
+void RegionFile::setEntry(std::size_t index, std::uint32_t entry)
+{
+	std::memcpy(m_File.getData() + index * sizeof(entry), &entry, sizeof(entry));
+}
+
+std::size_t RegionFile::allocateSectors(std::size_t count)
+{
+	// First fit into a hole left by relocated chunks, otherwise append.
+	std::size_t run = 0;
+	for (std::size_t i = HeaderSectors; i < m_UsedSectors.size(); ++i)
+	{
+		run = m_UsedSectors[i] ? 0 : run + 1;
+		if (run == count)
+		{
+			markSectors(i + 1 - count, count, true);
+			return i + 1 - count;
+		}
+	}
+
+	std::size_t first = m_UsedSectors.size() - run;
+	std::size_t end   = first + count;
+	if (end > MaxSectors)
+		return 0;
+
+	if (end * SectorSize > m_File.getSize())
+	{
+		std::size_t sectors = (end + GrowSectors - 1) / GrowSectors * GrowSectors;
+		if (!m_File.resize(sectors * SectorSize))
+			return 0;
+	}
+
+	markSectors(first, count, true);
+	return first;
+}
+
+void RegionFile::markSectors(std::size_t first, std::size_t count, bool used)
+{
+	if (first + count > m_UsedSectors.size())
+		m_UsedSectors.resize(first + count, false);
+
+	for (std::size_t i = first; i < first + count; ++i)
+	{
+		if (m_UsedSectors[i] == used)
+			continue;
+
+		m_UsedSectors[i] = used;
+		if (used)
+			++m_UsedSectorCount;
+		else
+			--m_UsedSectorCount;
+	}
+
+	while (!m_UsedSectors.empty() && !m_UsedSectors.back())
+		m_UsedSectors.pop_back();
+}
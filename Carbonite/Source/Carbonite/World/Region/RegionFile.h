@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Carbonite/World/ChunkCoord.h"
+#include "Utils/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <vector>
+
+struct Chunk;
+class ChunkFluid;
+class ChunkHeightmap;
+class ChunkStorage;
+
+// A region file stores a 32x32 area of chunk columns, 32 chunks high.
+// The file starts with a fixed header holding one sector entry per chunk, (first sector << 8) | sector count.
+// The file is memory mapped, so reading a chunk is a page fault plus decoding the chunk in place.
+// Writes append and relocate: a chunk is written to free sectors first and the header is only updated afterwards,
+// the old sectors are released once the header points at the new copy.
+// writeChunk() does both steps at once, RegionStorage::saveChunks() splits them with writeBlob() and commitChunk() so the
+// blobs can be flushed to disk before any header entry points at them.
+class RegionFile
+{
+public:
+	static constexpr std::size_t Size          = 32;
+	static constexpr std::size_t ChunkCount    = Size * Size * Size;
+	static constexpr std::size_t SectorSize    = 4096;
+	static constexpr std::size_t HeaderSectors = ChunkCount * sizeof(std::uint32_t) / SectorSize;
+	static constexpr std::size_t MaxSectors    = (1ULL << 24) - 1;
+	static constexpr std::size_t GrowSectors   = 256;
+
+	enum class EChunkFormat : std::uint8_t
+	{
+		Raw                  = 0, // ChunkStorage::serialize()
+		Compressed           = 1, // ChunkCodec::encode()
+		CompressedHeightmaps = 2, // u32 size of the voxels, ChunkCodec::encode(), ChunkHeightmap::serialize()
+		CompressedFluid      = 3  // u32 size of the voxels, ChunkCodec::encode(), u32 size of the heightmaps, ChunkHeightmap::serialize(), ChunkFluid::serialize()
+	};
+
+	static ChunkCoord  GetRegionCoord(const ChunkCoord& chunk) { return { chunk.m_X >> 5, chunk.m_Y >> 5, chunk.m_Z >> 5 }; }
+	static std::size_t GetEntryIndex(const ChunkCoord& chunk) { return static_cast<std::size_t>((chunk.m_X & 31) + (chunk.m_Y & 31) * Size + (chunk.m_Z & 31) * Size * Size); }
+
+	// Encodes the voxels, heightmaps and fluid into blob, ready for writeBlob(). Needs no open file, so it can run outside any lock.
+	static void EncodeChunk(const ChunkStorage& voxels, const ChunkHeightmap& heightmap, const ChunkFluid& fluid, std::vector<std::uint8_t>& blob);
+
+public:
+	bool open(const std::filesystem::path& path, bool create);
+	void close();
+	bool flush();
+
+	bool hasChunk(const ChunkCoord& coord) const { return getEntry(GetEntryIndex(coord)) != 0; }
+	// Chunks of the older formats come back with an invalid heightmap or without fluid.
+	bool readChunk(Chunk& chunk) const;
+	bool writeChunk(const Chunk& chunk);
+	bool eraseChunk(const ChunkCoord& coord);
+
+	// Copies an encoded chunk into free sectors, returns its header entry or 0 if it did not fit.
+	// The sectors stay allocated but unreferenced until commitChunk() or discardBlob().
+	std::uint32_t writeBlob(const std::vector<std::uint8_t>& blob);
+	void          discardBlob(std::uint32_t entry);
+	// Points the chunk's header entry at a written blob and releases the sectors of the previous one.
+	// Entries outside the file are rejected, which matters when replaying a journal.
+	bool          commitChunk(const ChunkCoord& coord, std::uint32_t entry);
+
+	bool isOpen() const { return m_File.isOpen(); }
+	auto getUsedSectorCount() const { return m_UsedSectorCount; }
+
+private:
+	std::uint32_t getEntry(std::size_t index) const;
+	void          setEntry(std::size_t index, std::uint32_t entry);
+
+	std::size_t allocateSectors(std::size_t count);
+	void        markSectors(std::size_t first, std::size_t count, bool used);
+
+private:
+	MappedFile                m_File;
+	std::vector<bool>         m_UsedSectors;
+	std::size_t               m_UsedSectorCount = 0;
+	std::vector<std::uint8_t> m_Buffer;
+};
@@ -0,0 +1,154 @@
+#include "RegionSaver.h"
+#include "Carbonite/World/Chunk.h"
+
+RegionSaver::RegionSaver(RegionStorage& storage)
+    : m_Storage(&storage), m_Thread(&RegionSaver::saveLoop, this) {}
+
+RegionSaver::~RegionSaver()
+{
+	submit();
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Running = false;
+	}
+	m_Condition.notify_all();
+	m_Thread.join();
+}
+
+void RegionSaver::enqueue(const Chunk& chunk)
+{
+	ChunkCoord    coord  = chunk.getCoord();
+	std::uint64_t ticket = ++m_NextTicket;
+
+	auto [itr, inserted] = m_OpenIndices.try_emplace(coord, m_Open.m_Chunks.size());
+	if (inserted)
+	{
+		m_Open.m_Chunks.push_back({ coord, chunk.getVoxels(), chunk.getHeightmap(), chunk.getFluid() });
+		m_Open.m_Tickets.push_back(ticket);
+	}
+	else
+	{
+		m_Open.m_Chunks[itr->second].m_Voxels    = chunk.getVoxels();
+		m_Open.m_Chunks[itr->second].m_Heightmap = chunk.getHeightmap();
+		m_Open.m_Chunks[itr->second].m_Fluid     = chunk.getFluid();
+		m_Open.m_Tickets[itr->second]            = ticket;
+	}
+
+	std::lock_guard lock(m_Mutex);
+	Pending&        pending = m_Pending[coord];
+	pending.m_Voxels        = chunk.getVoxels();
+	pending.m_Heightmap     = chunk.getHeightmap();
+	pending.m_Fluid         = chunk.getFluid();
+	pending.m_Ticket        = ticket;
+}
+
+std::size_t RegionSaver::submit()
+{
+	std::size_t count = 0;
+	{
+		std::lock_guard lock(m_Mutex);
+		// Failed saves join the batch unless a newer snapshot of the chunk is already in it.
+		for (std::size_t i = 0; i < m_Retry.m_Chunks.size(); ++i)
+		{
+			auto& save = m_Retry.m_Chunks[i];
+			if (m_OpenIndices.contains(save.m_Coord))
+				continue;
+
+			m_OpenIndices.emplace(save.m_Coord, m_Open.m_Chunks.size());
+			m_Open.m_Chunks.push_back(std::move(save));
+			m_Open.m_Tickets.push_back(m_Retry.m_Tickets[i]);
+		}
+		m_Retry = {};
+
+		count = m_Open.m_Chunks.size();
+		if (count == 0)
+			return 0;
+		m_Batches.push_back(std::move(m_Open));
+	}
+	m_Condition.notify_one();
+
+	m_Open = {};
+	m_OpenIndices.clear();
+	return count;
+}
+
+void RegionSaver::wait()
+{
+	submit();
+	std::unique_lock lock(m_Mutex);
+	m_IdleCondition.wait(lock, [this]() { return m_Batches.empty() && !m_Busy; });
+}
+
+bool RegionSaver::restore(Chunk& chunk) const
+{
+	std::lock_guard lock(m_Mutex);
+	auto            itr = m_Pending.find(chunk.getCoord());
+	if (itr == m_Pending.end())
+		return false;
+
+	chunk.getVoxels()    = itr->second.m_Voxels;
+	chunk.getHeightmap() = itr->second.m_Heightmap;
+	chunk.getFluid()     = itr->second.m_Fluid;
+	return true;
+}
+
+std::size_t RegionSaver::getPendingCount() const
+{
+	std::lock_guard lock(m_Mutex);
+	return m_Pending.size();
+}
+
+std::size_t RegionSaver::getRetryCount() const
+{
+	std::lock_guard lock(m_Mutex);
+	return m_Retry.m_Chunks.size();
+}
+
+void RegionSaver::saveLoop()
+{
+	std::vector<ChunkCoord>                        failed;
+	std::unordered_set<ChunkCoord, ChunkCoordHash> failedSet;
+	while (true)
+	{
+		Batch batch;
+		{
+			std::unique_lock lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return !m_Batches.empty() || !m_Running; });
+			if (m_Batches.empty())
+				return;
+
+			batch = std::move(m_Batches.front());
+			m_Batches.pop_front();
+			m_Busy = true;
+		}
+
+		failed.clear();
+		m_Storage->saveChunks(batch.m_Chunks, &failed);
+
+		failedSet.clear();
+		failedSet.insert(failed.begin(), failed.end());
+
+		{
+			std::lock_guard lock(m_Mutex);
+			// A newer snapshot enqueued meanwhile keeps its entry and supersedes a failed one.
+			for (std::size_t i = 0; i < batch.m_Chunks.size(); ++i)
+			{
+				auto itr = m_Pending.find(batch.m_Chunks[i].m_Coord);
+				if (itr == m_Pending.end() || itr->second.m_Ticket != batch.m_Tickets[i])
+					continue;
+
+				if (failedSet.contains(batch.m_Chunks[i].m_Coord))
+				{
+					m_Retry.m_Chunks.push_back(std::move(batch.m_Chunks[i]));
+					m_Retry.m_Tickets.push_back(batch.m_Tickets[i]);
+				}
+				else
+				{
+					m_Pending.erase(itr);
+				}
+			}
+			m_Busy = false;
+		}
+		m_IdleCondition.notify_all();
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Carbonite/World/ChunkCoord.h"
+#include "Carbonite/World/ChunkStorage.h"
+#include "RegionStorage.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct Chunk;
+
+// Writes chunks to a RegionStorage on a background thread so saving does not stall the game loop.
+// enqueue() only takes a copy on write snapshot of the chunk's voxels and copies of its heightmaps and fluid, the simulation keeps editing the chunk and gets a
+// private copy of it on the first edit, while the save thread encodes the point in time view it was given.
+// Chunks are collected in an open batch until submit(), every batch is committed as a whole (see RegionStorage).
+// Snapshots stay restorable until their batch is on disk, chunks loaded again in the meantime must go through restore()
+// instead of the region files. Snapshots that failed to save stay pending and go out again with the next submit(), until
+// they are written or replaced by a newer snapshot.
+class RegionSaver
+{
+public:
+	RegionSaver(RegionStorage& storage);
+	~RegionSaver(); // Submits the open batch and waits for every batch to be written
+
+	// Adds a snapshot of the chunk to the open batch, replacing an older snapshot of it in the same batch.
+	void        enqueue(const Chunk& chunk);
+	// Hands the open batch to the save thread, returns its size.
+	std::size_t submit();
+	// Submits the open batch and blocks until every batch is written.
+	void        wait();
+
+	// Gives the chunk the voxels, heightmaps and fluid of its newest snapshot that is not on disk yet.
+	bool restore(Chunk& chunk) const;
+
+	std::size_t getOpenCount() const { return m_Open.m_Chunks.size(); }
+	// Snapshots not on disk yet, including the open batch and failed saves.
+	std::size_t getPendingCount() const;
+	// Failed saves waiting for the next submit().
+	std::size_t getRetryCount() const;
+
+private:
+	void saveLoop();
+
+private:
+	struct Batch
+	{
+	public:
+		std::vector<RegionStorage::ChunkSave> m_Chunks;
+		std::vector<std::uint64_t>            m_Tickets;
+	};
+
+	struct Pending
+	{
+	public:
+		ChunkStorage   m_Voxels;
+		ChunkHeightmap m_Heightmap;
+		ChunkFluid     m_Fluid;
+		std::uint64_t  m_Ticket = 0;
+	};
+
+	RegionStorage* m_Storage;
+
+	// Only touched by the thread calling enqueue() and submit().
+	Batch                                                       m_Open;
+	std::unordered_map<ChunkCoord, std::size_t, ChunkCoordHash> m_OpenIndices;
+	std::uint64_t                                               m_NextTicket = 0;
+
+	mutable std::mutex                                      m_Mutex;
+	std::condition_variable                                 m_Condition;
+	std::condition_variable                                 m_IdleCondition;
+	std::deque<Batch>                                       m_Batches;
+	std::unordered_map<ChunkCoord, Pending, ChunkCoordHash> m_Pending;
+	Batch                                                   m_Retry;
+	bool                                                    m_Busy    = false;
+	bool                                                    m_Running = true;
+	std::thread                                             m_Thread;
+};
@@ -0,0 +1,241 @@
+#include "RegionStorage.h"
+#include "Carbonite/World/Chunk.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace
+{
+	constexpr std::uint64_t JournalPending = 0x4C'4E'52'55'4F'4A'4E'43ULL; // "CNJOURNL"
+
+	struct JournalHeader
+	{
+	public:
+		std::uint64_t m_State;
+		std::uint64_t m_Count;
+		std::uint64_t m_Checksum;
+	};
+
+	struct JournalEntry
+	{
+	public:
+		std::int64_t  m_X, m_Y, m_Z;
+		std::uint32_t m_Entry;
+		std::uint32_t m_Padding;
+	};
+
+	// FNV-1a, only has to catch a journal that was torn by a crash.
+	std::uint64_t Checksum(const std::uint8_t* data, std::size_t size)
+	{
+		std::uint64_t hash = 0xCBF2'9CE4'8422'2325ULL;
+		for (std::size_t i = 0; i < size; ++i)
+			hash = (hash ^ data[i]) * 0x0000'0100'0000'01B3ULL;
+		return hash;
+	}
+} // namespace
+
+RegionStorage::RegionStorage(const std::filesystem::path& directory, std::size_t maxOpenFiles)
+    : m_Directory(directory), m_MaxOpenFiles(maxOpenFiles < 1 ? 1 : maxOpenFiles)
+{
+	std::filesystem::create_directories(m_Directory);
+	if (m_Journal.open(m_Directory / "save.journal", true))
+		replayJournal();
+}
+
+RegionStorage::~RegionStorage()
+{
+	flush();
+}
+
+bool RegionStorage::hasChunk(const ChunkCoord& coord)
+{
+	std::lock_guard lock(m_Mutex);
+	OpenRegion*     region = getRegion(coord, false);
+	return region && region->m_File->hasChunk(coord);
+}
+
+bool RegionStorage::loadChunk(Chunk& chunk)
+{
+	std::lock_guard lock(m_Mutex);
+	OpenRegion*     region = getRegion(chunk.getCoord(), false);
+	return region && region->m_File->readChunk(chunk);
+}
+
+bool RegionStorage::saveChunk(const Chunk& chunk)
+{
+	return saveChunks({ { chunk.getCoord(), chunk.getVoxels(), chunk.getHeightmap(), chunk.getFluid() } }) == 1;
+}
+
+std::size_t RegionStorage::saveChunks(const std::vector<ChunkSave>& chunks, std::vector<ChunkCoord>* failed)
+{
+	std::vector<std::pair<ChunkCoord, std::uint32_t>> entries;
+	std::vector<OpenRegion*>                          regions;
+	std::vector<std::uint8_t>                         blob;
+	entries.reserve(chunks.size());
+	regions.reserve(chunks.size());
+
+	for (auto& chunk : chunks)
+	{
+		RegionFile::EncodeChunk(chunk.m_Voxels, chunk.m_Heightmap, chunk.m_Fluid, blob);
+
+		std::lock_guard lock(m_Mutex);
+		OpenRegion*     region = getRegion(chunk.m_Coord, true);
+		std::uint32_t   entry  = region ? region->m_File->writeBlob(blob) : 0;
+		if (entry == 0)
+		{
+			if (failed)
+				failed->push_back(chunk.m_Coord);
+			continue;
+		}
+
+		++region->m_Pins;
+		entries.emplace_back(chunk.m_Coord, entry);
+		regions.push_back(region);
+	}
+	if (entries.empty())
+		return 0;
+
+	std::lock_guard lock(m_Mutex);
+	std::vector<OpenRegion*> uniqueRegions = regions;
+	std::sort(uniqueRegions.begin(), uniqueRegions.end());
+	uniqueRegions.erase(std::unique(uniqueRegions.begin(), uniqueRegions.end()), uniqueRegions.end());
+
+	bool written = true;
+	for (OpenRegion* region : uniqueRegions)
+		written = region->m_File->flush() && written;
+	written = written && writeJournal(entries);
+
+	std::size_t saved = 0;
+	for (std::size_t i = 0; i < entries.size(); ++i)
+	{
+		if (written && regions[i]->m_File->commitChunk(entries[i].first, entries[i].second))
+		{
+			++saved;
+		}
+		else
+		{
+			regions[i]->m_File->discardBlob(entries[i].second);
+			if (failed)
+				failed->push_back(entries[i].first);
+		}
+		--regions[i]->m_Pins;
+	}
+
+	if (written)
+	{
+		for (OpenRegion* region : uniqueRegions)
+			region->m_File->flush();
+		clearJournal();
+	}
+	return saved;
+}
+
+void RegionStorage::flush()
+{
+	std::lock_guard lock(m_Mutex);
+	for (auto& region : m_Regions)
+		region.second.m_File->flush();
+}
+
+RegionStorage::OpenRegion* RegionStorage::getRegion(const ChunkCoord& chunk, bool create)
+{
+	ChunkCoord regionCoord = RegionFile::GetRegionCoord(chunk);
+
+	auto itr = m_Regions.find(regionCoord);
+	if (itr != m_Regions.end())
+	{
+		itr->second.m_LastUse = ++m_UseCounter;
+		return &itr->second;
+	}
+
+	auto path = m_Directory / ("r." + std::to_string(regionCoord.m_X) + "." + std::to_string(regionCoord.m_Y) + "." + std::to_string(regionCoord.m_Z) + ".cnr");
+	if (!create && !std::filesystem::exists(path))
+		return nullptr;
+
+	auto file = std::make_unique<RegionFile>();
+	if (!file->open(path, create))
+		return nullptr;
+
+	if (m_Regions.size() >= m_MaxOpenFiles)
+	{
+		// Pinned regions hold blobs only their in memory sector map knows about, closing them would let the sectors be reused.
+		auto oldest = m_Regions.end();
+		for (auto current = m_Regions.begin(); current != m_Regions.end(); ++current)
+			if (current->second.m_Pins == 0 && (oldest == m_Regions.end() || current->second.m_LastUse < oldest->second.m_LastUse))
+				oldest = current;
+		if (oldest != m_Regions.end())
+		{
+			oldest->second.m_File->flush();
+			m_Regions.erase(oldest);
+		}
+	}
+
+	OpenRegion& entry = m_Regions[regionCoord];
+	entry.m_File      = std::move(file);
+	entry.m_LastUse   = ++m_UseCounter;
+	return &entry;
+}
+
+bool RegionStorage::writeJournal(const std::vector<std::pair<ChunkCoord, std::uint32_t>>& entries)
+{
+	if (!m_Journal.isOpen())
+		return false;
+
+	std::size_t size = sizeof(JournalHeader) + entries.size() * sizeof(JournalEntry);
+	if (m_Journal.getSize() < size && !m_Journal.resize(size))
+		return false;
+
+	std::uint8_t* data = m_Journal.getData();
+	for (std::size_t i = 0; i < entries.size(); ++i)
+	{
+		JournalEntry entry { entries[i].first.m_X, entries[i].first.m_Y, entries[i].first.m_Z, entries[i].second, 0 };
+		std::memcpy(data + sizeof(JournalHeader) + i * sizeof(JournalEntry), &entry, sizeof(entry));
+	}
+
+	// The checksum covers the entries, a journal torn by a crash is ignored like an empty one.
+	JournalHeader header { JournalPending, entries.size(), Checksum(data + sizeof(JournalHeader), entries.size() * sizeof(JournalEntry)) };
+	std::memcpy(data, &header, sizeof(header));
+	return m_Journal.flush();
+}
+
+bool RegionStorage::clearJournal()
+{
+	JournalHeader header {};
+	std::memcpy(m_Journal.getData(), &header, sizeof(header));
+	return m_Journal.flush();
+}
+
+void RegionStorage::replayJournal()
+{
+	if (m_Journal.getSize() < sizeof(JournalHeader))
+	{
+		if (m_Journal.resize(sizeof(JournalHeader)))
+			clearJournal();
+		return;
+	}
+
+	const std::uint8_t* data = m_Journal.getData();
+	JournalHeader       header;
+	std::memcpy(&header, data, sizeof(header));
+	if (header.m_State != JournalPending ||
+	    header.m_Count > (m_Journal.getSize() - sizeof(JournalHeader)) / sizeof(JournalEntry) ||
+	    header.m_Checksum != Checksum(data + sizeof(JournalHeader), header.m_Count * sizeof(JournalEntry)))
+		return;
+
+	// The blobs were flushed before the journal, so the entries are valid even if no header saw them yet.
+	std::lock_guard lock(m_Mutex);
+	for (std::size_t i = 0; i < header.m_Count; ++i)
+	{
+		JournalEntry entry;
+		std::memcpy(&entry, m_Journal.getData() + sizeof(JournalHeader) + i * sizeof(JournalEntry), sizeof(entry));
+
+		ChunkCoord  coord { entry.m_X, entry.m_Y, entry.m_Z };
+		OpenRegion* region = getRegion(coord, false);
+		if (region)
+			region->m_File->commitChunk(coord, entry.m_Entry);
+	}
+	for (auto& region : m_Regions)
+		region.second.m_File->flush();
+	clearJournal();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Carbonite/World/ChunkCoord.h"
+#include "Carbonite/World/ChunkFluid.h"
+#include "Carbonite/World/ChunkHeightmap.h"
+#include "Carbonite/World/ChunkStorage.h"
+#include "RegionFile.h"
+#include "Utils/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct Chunk;
+
+// Keeps the region files of one dimension open, closing the least recently used ones past a limit.
+// Every method locks, so one thread can save chunks while another loads them.
+// Saves are crash consistent through a write ahead journal (save.journal in the directory):
+//   1. the chunk blobs are written to free sectors and flushed, no header entry points at them yet,
+//   2. the new header entries are written to the journal together with a checksum and flushed,
+//   3. the entries are applied to the region headers and flushed, the old sectors are released,
+//   4. the journal is marked empty.
+// A crash before 2 completes leaves the old chunks in place, a crash after it is finished by replaying the journal on the
+// next open. So after a crash either every chunk of a batch is the new version or none is.
+class RegionStorage
+{
+public:
+	struct ChunkSave
+	{
+	public:
+		ChunkCoord     m_Coord;
+		ChunkStorage   m_Voxels; // Usually a copy on write snapshot of a loaded chunk
+		ChunkHeightmap m_Heightmap;
+		ChunkFluid     m_Fluid;
+	};
+
+public:
+	RegionStorage(const std::filesystem::path& directory, std::size_t maxOpenFiles = 64);
+	~RegionStorage();
+
+	bool hasChunk(const ChunkCoord& coord);
+	bool loadChunk(Chunk& chunk);
+	bool saveChunk(const Chunk& chunk);
+	// Writes the chunks as one batch, returns how many were written. Chunks that did not fit into their region file are
+	// appended to failed and left out of the batch, if the journal cannot be written all of them fail.
+	// Chunks are only encoded outside the lock, loads on other threads wait for the copies and flushes.
+	std::size_t saveChunks(const std::vector<ChunkSave>& chunks, std::vector<ChunkCoord>* failed = nullptr);
+	void        flush();
+
+	auto& getDirectory() const { return m_Directory; }
+
+private:
+	struct OpenRegion
+	{
+	public:
+		std::unique_ptr<RegionFile> m_File;
+		std::uint64_t               m_LastUse = 0;
+		std::uint32_t               m_Pins    = 0; // Batches with uncommitted blobs in the file, those must not be closed
+	};
+
+	OpenRegion* getRegion(const ChunkCoord& chunk, bool create);
+
+	bool writeJournal(const std::vector<std::pair<ChunkCoord, std::uint32_t>>& entries);
+	bool clearJournal();
+	void replayJournal();
+
+private:
+	std::filesystem::path                                       m_Directory;
+	std::size_t                                                 m_MaxOpenFiles;
+	std::unordered_map<ChunkCoord, OpenRegion, ChunkCoordHash>  m_Regions;
+	std::uint64_t                                               m_UseCounter = 0;
+	MappedFile                                                  m_Journal;
+	std::mutex                                                  m_Mutex;
+};
@@ -0,0 +1,77 @@
+#include "TickWheel.h"
+
+#include <algorithm>
+#include <bit>
+
+void TickWheel::schedule(const ChunkCoord& chunk, std::uint16_t index, std::uint64_t delay)
+{
+	insert({ chunk, m_Tick + (delay < 1 ? 1 : delay), index });
+	++m_Size;
+}
+
+void TickWheel::advance(std::vector<ScheduledTick>& due)
+{
+	++m_Tick;
+
+	// Every level whose slot digit rolled over starts a new slot, past the top level a new turn of the wheel starts.
+	// Higher levels first, their entries may land in the lower slots reached on this tick.
+	std::uint32_t level = 1;
+	while (level <= Levels && (m_Tick & ((1ULL << (level * SlotBits)) - 1)) == 0)
+		++level;
+	if (level > Levels)
+	{
+		m_Cascade.swap(m_Overflow);
+		for (auto& tick : m_Cascade)
+			insert(tick);
+		m_Cascade.clear();
+	}
+	for (std::uint32_t l = std::min(level - 1, Levels - 1); l > 0; --l)
+		cascade(l);
+
+	auto& slot = m_Slots[0][m_Tick & (SlotCount - 1)];
+	for (auto& tick : slot)
+	{
+		if (tick.m_Due <= m_Tick)
+		{
+			due.push_back(tick);
+			--m_Size;
+		}
+		else
+		{
+			insert(tick);
+		}
+	}
+	slot.clear();
+}
+
+void TickWheel::clear()
+{
+	for (auto& level : m_Slots)
+		for (auto& slot : level)
+			slot.clear();
+	m_Overflow.clear();
+	m_Size = 0;
+}
+
+void TickWheel::insert(const ScheduledTick& tick)
+{
+	// The highest differing slot digit between now and the due tick picks the level.
+	std::uint64_t difference = tick.m_Due ^ m_Tick;
+	std::uint32_t level      = difference == 0 ? 0 : static_cast<std::uint32_t>(std::bit_width(difference) - 1) / SlotBits;
+	if (level >= Levels)
+	{
+		// Due in a later turn of the wheel, looked at again when the next turn starts.
+		m_Overflow.push_back(tick);
+		return;
+	}
+	m_Slots[level][(tick.m_Due >> (level * SlotBits)) & (SlotCount - 1)].push_back(tick);
+}
+
+void TickWheel::cascade(std::uint32_t level)
+{
+	auto& slot = m_Slots[level][(m_Tick >> (level * SlotBits)) & (SlotCount - 1)];
+	m_Cascade.swap(slot);
+	for (auto& tick : m_Cascade)
+		insert(tick);
+	m_Cascade.clear();
+}
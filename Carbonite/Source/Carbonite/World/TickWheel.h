@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ChunkCoord.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <vector>
+
+struct ScheduledTick
+{
+public:
+	ChunkCoord    m_Chunk;
+	std::uint64_t m_Due   = 0; // Tick the entry fires on
+	std::uint16_t m_Index = 0; // Voxel index in the chunk
+};
+
+// Hierarchical timing wheel for delayed block ticks.
+// Level l has SlotCount slots of SlotCount^l ticks each, an entry goes into the lowest level whose slot range still contains
+// its due tick and moves down a level whenever the wheel reaches the start of its slot. Scheduling and firing are constant time,
+// entries due in a later turn of the wheel (SlotCount^Levels ticks) wait in an overflow list that is sorted in once per turn.
+// Entries due on the same tick fire in the order they were scheduled.
+class TickWheel
+{
+public:
+	static constexpr std::uint32_t SlotBits  = 6;
+	static constexpr std::size_t   SlotCount = 1ULL << SlotBits;
+	static constexpr std::uint32_t Levels    = 4;
+
+public:
+	// Delays below 1 fire on the next advance().
+	void schedule(const ChunkCoord& chunk, std::uint16_t index, std::uint64_t delay);
+	// Moves to the next tick and appends every entry due on it to due.
+	void advance(std::vector<ScheduledTick>& due);
+	void clear();
+
+	auto getTick() const { return m_Tick; }
+	auto getSize() const { return m_Size; }
+
+private:
+	void insert(const ScheduledTick& tick);
+	// Reinserts the entries of a slot relative to the current tick.
+	void cascade(std::uint32_t level);
+
+private:
+	std::array<std::array<std::vector<ScheduledTick>, SlotCount>, Levels> m_Slots;
+	std::vector<ScheduledTick>                                            m_Overflow;
+	std::vector<ScheduledTick>                                            m_Cascade;
+	std::uint64_t                                                         m_Tick = 0;
+	std::size_t                                                           m_Size = 0;
+};
@@ -0,0 +1,287 @@
+#include "VoxelCollision.h"
+#include "Dimension.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	constexpr std::int64_t ChunkSize = static_cast<std::int64_t>(Chunk::Size);
+
+	// std::floor and std::ceil are library calls without SSE4.1, these run a few times per axis of every body.
+	std::int64_t Floor(double value)
+	{
+		std::int64_t truncated = static_cast<std::int64_t>(value);
+		return truncated - (value < static_cast<double>(truncated) ? 1 : 0);
+	}
+
+	std::int64_t Ceil(double value)
+	{
+		std::int64_t truncated = static_cast<std::int64_t>(value);
+		return truncated + (value > static_cast<double>(truncated) ? 1 : 0);
+	}
+
+	ChunkCoord StartChunk(const CollisionBody& body)
+	{
+		return { Floor(body.m_Min.x) >> 5, Floor(body.m_Min.y) >> 5, Floor(body.m_Min.z) >> 5 };
+	}
+} // namespace
+
+VoxelCollision::VoxelCollision(WorkerPool& workers)
+    : m_Workers(workers)
+{
+}
+
+void VoxelCollision::collide(const Dimension& dimension, std::vector<CollisionBody>& bodies)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	m_Stats          = {};
+	m_Stats.m_Bodies = bodies.size();
+	m_Dimension      = &dimension;
+	m_Bodies         = &bodies;
+
+	// Bodies rarely leave their chunk between calls. The bodies whose chunk did not change stay sorted, only the ones that
+	// moved are sorted and merged back in. A new body count starts over with a full sort.
+	if (m_Order.size() != bodies.size())
+	{
+		m_Order.resize(bodies.size());
+		for (std::size_t i = 0; i < bodies.size(); ++i)
+			m_Order[i] = { StartChunk(bodies[i]).morton(), static_cast<std::uint32_t>(i) };
+		std::sort(m_Order.begin(), m_Order.end());
+	}
+	else
+	{
+		m_Moved.clear();
+		std::size_t kept = 0;
+		for (auto& order : m_Order)
+		{
+			std::uint64_t key = StartChunk(bodies[order.second]).morton();
+			if (key == order.first)
+				m_Order[kept++] = order;
+			else
+				m_Moved.push_back({ key, order.second });
+		}
+		if (!m_Moved.empty())
+		{
+			std::sort(m_Moved.begin(), m_Moved.end());
+			m_Merged.resize(m_Order.size());
+			std::merge(m_Order.begin(), m_Order.begin() + kept, m_Moved.begin(), m_Moved.end(), m_Merged.begin());
+			std::swap(m_Order, m_Merged);
+		}
+	}
+
+	// Runs of bodies starting in the same chunk. Morton codes of far apart chunks can be equal, the coordinates decide.
+	m_GroupCount = 0;
+	m_Stale.clear();
+	for (std::size_t begin = 0; begin < m_Order.size();)
+	{
+		ChunkCoord  coord = StartChunk(bodies[m_Order[begin].second]);
+		std::size_t end   = begin + 1;
+		while (end < m_Order.size() && m_Order[end].first == m_Order[begin].first && StartChunk(bodies[m_Order[end].second]) == coord)
+			++end;
+
+		if (m_GroupCount == m_Groups.size())
+			m_Groups.emplace_back();
+		Group& group    = m_Groups[m_GroupCount++];
+		group.m_Begin   = begin;
+		group.m_End     = end;
+		group.m_Blocked = 0;
+		for (std::uint32_t a = 0; a < 3; ++a)
+		{
+			group.m_Min[a] = std::numeric_limits<std::int64_t>::max();
+			group.m_Max[a] = std::numeric_limits<std::int64_t>::min();
+		}
+
+		// Every voxel a body can test lies within its swept bounds grown by one voxel.
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			const CollisionBody& body = bodies[m_Order[i].second];
+			double               min[3] { body.m_Min.x, body.m_Min.y, body.m_Min.z };
+			double               max[3] { body.m_Max.x, body.m_Max.y, body.m_Max.z };
+			double               motion[3] { body.m_Motion.x, body.m_Motion.y, body.m_Motion.z };
+			for (std::uint32_t a = 0; a < 3; ++a)
+			{
+				group.m_Min[a] = std::min(group.m_Min[a], (Floor(std::min(min[a], min[a] + motion[a])) - 1) >> 5);
+				group.m_Max[a] = std::max(group.m_Max[a], Ceil(std::max(max[a], max[a] + motion[a])) >> 5);
+			}
+		}
+
+		group.m_Window.clear();
+		for (std::int64_t cz = group.m_Min[2]; cz <= group.m_Max[2]; ++cz)
+		{
+			for (std::int64_t cy = group.m_Min[1]; cy <= group.m_Max[1]; ++cy)
+			{
+				for (std::int64_t cx = group.m_Min[0]; cx <= group.m_Max[0]; ++cx)
+				{
+					Chunk* chunk = dimension.getChunk(cx, cy, cz);
+					if (!chunk)
+					{
+						group.m_Window.push_back(nullptr);
+						continue;
+					}
+
+					if (!chunk->getOccupancy().isCurrent(chunk->getRevision()))
+						m_Stale.push_back(chunk);
+					group.m_Window.push_back(&chunk->getOccupancy());
+					++m_Stats.m_Chunks;
+				}
+			}
+		}
+		begin = end;
+	}
+	// Windows of neighbouring groups overlap, every stale chunk is rebuilt once.
+	std::sort(m_Stale.begin(), m_Stale.end());
+	m_Stale.erase(std::unique(m_Stale.begin(), m_Stale.end()), m_Stale.end());
+	m_Stats.m_Groups  = m_GroupCount;
+	m_Stats.m_Rebuilt = m_Stale.size();
+
+	m_Workers.parallelFor(m_Stale.size(), [this](std::size_t index) {
+		Chunk& chunk = *m_Stale[index];
+		chunk.getOccupancy().build(chunk.getVoxels(), m_Dimension->getBlockStates(), chunk.getRevision());
+	});
+	m_Workers.parallelFor(m_GroupCount, [this](std::size_t index) { resolve(m_Groups[index]); });
+
+	for (std::size_t i = 0; i < m_GroupCount; ++i)
+		m_Stats.m_Blocked += m_Groups[i].m_Blocked;
+	m_Bodies    = nullptr;
+	m_Dimension = nullptr;
+
+	m_Stats.m_Milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool VoxelCollision::AnySolid(const Group& group, const std::int64_t (&first)[3], const std::int64_t (&last)[3])
+{
+	std::int64_t width  = group.m_Max[0] - group.m_Min[0] + 1;
+	std::int64_t height = group.m_Max[1] - group.m_Min[1] + 1;
+	auto         lookup = [&](std::int64_t cx, std::int64_t cy, std::int64_t cz) {
+		return group.m_Window[static_cast<std::size_t>((cx - group.m_Min[0]) + ((cy - group.m_Min[1]) + (cz - group.m_Min[2]) * height) * width)];
+	};
+
+	// Entity sized ranges mostly lie inside one chunk.
+	if ((first[0] >> 5) == (last[0] >> 5) && (first[1] >> 5) == (last[1] >> 5) && (first[2] >> 5) == (last[2] >> 5))
+	{
+		const ChunkOccupancy* occupancy = lookup(first[0] >> 5, first[1] >> 5, first[2] >> 5);
+		if (!occupancy)
+			return false;
+		std::uint32_t from[3] { static_cast<std::uint32_t>(first[0] & 31), static_cast<std::uint32_t>(first[1] & 31), static_cast<std::uint32_t>(first[2] & 31) };
+		std::uint32_t to[3] { static_cast<std::uint32_t>(last[0] & 31), static_cast<std::uint32_t>(last[1] & 31), static_cast<std::uint32_t>(last[2] & 31) };
+		return occupancy->any(from, to);
+	}
+
+	for (std::int64_t cz = first[2] >> 5; cz <= last[2] >> 5; ++cz)
+	{
+		for (std::int64_t cy = first[1] >> 5; cy <= last[1] >> 5; ++cy)
+		{
+			for (std::int64_t cx = first[0] >> 5; cx <= last[0] >> 5; ++cx)
+			{
+				const ChunkOccupancy* occupancy = lookup(cx, cy, cz);
+				if (!occupancy || occupancy->getKind() == EOccupancy::Empty)
+					continue;
+
+				std::int64_t  base[3] { cx * ChunkSize, cy * ChunkSize, cz * ChunkSize };
+				std::uint32_t from[3];
+				std::uint32_t to[3];
+				for (std::uint32_t a = 0; a < 3; ++a)
+				{
+					from[a] = static_cast<std::uint32_t>(std::max(first[a], base[a]) - base[a]);
+					to[a]   = static_cast<std::uint32_t>(std::min(last[a], base[a] + ChunkSize - 1) - base[a]);
+				}
+				if (occupancy->any(from, to))
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+double VoxelCollision::Clip(const Group& group, std::uint32_t axis, const double (&min)[3], const double (&max)[3], double motion)
+{
+	// Voxels overlapping the box across the motion, faces within Epsilon do not overlap.
+	std::int64_t first[3];
+	std::int64_t last[3];
+	for (std::uint32_t a = 0; a < 3; ++a)
+	{
+		first[a] = Floor(min[a] + Epsilon);
+		last[a]  = std::max(first[a], Ceil(max[a] - Epsilon) - 1);
+	}
+
+	// Layers of voxels along the axis from the leading face to the end of the motion, nearest first.
+	std::int64_t from, to, step;
+	if (motion > 0.0)
+	{
+		from = Ceil(max[axis] - Epsilon);
+		to   = Ceil(max[axis] + motion - Epsilon) - 1;
+		step = 1;
+		if (from > to)
+			return motion;
+	}
+	else
+	{
+		from = Floor(min[axis] + Epsilon) - 1;
+		to   = Floor(min[axis] + motion + Epsilon);
+		step = -1;
+		if (from < to)
+			return motion;
+	}
+
+	// Most motion crossing several layers crosses nothing, one test over all of them settles it.
+	bool swept = from != to;
+	if (swept)
+	{
+		first[axis] = std::min(from, to);
+		last[axis]  = std::max(from, to);
+		if (!AnySolid(group, first, last))
+			return motion;
+	}
+
+	for (std::int64_t layer = from;; layer += step)
+	{
+		first[axis] = layer;
+		last[axis]  = layer;
+		if ((swept && layer == to) || AnySolid(group, first, last))
+			return step > 0 ? std::max(0.0, static_cast<double>(layer) - max[axis]) : std::min(0.0, static_cast<double>(layer + 1) - min[axis]);
+		if (layer == to)
+			return motion;
+	}
+}
+
+void VoxelCollision::resolve(Group& group)
+{
+	auto& bodies = *m_Bodies;
+	for (std::size_t i = group.m_Begin; i < group.m_End; ++i)
+	{
+		CollisionBody& body = bodies[m_Order[i].second];
+		double         min[3] { body.m_Min.x, body.m_Min.y, body.m_Min.z };
+		double         max[3] { body.m_Max.x, body.m_Max.y, body.m_Max.z };
+		double         motion[3] { body.m_Motion.x, body.m_Motion.y, body.m_Motion.z };
+		double         moved[3] { 0.0, 0.0, 0.0 };
+
+		// Vertical first so landing keeps the horizontal motion, then the larger horizontal axis.
+		std::uint32_t order[3] { 2, 0, 1 };
+		if (std::fabs(motion[1]) > std::fabs(motion[0]))
+			std::swap(order[1], order[2]);
+
+		std::uint8_t contacts = 0;
+		for (std::uint32_t axis : order)
+		{
+			if (motion[axis] == 0.0)
+				continue;
+
+			double allowed = Clip(group, axis, min, max, motion[axis]);
+			if (allowed != motion[axis])
+				contacts |= static_cast<std::uint8_t>(1U << (axis * 2 + (motion[axis] > 0.0 ? 1 : 0)));
+			min[axis] += allowed;
+			max[axis] += allowed;
+			moved[axis] = allowed;
+		}
+
+		body.m_Min      = { static_cast<float>(min[0]), static_cast<float>(min[1]), static_cast<float>(min[2]) };
+		body.m_Max      = { static_cast<float>(max[0]), static_cast<float>(max[1]), static_cast<float>(max[2]) };
+		body.m_Motion   = { static_cast<float>(moved[0]), static_cast<float>(moved[1]), static_cast<float>(moved[2]) };
+		body.m_Contacts = contacts;
+		group.m_Blocked += contacts ? 1 : 0;
+	}
+}
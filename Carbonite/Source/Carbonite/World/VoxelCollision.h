@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ChunkCoord.h"
+#include "ChunkOccupancy.h"
+#include "Utils/WorkerPool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Dimension;
+struct Chunk;
+
+struct CollisionBody
+{
+public:
+	glm::fvec3   m_Min, m_Max;   // Box in world coordinates, collide() moves it
+	glm::fvec3   m_Motion;       // Wanted motion, collide() replaces it with the motion made
+	std::uint8_t m_Contacts = 0; // Bit per EFace of the box that a voxel stopped in the last collide()
+
+	bool isOnGround() const { return m_Contacts & (1U << static_cast<std::uint32_t>(EFace::NegativeZ)); }
+};
+
+struct CollisionStats
+{
+public:
+	std::size_t m_Bodies       = 0;
+	std::size_t m_Groups       = 0; // Runs of bodies starting in the same chunk, the unit of work of the workers
+	std::size_t m_Chunks       = 0; // Loaded chunks looked at, summed over the groups
+	std::size_t m_Rebuilt      = 0; // ChunkOccupancy rebuilt because their chunk changed
+	std::size_t m_Blocked      = 0; // Bodies whose motion was cut short
+	float       m_Milliseconds = 0.0f;
+};
+
+// Moves boxes through the solid voxels of a dimension (BlockStateTable::isSolid()), chunks that are not loaded are empty.
+// Motion is resolved one axis at a time, z first, so a box sliding along a wall or the ground keeps the rest of its motion.
+// Voxels a box already overlaps are ignored so a stuck box can move out, faces within Epsilon count as touching.
+// Voxels are tested through the ChunkOccupancy of the chunks, stale ones are rebuilt first. Bodies are sorted by the chunk
+// they start in and the order is kept for the next call, every run of bodies in a chunk shares the looked up chunks.
+// Runs resolve in parallel as jobs of the dimension's WorkerPool, collide() blocks until every body moved.
+// Meant for entity sized boxes and per tick motion, no chunk may be modified during collide().
+class VoxelCollision
+{
+public:
+	static constexpr double Epsilon = 1.0 / 4096.0;
+
+public:
+	VoxelCollision(WorkerPool& workers);
+
+	void collide(const Dimension& dimension, std::vector<CollisionBody>& bodies);
+
+	auto  getWorkerCount() const { return m_Workers.getWorkerCount(); }
+	auto& getStats() const { return m_Stats; }
+
+private:
+	struct Group
+	{
+	public:
+		std::size_t                        m_Begin = 0, m_End = 0; // Into m_Order
+		std::int64_t                       m_Min[3], m_Max[3];     // Chunks the bodies can reach
+		std::vector<const ChunkOccupancy*> m_Window;               // Over m_Min to m_Max, nullptr for missing chunks
+		std::size_t                        m_Blocked = 0;
+	};
+
+	// Whether a voxel from first to last inclusive is solid, world coordinates inside the group's window.
+	static bool   AnySolid(const Group& group, const std::int64_t (&first)[3], const std::int64_t (&last)[3]);
+	// Part of motion along axis the box can move before it touches a solid voxel.
+	static double Clip(const Group& group, std::uint32_t axis, const double (&min)[3], const double (&max)[3], double motion);
+
+	void resolve(Group& group);
+
+private:
+	WorkerPool& m_Workers;
+
+	std::vector<Chunk*>                                  m_Stale;
+	std::vector<std::pair<std::uint64_t, std::uint32_t>> m_Order; // Morton code of the start chunk, body index
+	std::vector<std::pair<std::uint64_t, std::uint32_t>> m_Moved; // Bodies whose start chunk changed since the last call
+	std::vector<std::pair<std::uint64_t, std::uint32_t>> m_Merged;
+	std::vector<Group>                                   m_Groups;
+	std::size_t                                          m_GroupCount = 0;
+	std::vector<CollisionBody>*                          m_Bodies     = nullptr;
+	const Dimension*                                     m_Dimension  = nullptr;
+	CollisionStats                                       m_Stats;
+};
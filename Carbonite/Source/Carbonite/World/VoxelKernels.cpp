@@ -0,0 +1,375 @@
+#include "VoxelKernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define VOXEL_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define VOXEL_KERNELS_X86 0
+#endif
+
+namespace
+{
+	using CountFunc     = std::size_t (*)(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index);
+	using FindFirstFunc = std::size_t (*)(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index);
+	using ReplaceFunc   = std::size_t (*)(std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t from, std::uint32_t to);
+
+	struct KernelSet
+	{
+	public:
+		CountFunc     m_Count;
+		FindFirstFunc m_FindFirst;
+		ReplaceFunc   m_Replace;
+	};
+
+	// Lowest bit of every lane.
+	std::uint64_t LowBits(std::uint32_t bits)
+	{
+		return ~0ULL / ((1ULL << bits) - 1);
+	}
+
+	// Lowest bit of every lane of word that holds index.
+	std::uint64_t MatchWord(std::uint64_t word, std::uint64_t pattern, std::uint64_t low, std::uint32_t bits)
+	{
+		std::uint64_t x = word ^ pattern;
+		for (std::uint32_t shift = 1; shift < bits; shift <<= 1)
+			x |= x >> shift;
+		return ~x & low;
+	}
+
+	// Spreads the lowest bit of every lane over the whole lane.
+	std::uint64_t ExpandWord(std::uint64_t matches, std::uint32_t bits)
+	{
+		for (std::uint32_t shift = 1; shift < bits; shift <<= 1)
+			matches |= matches << shift;
+		return matches;
+	}
+
+	std::size_t CountScalar(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index)
+	{
+		std::uint64_t low     = LowBits(bits);
+		std::uint64_t pattern = index * low;
+		std::size_t   count   = 0;
+		for (std::size_t i = 0; i < wordCount; ++i)
+			count += static_cast<std::size_t>(std::popcount(MatchWord(words[i], pattern, low, bits)));
+		return count;
+	}
+
+	std::size_t FindFirstScalar(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index)
+	{
+		std::uint64_t low     = LowBits(bits);
+		std::uint64_t pattern = index * low;
+		for (std::size_t i = 0; i < wordCount; ++i)
+		{
+			std::uint64_t matches = MatchWord(words[i], pattern, low, bits);
+			if (matches)
+				return i * (64 / bits) + static_cast<std::size_t>(std::countr_zero(matches)) / bits;
+		}
+		return wordCount * (64 / bits);
+	}
+
+	std::size_t ReplaceScalar(std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t from, std::uint32_t to)
+	{
+		std::uint64_t low     = LowBits(bits);
+		std::uint64_t pattern = from * low;
+		std::uint64_t change  = (from ^ to) * low;
+		std::size_t   count   = 0;
+		for (std::size_t i = 0; i < wordCount; ++i)
+		{
+			std::uint64_t matches = MatchWord(words[i], pattern, low, bits);
+			words[i] ^= ExpandWord(matches, bits) & change;
+			count += static_cast<std::size_t>(std::popcount(matches));
+		}
+		return count;
+	}
+
+	constexpr KernelSet ScalarSet { &CountScalar, &FindFirstScalar, &ReplaceScalar };
+
+#if VOXEL_KERNELS_X86
+	// The SIMD sets are compiled for their instruction set regardless of the target flags and only called once CPUID said so.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.1"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#endif
+
+	__m128i MatchSSE41(__m128i word, __m128i pattern, __m128i low, std::uint32_t bits)
+	{
+		// Byte and word lanes have a native compare.
+		if (bits == 8)
+			return _mm_and_si128(_mm_cmpeq_epi8(word, pattern), low);
+		if (bits == 16)
+			return _mm_and_si128(_mm_cmpeq_epi16(word, pattern), low);
+
+		__m128i x = _mm_xor_si128(word, pattern);
+		for (std::uint32_t shift = 1; shift < bits; shift <<= 1)
+			x = _mm_or_si128(x, _mm_srl_epi64(x, _mm_cvtsi32_si128(static_cast<int>(shift))));
+		return _mm_andnot_si128(x, low);
+	}
+
+	// Bytes of v to their bit counts, then summed into the two 64 bit halves of total.
+	__m128i AddPopCountSSE41(__m128i total, __m128i v)
+	{
+		__m128i table  = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		__m128i nibble = _mm_set1_epi8(0x0F);
+		__m128i counts = _mm_add_epi8(_mm_shuffle_epi8(table, _mm_and_si128(v, nibble)), _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble)));
+		return _mm_add_epi64(total, _mm_sad_epu8(counts, _mm_setzero_si128()));
+	}
+
+	std::size_t SumSSE41(__m128i total)
+	{
+		return static_cast<std::size_t>(_mm_cvtsi128_si64(total) + _mm_extract_epi64(total, 1));
+	}
+
+	std::size_t CountSSE41(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index)
+	{
+		std::uint64_t scalarLow = LowBits(bits);
+		__m128i       low       = _mm_set1_epi64x(static_cast<long long>(scalarLow));
+		__m128i       pattern   = _mm_set1_epi64x(static_cast<long long>(index * scalarLow));
+		__m128i       total     = _mm_setzero_si128();
+		std::size_t   i         = 0;
+		for (; i + 2 <= wordCount; i += 2)
+			total = AddPopCountSSE41(total, MatchSSE41(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i)), pattern, low, bits));
+		return SumSSE41(total) + CountScalar(words + i, wordCount - i, bits, index);
+	}
+
+	std::size_t FindFirstSSE41(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index)
+	{
+		std::uint64_t scalarLow = LowBits(bits);
+		__m128i       low       = _mm_set1_epi64x(static_cast<long long>(scalarLow));
+		__m128i       pattern   = _mm_set1_epi64x(static_cast<long long>(index * scalarLow));
+		std::size_t   i         = 0;
+		for (; i + 2 <= wordCount; i += 2)
+		{
+			__m128i matches = MatchSSE41(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i)), pattern, low, bits);
+			if (!_mm_testz_si128(matches, matches))
+				break;
+		}
+		return i * (64 / bits) + FindFirstScalar(words + i, wordCount - i, bits, index);
+	}
+
+	std::size_t ReplaceSSE41(std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t from, std::uint32_t to)
+	{
+		std::uint64_t scalarLow = LowBits(bits);
+		__m128i       low       = _mm_set1_epi64x(static_cast<long long>(scalarLow));
+		__m128i       pattern   = _mm_set1_epi64x(static_cast<long long>(from * scalarLow));
+		__m128i       change    = _mm_set1_epi64x(static_cast<long long>((from ^ to) * scalarLow));
+		__m128i       total     = _mm_setzero_si128();
+		std::size_t   i         = 0;
+		for (; i + 2 <= wordCount; i += 2)
+		{
+			__m128i* word     = reinterpret_cast<__m128i*>(words + i);
+			__m128i  matches  = MatchSSE41(_mm_loadu_si128(word), pattern, low, bits);
+			__m128i  expanded = matches;
+			for (std::uint32_t shift = 1; shift < bits; shift <<= 1)
+				expanded = _mm_or_si128(expanded, _mm_sll_epi64(expanded, _mm_cvtsi32_si128(static_cast<int>(shift))));
+			_mm_storeu_si128(word, _mm_xor_si128(_mm_loadu_si128(word), _mm_and_si128(expanded, change)));
+			total = AddPopCountSSE41(total, matches);
+		}
+		return SumSSE41(total) + ReplaceScalar(words + i, wordCount - i, bits, from, to);
+	}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+	__m256i MatchAVX2(__m256i word, __m256i pattern, __m256i low, std::uint32_t bits)
+	{
+		if (bits == 8)
+			return _mm256_and_si256(_mm256_cmpeq_epi8(word, pattern), low);
+		if (bits == 16)
+			return _mm256_and_si256(_mm256_cmpeq_epi16(word, pattern), low);
+
+		__m256i x = _mm256_xor_si256(word, pattern);
+		for (std::uint32_t shift = 1; shift < bits; shift <<= 1)
+			x = _mm256_or_si256(x, _mm256_srl_epi64(x, _mm_cvtsi32_si128(static_cast<int>(shift))));
+		return _mm256_andnot_si256(x, low);
+	}
+
+	__m256i AddPopCountAVX2(__m256i total, __m256i v)
+	{
+		__m256i table  = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		__m256i nibble = _mm256_set1_epi8(0x0F);
+		__m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble)), _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+		return _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+	}
+
+	std::size_t SumAVX2(__m256i total)
+	{
+		__m128i half = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+		return static_cast<std::size_t>(_mm_cvtsi128_si64(half) + _mm_extract_epi64(half, 1));
+	}
+
+	std::size_t CountAVX2(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index)
+	{
+		std::uint64_t scalarLow = LowBits(bits);
+		__m256i       low       = _mm256_set1_epi64x(static_cast<long long>(scalarLow));
+		__m256i       pattern   = _mm256_set1_epi64x(static_cast<long long>(index * scalarLow));
+		__m256i       total     = _mm256_setzero_si256();
+		std::size_t   i         = 0;
+		for (; i + 4 <= wordCount; i += 4)
+			total = AddPopCountAVX2(total, MatchAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i)), pattern, low, bits));
+		return SumAVX2(total) + CountScalar(words + i, wordCount - i, bits, index);
+	}
+
+	std::size_t FindFirstAVX2(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index)
+	{
+		std::uint64_t scalarLow = LowBits(bits);
+		__m256i       low       = _mm256_set1_epi64x(static_cast<long long>(scalarLow));
+		__m256i       pattern   = _mm256_set1_epi64x(static_cast<long long>(index * scalarLow));
+		std::size_t   i         = 0;
+		for (; i + 4 <= wordCount; i += 4)
+		{
+			__m256i matches = MatchAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i)), pattern, low, bits);
+			if (!_mm256_testz_si256(matches, matches))
+				break;
+		}
+		return i * (64 / bits) + FindFirstScalar(words + i, wordCount - i, bits, index);
+	}
+
+	std::size_t ReplaceAVX2(std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t from, std::uint32_t to)
+	{
+		std::uint64_t scalarLow = LowBits(bits);
+		__m256i       low       = _mm256_set1_epi64x(static_cast<long long>(scalarLow));
+		__m256i       pattern   = _mm256_set1_epi64x(static_cast<long long>(from * scalarLow));
+		__m256i       change    = _mm256_set1_epi64x(static_cast<long long>((from ^ to) * scalarLow));
+		__m256i       total     = _mm256_setzero_si256();
+		std::size_t   i         = 0;
+		for (; i + 4 <= wordCount; i += 4)
+		{
+			__m256i* word     = reinterpret_cast<__m256i*>(words + i);
+			__m256i  matches  = MatchAVX2(_mm256_loadu_si256(word), pattern, low, bits);
+			__m256i  expanded = matches;
+			for (std::uint32_t shift = 1; shift < bits; shift <<= 1)
+				expanded = _mm256_or_si256(expanded, _mm256_sll_epi64(expanded, _mm_cvtsi32_si128(static_cast<int>(shift))));
+			_mm256_storeu_si256(word, _mm256_xor_si256(_mm256_loadu_si256(word), _mm256_and_si256(expanded, change)));
+			total = AddPopCountAVX2(total, matches);
+		}
+		return SumAVX2(total) + ReplaceScalar(words + i, wordCount - i, bits, from, to);
+	}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+	constexpr KernelSet SSE41Set { &CountSSE41, &FindFirstSSE41, &ReplaceSSE41 };
+	constexpr KernelSet AVX2Set { &CountAVX2, &FindFirstAVX2, &ReplaceAVX2 };
+#endif
+
+	EVoxelKernelSet DetectSet()
+	{
+#if VOXEL_KERNELS_X86 && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		bool sse41 = (info[2] & (1 << 19)) != 0;
+		// AVX needs the OS to save the upper halves of the registers.
+		bool ymm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+		__cpuidex(info, 7, 0);
+		bool avx2 = ymm && (info[1] & (1 << 5));
+		return avx2 ? EVoxelKernelSet::AVX2 : (sse41 ? EVoxelKernelSet::SSE41 : EVoxelKernelSet::Scalar);
+#elif VOXEL_KERNELS_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return EVoxelKernelSet::AVX2;
+		if (__builtin_cpu_supports("sse4.1"))
+			return EVoxelKernelSet::SSE41;
+		return EVoxelKernelSet::Scalar;
+#else
+		return EVoxelKernelSet::Scalar;
+#endif
+	}
+
+	std::atomic<EVoxelKernelSet>& GetCurrentSet()
+	{
+		static std::atomic<EVoxelKernelSet> s_Set = VoxelKernels::getSupportedSet();
+		return s_Set;
+	}
+
+	const KernelSet& GetKernels()
+	{
+		switch (GetCurrentSet().load(std::memory_order_relaxed))
+		{
+#if VOXEL_KERNELS_X86
+		case EVoxelKernelSet::AVX2: return AVX2Set;
+		case EVoxelKernelSet::SSE41: return SSE41Set;
+#endif
+		default: return ScalarSet;
+		}
+	}
+} // namespace
+
+namespace VoxelKernels
+{
+	EVoxelKernelSet getSupportedSet()
+	{
+		static const EVoxelKernelSet s_Supported = DetectSet();
+		return s_Supported;
+	}
+
+	EVoxelKernelSet getKernelSet()
+	{
+		return GetCurrentSet().load(std::memory_order_relaxed);
+	}
+
+	void setKernelSet(EVoxelKernelSet set)
+	{
+		GetCurrentSet().store(std::min(set, getSupportedSet()), std::memory_order_relaxed);
+	}
+
+	std::size_t count(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index)
+	{
+		return GetKernels().m_Count(words, wordCount, bits, index);
+	}
+
+	std::size_t findFirst(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index)
+	{
+		return GetKernels().m_FindFirst(words, wordCount, bits, index);
+	}
+
+	std::size_t replace(std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t from, std::uint32_t to)
+	{
+		return GetKernels().m_Replace(words, wordCount, bits, from, to);
+	}
+
+	void histogram(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t* counts, std::size_t countSize)
+	{
+		// A handful of indices is cheapest as one vectorised count per index, wider palettes are tallied index by index.
+		if (countSize <= 8)
+		{
+			for (std::uint32_t i = 0; i < countSize; ++i)
+				counts[i] = static_cast<std::uint32_t>(count(words, wordCount, bits, i));
+			return;
+		}
+
+		std::fill_n(counts, countSize, 0);
+		std::uint32_t indicesPerWord = 64 / bits;
+		std::uint64_t mask           = (1ULL << bits) - 1;
+		std::uint64_t low            = LowBits(bits);
+		for (std::size_t i = 0; i < wordCount; ++i)
+		{
+			std::uint64_t word = words[i];
+			// Words of a single repeated index are common after fills.
+			if (word == (word & mask) * low)
+			{
+				counts[static_cast<std::size_t>(word & mask)] += indicesPerWord;
+				continue;
+			}
+			for (std::uint32_t j = 0; j < indicesPerWord; ++j, word >>= bits)
+				++counts[static_cast<std::size_t>(word & mask)];
+		}
+	}
+} // namespace VoxelKernels
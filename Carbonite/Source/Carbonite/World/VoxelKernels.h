@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class EVoxelKernelSet : std::uint8_t
+{
+	Scalar, // SWAR on 64 bit words
+	SSE41,  // 2 words per step
+	AVX2    // 4 words per step
+};
+
+// Bulk kernels over bit packed palette indices (see ChunkStorage), the index width bits must be 1, 2, 4, 8 or 16.
+// Every word is compared against the palette index replicated across a word, a lane matches if the xor of the two is zero,
+// which is folded down to the lowest bit of the lane with shifts. All sets produce identical results, the widest set the
+// CPU supports is picked with CPUID on first use.
+namespace VoxelKernels
+{
+	EVoxelKernelSet getSupportedSet();
+	EVoxelKernelSet getKernelSet();
+	// Forces a set, clamped to the supported ones, for comparisons and benchmarks.
+	void            setKernelSet(EVoxelKernelSet set);
+
+	// Number of indices equal to index.
+	std::size_t count(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index);
+	// Position of the first index equal to index, wordCount * (64 / bits) if there is none.
+	std::size_t findFirst(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t index);
+	// Rewrites every index equal to from to to, returns how many were rewritten.
+	std::size_t replace(std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t from, std::uint32_t to);
+	// counts[i] is set to the number of indices equal to i, every index in words must be below countSize.
+	void        histogram(const std::uint64_t* words, std::size_t wordCount, std::uint32_t bits, std::uint32_t* counts, std::size_t countSize);
+} // namespace VoxelKernels
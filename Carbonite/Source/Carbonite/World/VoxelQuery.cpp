@@ -0,0 +1,293 @@
+#include "VoxelQuery.h"
+#include "Dimension.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	constexpr double       Infinity   = std::numeric_limits<double>::infinity();
+	constexpr std::int64_t ChunkSize  = static_cast<std::int64_t>(Chunk::Size);
+	constexpr std::size_t  RaysPerJob = 256;
+
+	bool IsEmptyChunk(const BlockStateTable& blockStates, const Chunk* chunk)
+	{
+		return !chunk || (chunk->getVoxels().isUniform() && !blockStates.isSolid(chunk->getVoxels().get(0)));
+	}
+
+	EFace FaceOf(std::uint32_t axis, bool positive)
+	{
+		return static_cast<EFace>(axis * 2 + (positive ? 1 : 0));
+	}
+
+	std::uint32_t MinAxis(const double (&values)[3])
+	{
+		return values[0] < values[1] ? (values[0] < values[2] ? 0 : 2) : (values[1] < values[2] ? 1 : 2);
+	}
+
+	struct RayState
+	{
+	public:
+		double origin[3];
+		double direction[3];
+		double maxDistance;
+	};
+
+	void FillHit(VoxelHit& hit, const RayState& ray, const std::int64_t (&voxel)[3], double distance, EFace face, std::uint64_t state)
+	{
+		hit.m_Hit      = true;
+		hit.m_X        = voxel[0];
+		hit.m_Y        = voxel[1];
+		hit.m_Z        = voxel[2];
+		hit.m_Position = { static_cast<float>(ray.origin[0] + ray.direction[0] * distance),
+			               static_cast<float>(ray.origin[1] + ray.direction[1] * distance),
+			               static_cast<float>(ray.origin[2] + ray.direction[2] * distance) };
+		hit.m_Distance = static_cast<float>(distance);
+		hit.m_Face     = face;
+		hit.m_State    = state;
+	}
+
+	// Walks the voxels of one chunk between entry and exit, entryAxis is the axis the ray crossed to get in or -1 if it starts inside.
+	bool TraverseChunk(const BlockStateTable& blockStates, const Chunk& chunk, const std::int64_t (&cell)[3], const RayState& ray, double entry, double exit, int entryAxis, VoxelHit& hit)
+	{
+		auto&        voxels = chunk.getVoxels();
+		std::int64_t base[3] { cell[0] * ChunkSize, cell[1] * ChunkSize, cell[2] * ChunkSize };
+
+		std::int64_t local[3];
+		std::int64_t step[3];
+		double       tMax[3];
+		double       tDelta[3];
+		for (std::uint32_t a = 0; a < 3; ++a)
+		{
+			double position = ray.origin[a] + ray.direction[a] * entry;
+			local[a]        = std::clamp<std::int64_t>(static_cast<std::int64_t>(std::floor(position)) - base[a], 0, ChunkSize - 1);
+			step[a]         = ray.direction[a] > 0.0 ? 1 : (ray.direction[a] < 0.0 ? -1 : 0);
+			if (step[a] == 0)
+			{
+				tMax[a]   = Infinity;
+				tDelta[a] = Infinity;
+			}
+			else
+			{
+				// Rounding can put the entry point a hair outside, the crossed axis is known exactly.
+				if (static_cast<int>(a) == entryAxis)
+					local[a] = step[a] > 0 ? 0 : ChunkSize - 1;
+				double boundary = static_cast<double>(base[a] + local[a] + (step[a] > 0 ? 1 : 0));
+				tMax[a]         = (boundary - ray.origin[a]) / ray.direction[a];
+				tDelta[a]       = 1.0 / std::fabs(ray.direction[a]);
+			}
+		}
+
+		double        distance = entry;
+		int           axis     = entryAxis;
+		std::uint32_t size     = static_cast<std::uint32_t>(ChunkSize);
+		while (true)
+		{
+			std::uint64_t state = voxels.get(Chunk::PositionToIndex(static_cast<std::uint32_t>(local[0]), static_cast<std::uint32_t>(local[1]), static_cast<std::uint32_t>(local[2])));
+			if (blockStates.isSolid(state))
+			{
+				std::int64_t voxel[3] { base[0] + local[0], base[1] + local[1], base[2] + local[2] };
+				EFace        face;
+				if (axis < 0)
+				{
+					// Started inside, report the face the ray points away from.
+					double absolute[3] { -std::fabs(ray.direction[0]), -std::fabs(ray.direction[1]), -std::fabs(ray.direction[2]) };
+					std::uint32_t dominant = MinAxis(absolute);
+					face                   = FaceOf(dominant, ray.direction[dominant] < 0.0);
+				}
+				else
+				{
+					face = FaceOf(static_cast<std::uint32_t>(axis), step[axis] < 0);
+				}
+				FillHit(hit, ray, voxel, distance, face, state);
+				return true;
+			}
+
+			std::uint32_t next = MinAxis(tMax);
+			distance           = tMax[next];
+			if (distance > exit)
+				return false;
+
+			local[next] += step[next];
+			if (local[next] < 0 || local[next] >= static_cast<std::int64_t>(size))
+				return false;
+			tMax[next] += tDelta[next];
+			axis = static_cast<int>(next);
+		}
+	}
+} // namespace
+
+namespace VoxelQuery
+{
+	bool raycast(const Dimension& dimension, const VoxelRay& ray, VoxelHit& hit)
+	{
+		hit.m_Hit = false;
+
+		RayState state;
+		state.origin[0] = ray.m_Origin.x;
+		state.origin[1] = ray.m_Origin.y;
+		state.origin[2] = ray.m_Origin.z;
+
+		double length = std::sqrt(static_cast<double>(ray.m_Direction.x) * ray.m_Direction.x + static_cast<double>(ray.m_Direction.y) * ray.m_Direction.y + static_cast<double>(ray.m_Direction.z) * ray.m_Direction.z);
+		if (length == 0.0)
+			return false;
+		state.direction[0] = ray.m_Direction.x / length;
+		state.direction[1] = ray.m_Direction.y / length;
+		state.direction[2] = ray.m_Direction.z / length;
+		state.maxDistance  = ray.m_MaxDistance;
+
+		// Outer traversal over whole chunks, only chunks with something solid in them are walked voxel by voxel.
+		std::int64_t cell[3];
+		std::int64_t step[3];
+		double       tMax[3];
+		double       tDelta[3];
+		for (std::uint32_t a = 0; a < 3; ++a)
+		{
+			cell[a] = static_cast<std::int64_t>(std::floor(state.origin[a] / ChunkSize));
+			step[a] = state.direction[a] > 0.0 ? 1 : (state.direction[a] < 0.0 ? -1 : 0);
+			if (step[a] == 0)
+			{
+				tMax[a]   = Infinity;
+				tDelta[a] = Infinity;
+			}
+			else
+			{
+				double boundary = static_cast<double>((cell[a] + (step[a] > 0 ? 1 : 0)) * ChunkSize);
+				tMax[a]         = (boundary - state.origin[a]) / state.direction[a];
+				tDelta[a]       = ChunkSize / std::fabs(state.direction[a]);
+			}
+		}
+
+		auto&  blockStates = dimension.getBlockStates();
+		double entry       = 0.0;
+		int    entryAxis   = -1;
+		while (entry <= state.maxDistance)
+		{
+			std::uint32_t axis = MinAxis(tMax);
+			double        exit = std::min(tMax[axis], state.maxDistance);
+
+			const Chunk* chunk = dimension.getChunk(cell[0], cell[1], cell[2]);
+			if (!IsEmptyChunk(blockStates, chunk) && TraverseChunk(blockStates, *chunk, cell, state, entry, exit, entryAxis, hit))
+				return true;
+
+			entry     = tMax[axis];
+			entryAxis = static_cast<int>(axis);
+			cell[axis] += step[axis];
+			tMax[axis] += tDelta[axis];
+		}
+		return false;
+	}
+
+	void raycast(const Dimension& dimension, const std::vector<VoxelRay>& rays, std::vector<VoxelHit>& hits, WorkerPool* workers)
+	{
+		hits.resize(rays.size());
+		if (!workers)
+		{
+			for (std::size_t i = 0; i < rays.size(); ++i)
+				raycast(dimension, rays[i], hits[i]);
+			return;
+		}
+
+		workers->parallelFor((rays.size() + RaysPerJob - 1) / RaysPerJob, [&](std::size_t job) {
+			std::size_t end = std::min((job + 1) * RaysPerJob, rays.size());
+			for (std::size_t i = job * RaysPerJob; i < end; ++i)
+				raycast(dimension, rays[i], hits[i]);
+		});
+	}
+
+	bool sweep(const Dimension& dimension, const glm::fvec3& min, const glm::fvec3& max, const glm::fvec3& motion, VoxelHit& hit)
+	{
+		hit.m_Hit = false;
+
+		double boxMin[3] { min.x, min.y, min.z };
+		double boxMax[3] { max.x, max.y, max.z };
+		double delta[3] { motion.x, motion.y, motion.z };
+
+		// Every voxel the swept box could touch, including the ones it ends up exactly against.
+		std::int64_t first[3];
+		std::int64_t last[3];
+		for (std::uint32_t a = 0; a < 3; ++a)
+		{
+			first[a] = static_cast<std::int64_t>(std::floor(std::min(boxMin[a], boxMin[a] + delta[a])));
+			last[a]  = static_cast<std::int64_t>(std::ceil(std::max(boxMax[a], boxMax[a] + delta[a]))) - 1;
+		}
+
+		auto&  blockStates = dimension.getBlockStates();
+		double best        = 1.0;
+		for (std::int64_t cz = first[2] >> 5; cz <= last[2] >> 5; ++cz)
+		{
+			for (std::int64_t cy = first[1] >> 5; cy <= last[1] >> 5; ++cy)
+			{
+				for (std::int64_t cx = first[0] >> 5; cx <= last[0] >> 5; ++cx)
+				{
+					const Chunk* chunk = dimension.getChunk(cx, cy, cz);
+					if (IsEmptyChunk(blockStates, chunk))
+						continue;
+
+					std::int64_t base[3] { cx * ChunkSize, cy * ChunkSize, cz * ChunkSize };
+					std::int64_t from[3];
+					std::int64_t to[3];
+					for (std::uint32_t a = 0; a < 3; ++a)
+					{
+						from[a] = std::max(first[a], base[a]);
+						to[a]   = std::min(last[a], base[a] + ChunkSize - 1);
+					}
+
+					auto& voxels = chunk->getVoxels();
+					for (std::int64_t z = from[2]; z <= to[2]; ++z)
+					{
+						for (std::int64_t y = from[1]; y <= to[1]; ++y)
+						{
+							for (std::int64_t x = from[0]; x <= to[0]; ++x)
+							{
+								std::uint64_t state = voxels.get(Chunk::PositionToIndex(static_cast<std::uint32_t>(x - base[0]), static_cast<std::uint32_t>(y - base[1]), static_cast<std::uint32_t>(z - base[2])));
+								if (!blockStates.isSolid(state))
+									continue;
+
+								// Slab test of the moving box against the voxel.
+								std::int64_t  voxel[3] { x, y, z };
+								double        enter     = -Infinity;
+								double        leave     = Infinity;
+								std::uint32_t enterAxis = 0;
+								bool          missed    = false;
+								for (std::uint32_t a = 0; a < 3 && !missed; ++a)
+								{
+									double voxelMin = static_cast<double>(voxel[a]);
+									double voxelMax = voxelMin + 1.0;
+									if (delta[a] == 0.0)
+									{
+										missed = boxMax[a] <= voxelMin || boxMin[a] >= voxelMax;
+										continue;
+									}
+
+									double axisEnter = delta[a] > 0.0 ? (voxelMin - boxMax[a]) / delta[a] : (voxelMax - boxMin[a]) / delta[a];
+									double axisLeave = delta[a] > 0.0 ? (voxelMax - boxMin[a]) / delta[a] : (voxelMin - boxMax[a]) / delta[a];
+									if (axisEnter > enter)
+									{
+										enter     = axisEnter;
+										enterAxis = a;
+									}
+									leave = std::min(leave, axisLeave);
+								}
+								if (missed || enter >= leave || enter < 0.0 || enter > best || (hit.m_Hit && enter == best))
+									continue;
+
+								best           = enter;
+								hit.m_Hit      = true;
+								hit.m_X        = x;
+								hit.m_Y        = y;
+								hit.m_Z        = z;
+								hit.m_Position = { static_cast<float>(boxMin[0] + delta[0] * enter), static_cast<float>(boxMin[1] + delta[1] * enter), static_cast<float>(boxMin[2] + delta[2] * enter) };
+								hit.m_Distance = static_cast<float>(enter);
+								hit.m_Face     = FaceOf(enterAxis, delta[enterAxis] < 0.0);
+								hit.m_State    = state;
+							}
+						}
+					}
+				}
+			}
+		}
+		return hit.m_Hit;
+	}
+} // namespace VoxelQuery
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ChunkCoord.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Dimension;
+class WorkerPool;
+
+struct VoxelRay
+{
+public:
+	glm::fvec3 m_Origin;
+	glm::fvec3 m_Direction; // Does not need to be normalised
+	float      m_MaxDistance = 64.0f;
+};
+
+struct VoxelHit
+{
+public:
+	bool          m_Hit = false;
+	std::int64_t  m_X = 0, m_Y = 0, m_Z = 0;     // Voxel that was hit
+	glm::fvec3    m_Position;                    // Point where the ray or the box met the voxel
+	float         m_Distance = 0.0f;             // Along the ray, or the fraction of the motion for sweeps
+	EFace         m_Face     = EFace::PositiveZ; // Face of the voxel that was hit
+	std::uint64_t m_State    = 0;
+};
+
+// Ray and box queries against the voxels of a dimension, solidity comes from the dimension's block state table and chunks that
+// are not loaded are empty. Queries only read, any number may run at the same time as long as no chunk is modified.
+namespace VoxelQuery
+{
+	// Amanatides-Woo traversal, stepping whole chunks at a time through chunks that are missing or uniformly empty.
+	// A ray starting inside a solid voxel hits it at distance 0.
+	bool raycast(const Dimension& dimension, const VoxelRay& ray, VoxelHit& hit);
+	// Casts every ray, in jobs of a few hundred rays on workers if given and on the calling thread otherwise.
+	// hits is resized to rays.size().
+	void raycast(const Dimension& dimension, const std::vector<VoxelRay>& rays, std::vector<VoxelHit>& hits, WorkerPool* workers = nullptr);
+
+	// Moves the box [min, max] by motion and returns the first solid voxel it touches, m_Position is the box min at that point.
+	// Voxels the box already overlaps are ignored so a stuck box can move out. Tests every voxel in the swept bounds, meant for
+	// entity sized boxes and per tick motion.
+	bool sweep(const Dimension& dimension, const glm::fvec3& min, const glm::fvec3& max, const glm::fvec3& motion, VoxelHit& hit);
+} // namespace VoxelQuery
@@ -1,11 +1,16 @@
 #pragma once
 
+#include "PerfectHash.h"
+
+#include <cstddef>
 #include <cstdint>
 
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 template <class T>
 struct RegistryValue
@@ -15,54 +20,203 @@ public:
 	T           m_Value;
 };
 
+// Entries are added to hash maps while mods load, freeze() then moves them into one array with dense indices and builds
+// minimal perfect hashes over the ids and the names, so lookups afterwards do not touch node based containers or allocate.
+// A frozen registry does not take new entries until it is cleared.
 template <class T>
 class Registry
 {
+public:
+	static constexpr std::size_t InvalidIndex = ~std::size_t { 0 };
+
 public:
 	void clear()
 	{
-		m_Entries.clear();
 		m_NameToId.clear();
+		m_Entries.clear();
+		m_Frozen = false;
+		m_Values.clear();
+		m_Names.clear();
+		m_NameIndices.clear();
+		m_IdHash.clear();
+		m_NameHash.clear();
 	}
 
 	bool addEntry(std::string_view name, std::uint64_t id, T&& value)
 	{
-		if (m_Entries.find(id) != m_Entries.end() || m_NameToId.find(std::string { name }) != m_NameToId.end())
+		if (m_Frozen || m_Entries.find(id) != m_Entries.end() || m_NameToId.find(name) != m_NameToId.end())
 			return false;
 
-		m_Entries.insert({ id, { name, std::move(value) } });
-		m_NameToId.insert({ std::string { name }, id });
+		// The name key views the entry's own string, nodes do not move when the map rehashes.
+		auto itr = m_Entries.insert({ id, { std::string { name }, std::move(value) } }).first;
+		m_NameToId.insert({ itr->second.m_Name, id });
 		return true;
 	}
 
-	T* get(std::uint64_t id) const
+	void freeze()
+	{
+		if (m_Frozen)
+			return;
+
+		std::vector<std::uint64_t> ids;
+		ids.reserve(m_Entries.size());
+		for (auto& [id, entry] : m_Entries)
+			ids.push_back(PerfectHash::Mix(id));
+		if (!m_IdHash.build(ids))
+			throw std::runtime_error("Duplicate registry ids");
+
+		m_Values.resize(m_Entries.size());
+		m_NameIndices.resize(m_Entries.size());
+		std::size_t nameSize = 0;
+		for (auto& [id, entry] : m_Entries)
+			nameSize += entry.m_Name.size();
+		m_Names.reserve(nameSize);
+
+		// Names only collide on all 64 bits by accident, another seed separates them.
+		std::vector<std::uint64_t> names(m_Entries.size());
+		for (m_NameSeed = 0; m_NameSeed < 16; ++m_NameSeed)
+		{
+			std::size_t i = 0;
+			for (auto& [id, entry] : m_Entries)
+				names[i++] = PerfectHash::Hash(entry.m_Name, m_NameSeed);
+			if (m_NameHash.build(names))
+				break;
+		}
+		if (m_NameSeed == 16)
+			throw std::runtime_error("Duplicate registry names");
+
+		for (auto& [id, entry] : m_Entries)
+		{
+			std::size_t index = m_IdHash.getSlot(PerfectHash::Mix(id));
+			auto&       value = m_Values[index];
+
+			value.m_Id         = id;
+			value.m_NameOffset = m_Names.size();
+			value.m_NameLength = entry.m_Name.size();
+			value.m_Value      = std::move(entry.m_Value);
+			m_Names += entry.m_Name;
+
+			m_NameIndices[m_NameHash.getSlot(PerfectHash::Hash(entry.m_Name, m_NameSeed))] = static_cast<std::uint32_t>(index);
+		}
+
+		m_NameToId = {};
+		m_Entries  = {};
+		m_Frozen   = true;
+	}
+
+	// Dense index in [0, getSize()) of a frozen registry, InvalidIndex if there is no such entry or the registry is not frozen.
+	std::size_t getIndex(std::uint64_t id) const
+	{
+		if (!m_Frozen || m_Values.empty())
+			return InvalidIndex;
+		std::size_t index = m_IdHash.getSlot(PerfectHash::Mix(id));
+		return m_Values[index].m_Id == id ? index : InvalidIndex;
+	}
+
+	std::size_t getIndex(std::string_view name) const
 	{
+		if (!m_Frozen || m_Values.empty())
+			return InvalidIndex;
+		std::size_t index = m_NameIndices[m_NameHash.getSlot(PerfectHash::Hash(name, m_NameSeed))];
+		return getFrozenName(m_Values[index]) == name ? index : InvalidIndex;
+	}
+
+	T*       get(std::uint64_t id) { return const_cast<T*>(std::as_const(*this).get(id)); }
+	const T* get(std::uint64_t id) const
+	{
+		if (m_Frozen)
+		{
+			std::size_t index = getIndex(id);
+			return index != InvalidIndex ? &m_Values[index].m_Value : nullptr;
+		}
+
 		auto itr = m_Entries.find(id);
-		return itr != m_Entries.end() ? static_cast<T*>(&itr->second.m_Value) : nullptr;
+		return itr != m_Entries.end() ? &itr->second.m_Value : nullptr;
 	}
 
-	T* get(const std::string& name) const
+	T*       get(std::string_view name) { return const_cast<T*>(std::as_const(*this).get(name)); }
+	const T* get(std::string_view name) const
 	{
+		if (m_Frozen)
+		{
+			std::size_t index = getIndex(name);
+			return index != InvalidIndex ? &m_Values[index].m_Value : nullptr;
+		}
+
 		auto itr = m_NameToId.find(name);
 		return itr != m_NameToId.end() ? get(itr->second) : nullptr;
 	}
 
-	std::uint64_t getId(const std::string& name) const
+	std::uint64_t getId(std::string_view name) const
 	{
+		if (m_Frozen)
+		{
+			std::size_t index = getIndex(name);
+			return index != InvalidIndex ? m_Values[index].m_Id : ~0ULL;
+		}
+
 		auto itr = m_NameToId.find(name);
 		return itr != m_NameToId.end() ? itr->second : ~0ULL;
 	}
 
-	std::string getName(std::uint64_t id) const
+	// Empty if there is no such entry, the view stays valid until the registry is frozen or cleared.
+	std::string_view getName(std::uint64_t id) const
 	{
+		if (m_Frozen)
+		{
+			std::size_t index = getIndex(id);
+			return index != InvalidIndex ? getFrozenName(m_Values[index]) : std::string_view {};
+		}
+
 		auto itr = m_Entries.find(id);
-		return itr != m_Entries.end() ? itr->second.m_Name : ~0ULL;
+		return itr != m_Entries.end() ? std::string_view { itr->second.m_Name } : std::string_view {};
 	}
 
-	auto& getEntries() const { return m_Entries; }
-	auto& getNameToIds() const { return m_NameToId; }
+	// Entries of a frozen registry by dense index.
+	std::uint64_t    getIdAt(std::size_t index) const { return m_Values[index].m_Id; }
+	std::string_view getNameAt(std::size_t index) const { return getFrozenName(m_Values[index]); }
+	T&               getAt(std::size_t index) { return m_Values[index].m_Value; }
+	const T&         getAt(std::size_t index) const { return m_Values[index].m_Value; }
+
+	// Calls func(id, name, value) for every entry, in dense index order once frozen.
+	template <class F>
+	void forEach(F&& func) const
+	{
+		if (m_Frozen)
+		{
+			for (auto& value : m_Values)
+				func(value.m_Id, getFrozenName(value), value.m_Value);
+			return;
+		}
+
+		for (auto& [id, entry] : m_Entries)
+			func(id, std::string_view { entry.m_Name }, entry.m_Value);
+	}
+
+	bool        isFrozen() const { return m_Frozen; }
+	std::size_t getSize() const { return m_Frozen ? m_Values.size() : m_Entries.size(); }
+
+private:
+	struct FrozenValue
+	{
+	public:
+		std::uint64_t m_Id         = ~0ULL;
+		std::size_t   m_NameOffset = 0; // Into m_Names
+		std::size_t   m_NameLength = 0;
+		T             m_Value {};
+	};
+
+	std::string_view getFrozenName(const FrozenValue& value) const { return { m_Names.data() + value.m_NameOffset, value.m_NameLength }; }
 
 private:
 	std::unordered_map<std::uint64_t, RegistryValue<T>> m_Entries;
-	std::unordered_map<std::string, std::uint64_t>      m_NameToId;
+	std::unordered_map<std::string_view, std::uint64_t> m_NameToId; // Views the names of m_Entries
+
+	bool                       m_Frozen = false;
+	std::vector<FrozenValue>   m_Values; // Indexed by the id hash's slot
+	std::string                m_Names;
+	std::vector<std::uint32_t> m_NameIndices; // Indexed by the name hash's slot
+	PerfectHash                m_IdHash;
+	PerfectHash                m_NameHash;
+	std::uint64_t              m_NameSeed = 0;
 };
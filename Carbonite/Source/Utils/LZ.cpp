@@ -0,0 +1,149 @@
+#include "LZ.h"
+
+#include <cstring>
+
+namespace
+{
+	constexpr std::uint32_t HashBits = 12;
+
+	std::uint32_t Hash(const std::uint8_t* data)
+	{
+		std::uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return (value * 2654435761U) >> (32 - HashBits);
+	}
+
+	void WriteLength(std::vector<std::uint8_t>& out, std::size_t length)
+	{
+		while (length >= 255)
+		{
+			out.push_back(255);
+			length -= 255;
+		}
+		out.push_back(static_cast<std::uint8_t>(length));
+	}
+
+	bool ReadLength(const std::uint8_t*& in, const std::uint8_t* end, std::size_t& length)
+	{
+		std::uint8_t value;
+		do
+		{
+			if (in == end)
+				return false;
+			value = *in++;
+			length += value;
+		} while (value == 255);
+		return true;
+	}
+
+	void WriteSequence(std::vector<std::uint8_t>& out, const std::uint8_t* literals, std::size_t literalCount, std::size_t matchLength, std::size_t offset)
+	{
+		std::size_t extraMatch = matchLength == 0 ? 0 : matchLength - LZ::MinMatch;
+		out.push_back(static_cast<std::uint8_t>((literalCount < 15 ? literalCount : 15) << 4 | (extraMatch < 15 ? extraMatch : 15)));
+		if (literalCount >= 15)
+			WriteLength(out, literalCount - 15);
+		out.insert(out.end(), literals, literals + literalCount);
+
+		if (matchLength == 0)
+			return;
+
+		out.push_back(static_cast<std::uint8_t>(offset & 0xFF));
+		out.push_back(static_cast<std::uint8_t>(offset >> 8));
+		if (extraMatch >= 15)
+			WriteLength(out, extraMatch - 15);
+	}
+} // namespace
+
+namespace LZ
+{
+	void compress(const std::uint8_t* in, std::size_t size, std::vector<std::uint8_t>& out)
+	{
+		// Positions are stored + 1 so 0 means empty.
+		std::uint32_t table[1 << HashBits] {};
+
+		std::size_t anchor   = 0;
+		std::size_t position = 0;
+		while (position + MinMatch <= size)
+		{
+			std::uint32_t& slot      = table[Hash(in + position)];
+			std::size_t    candidate = slot;
+			slot                     = static_cast<std::uint32_t>(position + 1);
+
+			if (candidate == 0 || position - (candidate - 1) > MaxOffset || std::memcmp(in + candidate - 1, in + position, MinMatch) != 0)
+			{
+				++position;
+				continue;
+			}
+
+			std::size_t match  = candidate - 1;
+			std::size_t length = MinMatch;
+			while (position + length < size && in[match + length] == in[position + length])
+				++length;
+
+			WriteSequence(out, in + anchor, position - anchor, length, position - match);
+			position += length;
+			anchor = position;
+			if (position + MinMatch <= size)
+				table[Hash(in + position - 2)] = static_cast<std::uint32_t>(position - 1);
+		}
+
+		WriteSequence(out, in + anchor, size - anchor, 0, 0);
+	}
+
+	bool decompress(const std::uint8_t* in, std::size_t size, std::uint8_t* out, std::size_t outSize)
+	{
+		const std::uint8_t* inEnd  = in + size;
+		std::uint8_t*       op     = out;
+		std::uint8_t*       outEnd = out + outSize;
+		while (in < inEnd)
+		{
+			std::uint8_t token        = *in++;
+			std::size_t  literalCount = token >> 4;
+			if (literalCount == 15 && !ReadLength(in, inEnd, literalCount))
+				return false;
+			if (literalCount > static_cast<std::size_t>(inEnd - in) || literalCount > static_cast<std::size_t>(outEnd - op))
+				return false;
+
+			if (literalCount > 0)
+				std::memcpy(op, in, literalCount);
+			op += literalCount;
+			in += literalCount;
+			if (in == inEnd)
+				break;
+
+			if (inEnd - in < 2)
+				return false;
+			std::size_t offset = in[0] | static_cast<std::size_t>(in[1]) << 8;
+			in += 2;
+			if (offset == 0 || offset > static_cast<std::size_t>(op - out))
+				return false;
+
+			std::size_t length = token & 15;
+			if (length == 15 && !ReadLength(in, inEnd, length))
+				return false;
+			length += MinMatch;
+			if (length > static_cast<std::size_t>(outEnd - op))
+				return false;
+
+			// Short offsets repeat a pattern, copy one period byte by byte and then continue from a multiple of the period
+			// at least 8 bytes back so the rest can be copied a word at a time.
+			const std::uint8_t* match = op - offset;
+			if (offset < 8)
+			{
+				std::size_t step = offset * ((8 + offset - 1) / offset);
+				std::size_t head = length < step ? length : step;
+				for (std::size_t i = 0; i < head; ++i)
+					op[i] = match[i];
+				op += head;
+				length -= head;
+				match = op - step;
+			}
+
+			for (; length >= 8; length -= 8, op += 8, match += 8)
+				std::memcpy(op, match, 8);
+			for (; length > 0; --length)
+				*op++ = *match++;
+		}
+		return op == outEnd;
+	}
+} // namespace LZ
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+// Byte oriented LZ77 in the spirit of LZ4, no entropy coding so decompression stays a copy loop.
+// A block is a list of sequences: token (literal length << 4 | match length - MinMatch), extra length bytes,
+// literals, 16 bit match offset, extra match length bytes. The last sequence only carries literals.
+namespace LZ
+{
+	static constexpr std::size_t MinMatch  = 4;
+	static constexpr std::size_t MaxOffset = 0xFFFF;
+
+	// Appends the compressed block to out.
+	void compress(const std::uint8_t* in, std::size_t size, std::vector<std::uint8_t>& out);
+	// Returns false if the block is malformed or does not decompress to exactly outSize bytes.
+	bool decompress(const std::uint8_t* in, std::size_t size, std::uint8_t* out, std::size_t outSize);
+} // namespace LZ
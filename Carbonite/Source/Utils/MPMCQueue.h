@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <utility>
+
+// Bounded lock free multi producer multi consumer queue.
+// Every cell carries a sequence number telling producers and consumers whose turn it is (Dmitry Vyukov's design).
+template <class T>
+class MPMCQueue
+{
+public:
+	MPMCQueue(std::size_t capacity)
+	    : m_Cells(std::make_unique<Cell[]>(std::bit_ceil(capacity < 2 ? 2 : capacity))),
+	      m_Mask(std::bit_ceil(capacity < 2 ? 2 : capacity) - 1)
+	{
+		for (std::size_t i = 0; i <= m_Mask; ++i)
+			m_Cells[i].m_Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	MPMCQueue(const MPMCQueue&) = delete;
+	MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+	bool push(T&& value)
+	{
+		Cell*       cell;
+		std::size_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell                      = &m_Cells[position & m_Mask];
+			std::size_t    sequence   = cell->m_Sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+			if (difference == 0)
+			{
+				if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_EnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->m_Value = std::move(value);
+		cell->m_Sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(T& value)
+	{
+		Cell*       cell;
+		std::size_t position = m_DequeuePosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell                      = &m_Cells[position & m_Mask];
+			std::size_t    sequence   = cell->m_Sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+			if (difference == 0)
+			{
+				if (m_DequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_DequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		value = std::move(cell->m_Value);
+		cell->m_Sequence.store(position + m_Mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	auto getCapacity() const { return m_Mask + 1; }
+
+private:
+	struct Cell
+	{
+	public:
+		std::atomic<std::size_t> m_Sequence;
+		T                        m_Value;
+	};
+
+private:
+	std::unique_ptr<Cell[]> m_Cells;
+	std::size_t             m_Mask;
+
+	alignas(64) std::atomic<std::size_t> m_EnqueuePosition = 0;
+	alignas(64) std::atomic<std::size_t> m_DequeuePosition = 0;
+};
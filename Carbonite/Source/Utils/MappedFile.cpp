@@ -0,0 +1,171 @@
+#include "MappedFile.h"
+#include "Core.h"
+
+#include <utility>
+
+#if BUILD_IS_SYSTEM_WINDOWS
+#undef APIENTRY
+#include <Windows.h>
+#elif BUILD_IS_SYSTEM_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& move) noexcept
+    : m_Open(std::exchange(move.m_Open, false)),
+      m_Data(std::exchange(move.m_Data, nullptr)),
+      m_Size(std::exchange(move.m_Size, 0)),
+      m_FileHandle(std::exchange(move.m_FileHandle, nullptr)),
+      m_MappingHandle(std::exchange(move.m_MappingHandle, nullptr)),
+      m_FileDescriptor(std::exchange(move.m_FileDescriptor, -1)) {}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& move) noexcept
+{
+	if (this != &move)
+	{
+		close();
+		m_Open           = std::exchange(move.m_Open, false);
+		m_Data           = std::exchange(move.m_Data, nullptr);
+		m_Size           = std::exchange(move.m_Size, 0);
+		m_FileHandle     = std::exchange(move.m_FileHandle, nullptr);
+		m_MappingHandle  = std::exchange(move.m_MappingHandle, nullptr);
+		m_FileDescriptor = std::exchange(move.m_FileDescriptor, -1);
+	}
+	return *this;
+}
+
+bool MappedFile::open(const std::filesystem::path& path, bool create)
+{
+	close();
+
+#if BUILD_IS_SYSTEM_WINDOWS
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	GetFileSizeEx(file, &size);
+	m_FileHandle = file;
+	m_Size       = static_cast<std::size_t>(size.QuadPart);
+#elif BUILD_IS_SYSTEM_UNIX
+	int fileDescriptor = ::open(path.c_str(), O_RDWR | (create ? O_CREAT : 0), 0644);
+	if (fileDescriptor < 0)
+		return false;
+
+	struct stat fileStat;
+	fstat(fileDescriptor, &fileStat);
+	m_FileDescriptor = fileDescriptor;
+	m_Size           = static_cast<std::size_t>(fileStat.st_size);
+#else
+	return false;
+#endif
+
+	m_Open = true;
+	if (m_Size > 0 && !map())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (!m_Open)
+		return;
+
+	unmap();
+#if BUILD_IS_SYSTEM_WINDOWS
+	CloseHandle(static_cast<HANDLE>(m_FileHandle));
+	m_FileHandle = nullptr;
+#elif BUILD_IS_SYSTEM_UNIX
+	::close(m_FileDescriptor);
+	m_FileDescriptor = -1;
+#endif
+	m_Open = false;
+	m_Size = 0;
+}
+
+bool MappedFile::resize(std::size_t size)
+{
+	if (!m_Open)
+		return false;
+	if (size == m_Size)
+		return true;
+
+	unmap();
+#if BUILD_IS_SYSTEM_WINDOWS
+	LARGE_INTEGER distance;
+	distance.QuadPart = static_cast<LONGLONG>(size);
+	if (!SetFilePointerEx(static_cast<HANDLE>(m_FileHandle), distance, nullptr, FILE_BEGIN) || !SetEndOfFile(static_cast<HANDLE>(m_FileHandle)))
+		return false;
+#elif BUILD_IS_SYSTEM_UNIX
+	if (ftruncate(m_FileDescriptor, static_cast<off_t>(size)) != 0)
+		return false;
+#endif
+	m_Size = size;
+	return m_Size == 0 || map();
+}
+
+bool MappedFile::flush()
+{
+	if (!m_Data)
+		return m_Open;
+
+#if BUILD_IS_SYSTEM_WINDOWS
+	return FlushViewOfFile(m_Data, 0) && FlushFileBuffers(static_cast<HANDLE>(m_FileHandle));
+#elif BUILD_IS_SYSTEM_UNIX
+	return msync(m_Data, m_Size, MS_SYNC) == 0;
+#else
+	return false;
+#endif
+}
+
+bool MappedFile::map()
+{
+#if BUILD_IS_SYSTEM_WINDOWS
+	HANDLE mapping = CreateFileMappingW(static_cast<HANDLE>(m_FileHandle), nullptr, PAGE_READWRITE, 0, 0, nullptr);
+	if (!mapping)
+		return false;
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, m_Size);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		return false;
+	}
+	m_MappingHandle = mapping;
+	m_Data          = static_cast<std::uint8_t*>(data);
+	return true;
+#elif BUILD_IS_SYSTEM_UNIX
+	void* data = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_SHARED, m_FileDescriptor, 0);
+	if (data == MAP_FAILED)
+		return false;
+	m_Data = static_cast<std::uint8_t*>(data);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void MappedFile::unmap()
+{
+	if (!m_Data)
+		return;
+
+#if BUILD_IS_SYSTEM_WINDOWS
+	UnmapViewOfFile(m_Data);
+	CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+	m_MappingHandle = nullptr;
+#elif BUILD_IS_SYSTEM_UNIX
+	munmap(m_Data, m_Size);
+#endif
+	m_Data = nullptr;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+
+// Read/write memory mapping of a whole file.
+// Resizing the file remaps it, so pointers returned by getData() are invalidated by resize().
+class MappedFile
+{
+public:
+	MappedFile()                  = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&& move) noexcept;
+	~MappedFile();
+
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&& move) noexcept;
+
+	bool open(const std::filesystem::path& path, bool create);
+	void close();
+
+	bool resize(std::size_t size);
+	bool flush();
+
+	bool isOpen() const { return m_Open; }
+	auto getData() { return m_Data; }
+	auto getData() const { return static_cast<const std::uint8_t*>(m_Data); }
+	auto getSize() const { return m_Size; }
+
+private:
+	bool map();
+	void unmap();
+
+private:
+	bool          m_Open = false;
+	std::uint8_t* m_Data = nullptr;
+	std::size_t   m_Size = 0;
+
+	void* m_FileHandle     = nullptr; // Windows only
+	void* m_MappingHandle  = nullptr; // Windows only
+	int   m_FileDescriptor = -1;      // Unix only
+};
@@ -0,0 +1,65 @@
+#include "PerfectHash.h"
+
+#include <algorithm>
+
+bool PerfectHash::build(const std::vector<std::uint64_t>& hashes)
+{
+	static constexpr std::uint32_t MaxDisplacement = 1 << 20;
+
+	m_Size = hashes.size();
+	m_Displacements.assign(std::max<std::size_t>((m_Size + BucketSize - 1) / BucketSize, 1), 0);
+
+	std::vector<std::vector<std::uint64_t>> buckets(m_Displacements.size());
+	for (std::uint64_t hash : hashes)
+		buckets[Reduce(hash, buckets.size())].push_back(hash);
+
+	// Placing the largest buckets first while most slots are free keeps the displacements small.
+	std::vector<std::uint32_t> order(buckets.size());
+	for (std::uint32_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&buckets](std::uint32_t lhs, std::uint32_t rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+	std::vector<bool>        taken(m_Size, false);
+	std::vector<std::size_t> slots;
+	for (std::uint32_t index : order)
+	{
+		auto& bucket = buckets[index];
+		if (bucket.empty())
+			break;
+
+		std::uint32_t displacement = 0;
+		for (; displacement < MaxDisplacement; ++displacement)
+		{
+			m_Displacements[index] = displacement;
+			slots.clear();
+			bool free = true;
+			for (std::uint64_t hash : bucket)
+			{
+				std::size_t slot = getSlot(hash);
+				if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end())
+				{
+					free = false;
+					break;
+				}
+				slots.push_back(slot);
+			}
+			if (free)
+				break;
+		}
+		if (displacement == MaxDisplacement)
+		{
+			clear();
+			return false;
+		}
+
+		for (std::size_t slot : slots)
+			taken[slot] = true;
+	}
+	return true;
+}
+
+void PerfectHash::clear()
+{
+	m_Displacements.assign(1, 0);
+	m_Size = 0;
+}
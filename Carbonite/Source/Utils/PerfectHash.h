@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <bit>
+#include <string_view>
+#include <vector>
+
+// Minimal perfect hash over a fixed set of 64 bit key hashes, hash and displace (CHD).
+// Keys are spread over buckets of about BucketSize keys, every bucket gets a displacement that moves all of its keys to
+// free slots. Looking a key up is one load from the displacement table, the slot still has to be checked against the key
+// since keys outside the set map to some slot as well.
+class PerfectHash
+{
+public:
+	static constexpr std::uint32_t BucketSize = 4;
+
+	static constexpr std::uint64_t Mix(std::uint64_t value)
+	{
+		value ^= value >> 30;
+		value *= 0xBF58'476D'1CE4'E5B9ULL;
+		value ^= value >> 27;
+		value *= 0x94D0'49BB'1331'11EBULL;
+		return value ^ (value >> 31);
+	}
+
+	// Eight bytes per step, names are mostly a namespace and a path of a few dozen characters.
+	static std::uint64_t Hash(std::string_view string, std::uint64_t seed = 0)
+	{
+		const char*   data = string.data();
+		std::size_t   size = string.size();
+		std::uint64_t hash = seed ^ (size * 0x9E37'79B9'7F4A'7C15ULL);
+		for (; size >= 8; data += 8, size -= 8)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, data, 8);
+			hash = std::rotl((hash ^ word) * 0x87C3'7B91'1142'53D5ULL, 31);
+		}
+		if (size > 0)
+		{
+			std::uint64_t word = 0;
+			std::memcpy(&word, data, size);
+			hash = std::rotl((hash ^ word) * 0x87C3'7B91'1142'53D5ULL, 31);
+		}
+		return Mix(hash);
+	}
+
+public:
+	// Returns false if no displacement separates some keys, only happens for duplicate hashes.
+	bool build(const std::vector<std::uint64_t>& hashes);
+	void clear();
+
+	// Slot in [0, getSize()) for hashes of the set, unspecified for other hashes.
+	std::size_t getSlot(std::uint64_t hash) const
+	{
+		std::uint32_t displacement = m_Displacements[Reduce(hash, m_Displacements.size())];
+		return Reduce(Mix(hash ^ (displacement * 0x9E37'79B9'7F4A'7C15ULL)), m_Size);
+	}
+
+	auto getSize() const { return m_Size; }
+	auto getMemoryUsage() const { return m_Displacements.size() * sizeof(std::uint32_t); }
+
+private:
+	// Maps the high 32 bits of value onto [0, range) without a division.
+	static std::size_t Reduce(std::uint64_t value, std::size_t range) { return static_cast<std::size_t>(((value >> 32) * range) >> 32); }
+
+private:
+	std::vector<std::uint32_t> m_Displacements = { 0 };
+	std::size_t                m_Size          = 0;
+};
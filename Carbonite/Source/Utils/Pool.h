@@ -0,0 +1,107 @@
+#pragma once
+
+#include "SlabAllocator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <new>
+#include <utility>
+#include <vector>
+
+// Fixed size object pool, objects are allocated from pages that are never moved so pointers stay valid until freed.
+// Pages of at least Slab::MinBlockSize come from the slab arenas.
+template <class T, std::size_t PageSize = 64>
+class Pool
+{
+public:
+	Pool() = default;
+	Pool(const Pool&) = delete;
+	// Pages are taken over as they are, so pointers into the other pool stay valid and now belong to this one.
+	Pool(Pool&& other) noexcept
+	    : m_Pages(std::move(other.m_Pages)), m_FreeList(std::exchange(other.m_FreeList, nullptr)), m_Size(std::exchange(other.m_Size, 0))
+	{
+		other.m_Pages.clear();
+	}
+	~Pool() { clear(); }
+
+	Pool& operator=(const Pool&) = delete;
+	// Destroys the objects of this pool first.
+	Pool& operator=(Pool&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		m_Pages    = std::move(other.m_Pages);
+		m_FreeList = std::exchange(other.m_FreeList, nullptr);
+		m_Size     = std::exchange(other.m_Size, 0);
+		other.m_Pages.clear();
+		return *this;
+	}
+
+	template <class... Args>
+	T* allocate(Args&&... args)
+	{
+		if (!m_FreeList)
+			addPage();
+
+		Slot* slot = m_FreeList;
+		m_FreeList = slot->m_Next;
+		T* value   = new (slot->m_Storage) T(std::forward<Args>(args)...);
+		slot->m_Alive = true;
+		++m_Size;
+		return value;
+	}
+
+	void free(T* value)
+	{
+		if (!value)
+			return;
+
+		value->~T();
+		Slot* slot    = reinterpret_cast<Slot*>(value);
+		slot->m_Alive = false;
+		slot->m_Next  = m_FreeList;
+		m_FreeList    = slot;
+		--m_Size;
+	}
+
+	void clear()
+	{
+		for (auto& page : m_Pages)
+			for (std::size_t i = 0; i < PageSize; ++i)
+				if (page[i].m_Alive)
+					reinterpret_cast<T*>(page[i].m_Storage)->~T();
+		m_Pages.clear();
+		m_FreeList = nullptr;
+		m_Size     = 0;
+	}
+
+	auto getSize() const { return m_Size; }
+	auto getCapacity() const { return m_Pages.size() * PageSize; }
+
+private:
+	struct Slot
+	{
+	public:
+		alignas(T) std::uint8_t m_Storage[sizeof(T)];
+		Slot* m_Next  = nullptr;
+		bool  m_Alive = false;
+	};
+
+	void addPage()
+	{
+		auto& page = m_Pages.emplace_back(PageSize);
+		for (std::size_t i = PageSize; i > 0; --i)
+		{
+			page[i - 1].m_Next = m_FreeList;
+			m_FreeList         = &page[i - 1];
+		}
+	}
+
+private:
+	std::vector<std::vector<Slot, SlabAllocator<Slot>>> m_Pages;
+	Slot*                                               m_FreeList = nullptr;
+	std::size_t                                         m_Size     = 0;
+};
@@ -0,0 +1,376 @@
+#include "SlabAllocator.h"
+#include "Core.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdio>
+#include <mutex>
+
+#if BUILD_IS_SYSTEM_WINDOWS
+#undef APIENTRY
+#include <Windows.h>
+#include <Psapi.h>
+#elif BUILD_IS_SYSTEM_UNIX
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#if BUILD_IS_SYSTEM_MACOSX
+#include <mach/mach.h>
+#endif
+#endif
+
+namespace
+{
+	constexpr std::uint32_t MinClassBits = std::countr_zero(Slab::MinBlockSize);
+	constexpr std::uint32_t ClassCount   = std::countr_zero(Slab::MaxBlockSize) - MinClassBits + 1;
+	// Address space reserved for arenas, halved until the system accepts it.
+	constexpr std::size_t   MaxReservation = 64ULL << 30;
+	constexpr std::size_t   MinReservation = 1ULL << 30;
+	// Free blocks a thread keeps per class before handing half of them to the shared list.
+	constexpr std::size_t   ThreadCacheBytes = 1024 * 1024;
+
+	struct FreeBlock
+	{
+	public:
+		FreeBlock* m_Next;
+	};
+
+	struct SizeClass
+	{
+	public:
+		std::mutex    m_Mutex;
+		FreeBlock*    m_Blocks = nullptr;
+		std::uint8_t* m_Bump   = nullptr; // Untouched rest of the class's current arena
+		std::uint8_t* m_End    = nullptr;
+	};
+
+	struct State
+	{
+	public:
+		State();
+
+		bool owns(const void* block) const
+		{
+			auto address = reinterpret_cast<std::uintptr_t>(block);
+			return address >= reinterpret_cast<std::uintptr_t>(m_Base) && address < reinterpret_cast<std::uintptr_t>(m_Base) + m_Reserved;
+		}
+
+		std::uint8_t* m_Base     = nullptr;
+		std::size_t   m_Reserved = 0;
+		std::mutex    m_ArenaMutex;
+		std::size_t   m_Committed = 0;
+
+		std::array<SizeClass, ClassCount> m_Classes;
+
+		std::atomic<bool>          m_Enabled { true };
+		std::atomic<std::size_t>   m_UsedBytes { 0 };
+		std::atomic<std::size_t>   m_PeakUsedBytes { 0 };
+		std::atomic<std::uint64_t> m_Allocations { 0 };
+		std::atomic<std::uint64_t> m_ThreadCacheHit { 0 };
+	};
+
+	struct ThreadCache
+	{
+	public:
+		~ThreadCache();
+
+		std::array<FreeBlock*, ClassCount>  m_Blocks {};
+		std::array<std::size_t, ClassCount> m_Counts {};
+		// Set once flushed at thread exit, thread locals destroyed after the cache then bypass it.
+		bool                                m_Exited = false;
+	};
+
+	State& GetState()
+	{
+		// Never destroyed, thread caches of threads outliving static destruction still flush into it.
+		static State* s_State = new State();
+		return *s_State;
+	}
+
+	ThreadCache& GetThreadCache()
+	{
+		thread_local ThreadCache s_Cache;
+		return s_Cache;
+	}
+
+	std::uint32_t ClassOf(std::size_t size)
+	{
+		return static_cast<std::uint32_t>(std::bit_width(size - 1)) - MinClassBits;
+	}
+
+	std::size_t ClassSize(std::uint32_t sizeClass)
+	{
+		return 1ULL << (sizeClass + MinClassBits);
+	}
+
+	std::size_t ThreadCacheLimit(std::uint32_t sizeClass)
+	{
+		std::size_t limit = ThreadCacheBytes / ClassSize(sizeClass);
+		return limit < 2 ? 2 : limit;
+	}
+
+	void* Reserve(std::size_t size)
+	{
+#if BUILD_IS_SYSTEM_WINDOWS
+		return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#elif BUILD_IS_SYSTEM_UNIX
+		void* base = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		return base == MAP_FAILED ? nullptr : base;
+#else
+		(void) size;
+		return nullptr;
+#endif
+	}
+
+	bool Commit(std::uint8_t* arena)
+	{
+#if BUILD_IS_SYSTEM_WINDOWS
+		// Large pages need SeLockMemoryPrivilege and can't be committed into a reservation, plain pages it is.
+		return VirtualAlloc(arena, Slab::ArenaSize, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#elif BUILD_IS_SYSTEM_UNIX
+		if (mprotect(arena, Slab::ArenaSize, PROT_READ | PROT_WRITE) != 0)
+			return false;
+#ifdef MADV_HUGEPAGE
+		madvise(arena, Slab::ArenaSize, MADV_HUGEPAGE);
+#endif
+		return true;
+#else
+		(void) arena;
+		return false;
+#endif
+	}
+
+	State::State()
+	{
+		for (std::size_t size = MaxReservation; size >= MinReservation && !m_Base; size /= 2)
+		{
+			// One arena extra so the base can be aligned to an arena, the head is left unused.
+			auto* base = static_cast<std::uint8_t*>(Reserve(size + Slab::ArenaSize));
+			if (!base)
+				continue;
+			std::uintptr_t address = reinterpret_cast<std::uintptr_t>(base);
+			m_Base                 = base + ((Slab::ArenaSize - (address & (Slab::ArenaSize - 1))) & (Slab::ArenaSize - 1));
+			m_Reserved             = size;
+		}
+	}
+
+	ThreadCache::~ThreadCache()
+	{
+		State& state = GetState();
+		for (std::uint32_t i = 0; i < ClassCount; ++i)
+		{
+			if (!m_Blocks[i])
+				continue;
+
+			FreeBlock* last = m_Blocks[i];
+			while (last->m_Next)
+				last = last->m_Next;
+
+			SizeClass&      sizeClass = state.m_Classes[i];
+			std::lock_guard lock(sizeClass.m_Mutex);
+			last->m_Next       = sizeClass.m_Blocks;
+			sizeClass.m_Blocks = m_Blocks[i];
+			m_Blocks[i] = nullptr;
+			m_Counts[i] = 0;
+		}
+		m_Exited = true;
+	}
+
+	void* AllocateShared(State& state, ThreadCache& cache, std::uint32_t index)
+	{
+		SizeClass&      sizeClass = state.m_Classes[index];
+		std::size_t     size      = ClassSize(index);
+		std::lock_guard lock(sizeClass.m_Mutex);
+		if (sizeClass.m_Blocks)
+		{
+			// Take one block and up to half a thread cache more, so the next few allocations don't lock.
+			FreeBlock*  block = sizeClass.m_Blocks;
+			FreeBlock*  last  = block;
+			std::size_t taken = 1;
+			std::size_t batch = ThreadCacheLimit(index) / 2;
+			while (taken < batch && last->m_Next)
+			{
+				last = last->m_Next;
+				++taken;
+			}
+			sizeClass.m_Blocks = last->m_Next;
+			last->m_Next         = nullptr;
+			cache.m_Blocks[index] = block->m_Next;
+			cache.m_Counts[index] = taken - 1;
+			return block;
+		}
+
+		if (sizeClass.m_Bump == sizeClass.m_End)
+		{
+			std::lock_guard arenaLock(state.m_ArenaMutex);
+			if (state.m_Committed + Slab::ArenaSize > state.m_Reserved)
+				return nullptr;
+			std::uint8_t* arena = state.m_Base + state.m_Committed;
+			if (!Commit(arena))
+				return nullptr;
+			state.m_Committed += Slab::ArenaSize;
+			sizeClass.m_Bump = arena;
+			sizeClass.m_End  = arena + Slab::ArenaSize;
+		}
+		// Carved on demand instead of threading the whole arena into the free list, untouched blocks stay unfaulted.
+		void* block = sizeClass.m_Bump;
+		sizeClass.m_Bump += size;
+		return block;
+	}
+
+	void FreeShared(State& state, ThreadCache& cache, std::uint32_t index)
+	{
+		// Keeps the newest half, their memory is the most likely to still be cached. An exited thread keeps nothing.
+		std::size_t keep  = cache.m_Exited ? 0 : cache.m_Counts[index] / 2;
+		FreeBlock*  first = cache.m_Blocks[index];
+		FreeBlock*  last  = nullptr;
+		for (std::size_t i = 0; i < keep; ++i)
+		{
+			last  = first;
+			first = first->m_Next;
+		}
+		FreeBlock*  tail  = first;
+		std::size_t moved = 1;
+		while (tail->m_Next)
+		{
+			tail = tail->m_Next;
+			++moved;
+		}
+		if (last)
+			last->m_Next = nullptr;
+		else
+			cache.m_Blocks[index] = nullptr;
+		cache.m_Counts[index] = keep;
+
+		SizeClass&      sizeClass = state.m_Classes[index];
+		std::lock_guard lock(sizeClass.m_Mutex);
+		tail->m_Next       = sizeClass.m_Blocks;
+		sizeClass.m_Blocks = first;
+	}
+} // namespace
+
+namespace Slab
+{
+	void* allocate(std::size_t size)
+	{
+		State& state = GetState();
+		if (size < MinBlockSize || size > MaxBlockSize || !state.m_Enabled.load(std::memory_order_relaxed))
+			return ::operator new(size);
+
+		std::uint32_t index = ClassOf(size);
+		ThreadCache&  cache = GetThreadCache();
+		if (cache.m_Exited)
+			return ::operator new(size);
+		void*         block = cache.m_Blocks[index];
+		if (block)
+		{
+			cache.m_Blocks[index] = cache.m_Blocks[index]->m_Next;
+			--cache.m_Counts[index];
+			state.m_ThreadCacheHit.fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			block = AllocateShared(state, cache, index);
+			if (!block)
+				return ::operator new(size);
+		}
+
+		std::size_t used = state.m_UsedBytes.fetch_add(ClassSize(index), std::memory_order_relaxed) + ClassSize(index);
+		std::size_t peak = state.m_PeakUsedBytes.load(std::memory_order_relaxed);
+		while (used > peak && !state.m_PeakUsedBytes.compare_exchange_weak(peak, used, std::memory_order_relaxed))
+			;
+		state.m_Allocations.fetch_add(1, std::memory_order_relaxed);
+		return block;
+	}
+
+	void free(void* block, std::size_t size)
+	{
+		if (!block)
+			return;
+
+		State& state = GetState();
+		if (!state.owns(block))
+		{
+			::operator delete(block);
+			return;
+		}
+
+		std::uint32_t index = ClassOf(size);
+		ThreadCache&  cache = GetThreadCache();
+		auto*         entry = static_cast<FreeBlock*>(block);
+		entry->m_Next         = cache.m_Blocks[index];
+		cache.m_Blocks[index] = entry;
+		if (++cache.m_Counts[index] > ThreadCacheLimit(index) || cache.m_Exited)
+			FreeShared(state, cache, index);
+		state.m_UsedBytes.fetch_sub(ClassSize(index), std::memory_order_relaxed);
+	}
+
+	void setEnabled(bool enabled)
+	{
+		GetState().m_Enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool isEnabled()
+	{
+		return GetState().m_Enabled.load(std::memory_order_relaxed);
+	}
+
+	SlabStats getStats()
+	{
+		State&    state = GetState();
+		SlabStats stats;
+		{
+			std::lock_guard lock(state.m_ArenaMutex);
+			stats.m_ArenaBytes = state.m_Committed;
+		}
+		stats.m_UsedBytes      = state.m_UsedBytes.load(std::memory_order_relaxed);
+		stats.m_PeakUsedBytes  = state.m_PeakUsedBytes.load(std::memory_order_relaxed);
+		stats.m_Allocations    = state.m_Allocations.load(std::memory_order_relaxed);
+		stats.m_ThreadCacheHit = state.m_ThreadCacheHit.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	std::size_t getResidentBytes()
+	{
+#if BUILD_IS_SYSTEM_WINDOWS
+		PROCESS_MEMORY_COUNTERS counters;
+		return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+#elif BUILD_IS_SYSTEM_MACOSX
+		mach_task_basic_info_data_t info;
+		mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+		if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+			return 0;
+		return info.resident_size;
+#elif BUILD_IS_SYSTEM_LINUX
+		std::FILE* file = std::fopen("/proc/self/statm", "r");
+		if (!file)
+			return 0;
+		unsigned long long pages = 0, resident = 0;
+		int                read  = std::fscanf(file, "%llu %llu", &pages, &resident);
+		std::fclose(file);
+		return read == 2 ? static_cast<std::size_t>(resident) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+		return 0;
+#endif
+	}
+
+	std::size_t getPeakResidentBytes()
+	{
+#if BUILD_IS_SYSTEM_WINDOWS
+		PROCESS_MEMORY_COUNTERS counters;
+		return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#elif BUILD_IS_SYSTEM_UNIX
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0;
+#if BUILD_IS_SYSTEM_MACOSX
+		return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+		return static_cast<std::size_t>(usage.ru_maxrss) * 1024; // Kilobytes on Linux
+#endif
+#else
+		return 0;
+#endif
+	}
+} // namespace Slab
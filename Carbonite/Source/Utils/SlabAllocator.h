@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <new>
+
+struct SlabStats
+{
+public:
+	std::size_t   m_ArenaBytes     = 0; // Committed for arenas, never given back to the system
+	std::size_t   m_UsedBytes      = 0; // Handed out blocks, rounded up to their size class
+	std::size_t   m_PeakUsedBytes  = 0;
+	std::uint64_t m_Allocations    = 0; // Served by the slabs, requests outside the size classes are not counted
+	std::uint64_t m_ThreadCacheHit = 0; // Allocations served from the thread's own free list without locking
+};
+
+// Allocator for the large fixed size buffers chunks churn through (packed voxels, light levels, pool pages).
+// Sizes from MinBlockSize to MaxBlockSize are rounded up to a power of two size class, every class carves its blocks from
+// ArenaSize arenas committed inside one address range reserved up front. On Linux the arenas are 2 MiB aligned and marked for
+// transparent huge pages, so a fresh arena faults in as a single page instead of 512.
+// Freed blocks go on a free list of the freeing thread and are handed to other threads in batches through a locked list per
+// class once that list is full. Arenas are never returned, memory stays at the high water mark of the used bytes.
+// Other sizes and everything once the reservation is used up go through operator new.
+namespace Slab
+{
+	constexpr std::size_t MinBlockSize = 4096;
+	constexpr std::size_t MaxBlockSize = 256 * 1024;
+	constexpr std::size_t ArenaSize    = 2 * 1024 * 1024;
+
+	void* allocate(std::size_t size);
+	// size must be the size passed to allocate().
+	void  free(void* block, std::size_t size);
+
+	// Disabled, new blocks come from operator new, blocks already handed out can still be freed.
+	void setEnabled(bool enabled);
+	bool isEnabled();
+
+	SlabStats getStats();
+	// Resident set size of the whole process and its peak, 0 where unsupported.
+	std::size_t getResidentBytes();
+	std::size_t getPeakResidentBytes();
+} // namespace Slab
+
+// Standard allocator over Slab, for containers holding chunk sized buffers.
+template <class T>
+struct SlabAllocator
+{
+public:
+	using value_type = T;
+
+public:
+	SlabAllocator() = default;
+	template <class U>
+	SlabAllocator(const SlabAllocator<U>&)
+	{
+	}
+
+	T*   allocate(std::size_t count) { return static_cast<T*>(Slab::allocate(count * sizeof(T))); }
+	void deallocate(T* values, std::size_t count) { Slab::free(values, count * sizeof(T)); }
+
+	template <class U>
+	bool operator==(const SlabAllocator<U>&) const
+	{
+		return true;
+	}
+};
@@ -0,0 +1,118 @@
+#include "WorkerPool.h"
+
+#include <utility>
+
+WorkerPool::WorkerPool(std::size_t workerCount)
+    : m_WorkerCount(workerCount)
+{
+	if (m_WorkerCount == ~0ULL)
+	{
+		std::size_t hardwareThreads = std::thread::hardware_concurrency();
+		m_WorkerCount               = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	stop();
+}
+
+void WorkerPool::start()
+{
+	std::lock_guard lock(m_Mutex);
+	if (m_Running)
+		return;
+
+	m_Running = true;
+	m_Workers.reserve(m_WorkerCount);
+	for (std::size_t i = 0; i < m_WorkerCount; ++i)
+		m_Workers.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+void WorkerPool::stop()
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		if (!m_Running)
+			return;
+		m_Running = false;
+	}
+	m_Condition.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+	m_Workers.clear();
+}
+
+void WorkerPool::submit(Job job)
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		++m_Active;
+		m_Ready.push_back(std::move(job));
+	}
+	m_Condition.notify_one();
+	m_Settled.notify_one();
+}
+
+void WorkerPool::wait()
+{
+	if (m_WorkerCount > 0)
+		start();
+
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock lock(m_Mutex);
+			m_Settled.wait(lock, [this]() { return !m_Ready.empty() || m_Active == 0; });
+			if (m_Ready.empty())
+				break;
+
+			job = std::move(m_Ready.back());
+			m_Ready.pop_back();
+		}
+		job();
+
+		std::lock_guard lock(m_Mutex);
+		--m_Active;
+	}
+}
+
+void WorkerPool::parallelFor(std::size_t count, const std::function<void(std::size_t index)>& func)
+{
+	if (count == 0)
+		return;
+
+	// Queued in reverse, jobs are taken from the back.
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Active += count;
+		for (std::size_t i = count; i-- > 0;)
+			m_Ready.push_back([&func, i]() { func(i); });
+	}
+	m_Condition.notify_all();
+	wait();
+}
+
+void WorkerPool::workerLoop()
+{
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return !m_Running || !m_Ready.empty(); });
+			if (!m_Running)
+				return;
+
+			job = std::move(m_Ready.back());
+			m_Ready.pop_back();
+		}
+		job();
+
+		std::lock_guard lock(m_Mutex);
+		if (--m_Active == 0)
+			m_Settled.notify_all();
+	}
+}
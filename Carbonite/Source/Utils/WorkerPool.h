@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads shared by the world subsystems of a dimension, which run their work as batches of jobs.
+// Jobs are queued with submit(), also from inside a running job, and wait() blocks until every job of the batch finished,
+// the calling thread helps the workers. Without workers wait() runs every job itself.
+// Only one thread runs batches at a time, the subsystems of a dimension are all updated by the thread that owns it.
+// The workers start with the first batch.
+class WorkerPool
+{
+public:
+	using Job = std::function<void()>;
+
+public:
+	// ~0ULL leaves one hardware thread for the thread calling wait(), which works as well.
+	WorkerPool(std::size_t workerCount = ~0ULL);
+	~WorkerPool();
+
+	void start();
+	void stop();
+
+	void submit(Job job);
+	void wait();
+	// Runs func(i) for every i below count, in ascending order when there are no workers, and waits for them.
+	void parallelFor(std::size_t count, const std::function<void(std::size_t index)>& func);
+
+	auto getWorkerCount() const { return m_WorkerCount; }
+
+private:
+	void workerLoop();
+
+private:
+	std::size_t              m_WorkerCount;
+	std::vector<std::thread> m_Workers;
+	bool                     m_Running = false;
+
+	std::mutex              m_Mutex;
+	std::condition_variable m_Condition; // Wakes workers
+	std::condition_variable m_Settled;   // Wakes the thread waiting in wait()
+	std::vector<Job>        m_Ready;
+	std::size_t             m_Active = 0; // Submitted jobs, queued or running
+};
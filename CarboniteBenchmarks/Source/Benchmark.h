@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Carbonite/World/ChunkCoord.h"
+#include "Carbonite/World/Dimension.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <vector>
+
+// Minimal self registering benchmarks: BENCHMARK(Name) { ... Benchmarks::report(...); } in any source of the project.
+// Benchmarks print their own figures, measure() only takes care of repeating and timing the work.
+namespace Benchmarks
+{
+	using BenchmarkFunc = void (*)();
+
+	struct Benchmark
+	{
+	public:
+		const char*   m_Name;
+		BenchmarkFunc m_Func;
+	};
+
+	std::vector<Benchmark>& getBenchmarks();
+	bool                    registerBenchmark(const char* name, BenchmarkFunc func);
+
+	// Prints "label: value unit" under the running benchmark.
+	void report(const char* label, double value, const char* unit);
+
+	// Keeps the compiler from dropping work whose result is otherwise unused.
+	void doNotOptimize(const void* value);
+
+	// Calls func() until minSeconds passed, at least once, returns the average seconds per call.
+	template <class F>
+	double measure(F&& func, double minSeconds = 0.25)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		std::size_t calls = 0;
+		auto        start = Clock::now();
+		double      elapsed;
+		do
+		{
+			func();
+			++calls;
+			elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		} while (elapsed < minSeconds);
+		return elapsed / static_cast<double>(calls);
+	}
+
+	// A dimension that generates terrain for the chunks it loads, what most world benchmarks start from.
+	class TerrainWorld
+	{
+	public:
+		TerrainWorld(const TerrainSettings& settings = {}, const BlockStateTable& blockStates = BlockStateTable::Default())
+		    : m_Generator(settings)
+		{
+			m_Dimension.setBlockStates(&blockStates);
+			m_Dimension.setGenerator([this](Chunk& chunk) { m_Generator.generate(chunk); });
+		}
+
+		// Loads every chunk from min up to but excluding max.
+		void loadBox(const ChunkCoord& min, const ChunkCoord& max)
+		{
+			for (std::int64_t z = min.m_Z; z < max.m_Z; ++z)
+				for (std::int64_t y = min.m_Y; y < max.m_Y; ++y)
+					for (std::int64_t x = min.m_X; x < max.m_X; ++x)
+						m_Dimension.loadChunk({ x, y, z });
+		}
+
+		auto& getGenerator() { return m_Generator; }
+		auto& getDimension() { return m_Dimension; }
+
+	private:
+		TerrainGenerator m_Generator;
+		Dimension        m_Dimension; // Destroyed before the generator its chunks come from
+	};
+} // namespace Benchmarks
+
+#define BENCHMARK(name)                                                                          \
+	static void name();                                                                          \
+	[[maybe_unused]] static bool name##Registered = Benchmarks::registerBenchmark(#name, &name); \
+	static void name()
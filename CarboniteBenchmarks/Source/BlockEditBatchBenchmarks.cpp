@@ -0,0 +1,66 @@
+#include "Benchmark.h"
+#include "Carbonite/World/BlockEditBatch.h"
+#include "Carbonite/World/Dimension.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+
+// A 100^3 box and a sphere of radius 62 (both about a million voxels) dug out of and filled back into generated terrain,
+// through one batch and voxel by voxel through setVoxel(). Every call flips the voxels between air and stone, so every write
+// changes them. Lighting the edits is timed on its own.
+BENCHMARK(BlockEditBatchMillionVoxels)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::int64_t Min  = -50;
+	constexpr std::int64_t Max  = 49;
+	constexpr double       Size = 100.0 * 100.0 * 100.0;
+
+	Benchmarks::TerrainWorld world;
+	world.loadBox({ -3, -3, -3 }, { 3, 3, 3 });
+	auto& dimension = world.getDimension();
+	dimension.updateLighting();
+
+	bool           dig = true;
+	BlockEditBatch batch;
+
+	double seconds = Benchmarks::measure([&]() {
+		batch.clear();
+		batch.fillBox(Min, Min, Min, Max, Max, Max, dig ? Chunk::EmptyState : 0);
+		dimension.applyEdits(batch);
+		dig = !dig;
+	});
+	Benchmarks::report("box batch", seconds * 1e3, "ms");
+	Benchmarks::report("box batch", Size / seconds / 1e6, "M voxels/s");
+
+	seconds = Benchmarks::measure([&]() {
+		batch.clear();
+		batch.fillSphere(0.0, 0.0, 0.0, 62.0, dig ? Chunk::EmptyState : 0);
+		dimension.applyEdits(batch);
+		dig = !dig;
+	});
+	Benchmarks::report("sphere batch", seconds * 1e3, "ms");
+
+	// Light queued by the repeated edits above settles first, then a single dug out box is lit.
+	dimension.updateLighting();
+	batch.clear();
+	batch.fillBox(Min, Min, Min, Max, Max, Max, Chunk::EmptyState);
+	dimension.applyEdits(batch);
+	auto        start   = Clock::now();
+	std::size_t updates = dimension.updateLighting();
+	Benchmarks::report("lighting a dug out box", std::chrono::duration<double, std::milli>(Clock::now() - start).count(), "ms");
+	Benchmarks::report("lighting a dug out box", static_cast<double>(updates), "updates");
+
+	dig     = false;
+	seconds = Benchmarks::measure([&]() {
+		for (std::int64_t z = Min; z <= Max; ++z)
+			for (std::int64_t y = Min; y <= Max; ++y)
+				for (std::int64_t x = Min; x <= Max; ++x)
+					dimension.setVoxel(x, y, z, dig ? Chunk::EmptyState : 0);
+		dig = !dig;
+	});
+	Benchmarks::report("box through setVoxel()", seconds * 1e3, "ms");
+	Benchmarks::report("box through setVoxel()", Size / seconds / 1e6, "M voxels/s");
+}
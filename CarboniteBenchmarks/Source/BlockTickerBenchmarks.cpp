@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Carbonite/World/Dimension.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <utility>
+
+namespace
+{
+	constexpr std::uint64_t Grass  = 2;
+	constexpr std::uint64_t Growth = 3;
+
+	// Grass random ticks, a growth placed on it is removed again by a scheduled tick. The other terrain states stay unregistered.
+	const BlockStateTable& GetBlockStates()
+	{
+		static BlockStateTable table = []() {
+			Registry<BlockState> registry;
+			BlockState           grass;
+			grass.m_RandomTicks = true;
+			registry.addEntry("grass", Grass, std::move(grass));
+			BlockState growth;
+			growth.m_Opaque = false;
+			registry.addEntry("growth", Growth, std::move(growth));
+			registry.freeze();
+
+			BlockStateTable blockStates;
+			blockStates.build(registry);
+			return blockStates;
+		}();
+		return table;
+	}
+} // namespace
+
+// Ticks per second with 1000 chunks of generated terrain loaded, while grass grows and withers, and in a world with nothing to tick.
+BENCHMARK(BlockTickerLoadedChunks)
+{
+	using Clock = std::chrono::steady_clock;
+
+	Benchmarks::TerrainWorld world({}, GetBlockStates());
+	auto&                    dimension = world.getDimension();
+	world.loadBox({ 0, 0, -5 }, { 10, 10, 5 });
+	dimension.updateLighting();
+
+	auto& ticker = dimension.getTicker();
+	ticker.setRandomTickHandler([](BlockTickContext& context, const BlockTick& tick) {
+		if (context.getVoxel(tick.m_X, tick.m_Y, tick.m_Z + 1) == Chunk::EmptyState && (context.random() & 15) == 0)
+		{
+			context.setVoxel(tick.m_X, tick.m_Y, tick.m_Z + 1, Growth);
+			context.scheduleTick(tick.m_X, tick.m_Y, tick.m_Z + 1, 20);
+		}
+	});
+	ticker.setScheduledTickHandler([](BlockTickContext& context, const BlockTick& tick) {
+		if (tick.m_State == Growth)
+			context.setVoxel(tick.m_X, tick.m_Y, tick.m_Z, Chunk::EmptyState);
+	});
+	dimension.tick();
+
+	constexpr std::size_t Ticks = 400;
+
+	double      seconds = 0.0;
+	std::size_t edits   = 0;
+	for (std::size_t i = 0; i < Ticks; ++i)
+	{
+		auto start = Clock::now();
+		dimension.tick();
+		seconds += std::chrono::duration<double>(Clock::now() - start).count();
+		edits   += ticker.getStats().m_Edits;
+		// Lighting of the edits settles outside the timed part.
+		dimension.updateLighting();
+	}
+	Benchmarks::report("loaded chunks", static_cast<double>(dimension.getLoadedChunkCount()), "chunks");
+	Benchmarks::report("growing grass", Ticks / seconds, "ticks/s");
+	Benchmarks::report("growing grass", seconds / Ticks * 1e3, "ms/tick");
+	Benchmarks::report("growing grass edits", static_cast<double>(edits) / Ticks, "edits/tick");
+	Benchmarks::report("pending scheduled ticks", static_cast<double>(ticker.getPendingTickCount()), "ticks");
+
+	// Without ticking states every chunk is skipped by its palette.
+	BlockStateTable none;
+	dimension.setBlockStates(&none);
+	dimension.tick();
+	seconds = Benchmarks::measure([&dimension]() { dimension.tick(); });
+	Benchmarks::report("idle world", 1.0 / seconds, "ticks/s");
+	Benchmarks::report("idle world", seconds * 1e3, "ms/tick");
+	dimension.setBlockStates(&GetBlockStates());
+}
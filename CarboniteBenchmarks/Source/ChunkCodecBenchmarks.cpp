@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include "Carbonite/World/ChunkCache.h"
+#include "Carbonite/World/ChunkCodec.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+// Codec throughput and ratio on generated terrain, against the flat voxel array and the palette serialization.
+BENCHMARK(ChunkCodecTerrain)
+{
+	TerrainGenerator   generator;
+	std::vector<Chunk> chunks;
+	for (std::int64_t x = 0; x < 8; ++x)
+	{
+		for (std::int64_t y = 0; y < 8; ++y)
+		{
+			for (std::int64_t z = -2; z < 2; ++z)
+			{
+				chunks.emplace_back(x, y, z);
+				generator.generate(chunks.back());
+			}
+		}
+	}
+
+	std::vector<std::vector<std::uint8_t>> blobs(chunks.size());
+	std::size_t                            encodedSize = 0;
+	std::size_t                            paletteSize = 0;
+	std::vector<std::uint8_t>              palette;
+	for (std::size_t i = 0; i < chunks.size(); ++i)
+	{
+		ChunkCodec::encode(chunks[i].getVoxels(), blobs[i]);
+		encodedSize += blobs[i].size();
+		palette.clear();
+		chunks[i].getVoxels().serialize(palette);
+		paletteSize += palette.size();
+	}
+
+	double rawSize = static_cast<double>(chunks.size() * ChunkStorage::VoxelCount * sizeof(std::uint64_t));
+	Benchmarks::report("average encoded size", static_cast<double>(encodedSize) / chunks.size(), "B/chunk");
+	Benchmarks::report("ratio vs flat array", rawSize / encodedSize, "x");
+	Benchmarks::report("ratio vs palette", static_cast<double>(paletteSize) / encodedSize, "x");
+
+	std::vector<std::uint8_t> data;
+	double                    seconds = Benchmarks::measure([&]() {
+		for (auto& chunk : chunks)
+		{
+			data.clear();
+			ChunkCodec::encode(chunk.getVoxels(), data);
+		}
+	});
+	Benchmarks::report("encode", seconds / chunks.size() * 1e6, "us/chunk");
+	Benchmarks::report("encode", rawSize / seconds / 1e9, "GB/s of voxels");
+
+	ChunkStorage storage;
+	seconds = Benchmarks::measure([&]() {
+		for (auto& blob : blobs)
+			ChunkCodec::decode(blob.data(), blob.size(), storage);
+	});
+	Benchmarks::report("decode", seconds / chunks.size() * 1e6, "us/chunk");
+	Benchmarks::report("decode", rawSize / seconds / 1e9, "GB/s of voxels");
+
+	// A store and restore round trip through the cold chunk cache, the path of a chunk leaving and reentering view.
+	ChunkCache cache;
+	seconds = Benchmarks::measure([&]() {
+		for (auto& chunk : chunks)
+		{
+			cache.store(chunk);
+			Chunk restored(chunk.getCoord());
+			cache.restore(restored);
+		}
+	});
+	Benchmarks::report("cache store and restore", seconds / chunks.size() * 1e6, "us/chunk");
+}
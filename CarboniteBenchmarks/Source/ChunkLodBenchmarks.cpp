@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+#include "Carbonite/Renderer/Mesh/ChunkMesher.h"
+#include "Carbonite/World/Dimension.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <chrono>
+#include <unordered_set>
+#include <vector>
+
+// A fixed camera over generated terrain: the LOD scene against the same area loaded and meshed at full resolution.
+BENCHMARK(ChunkLodScene)
+{
+	using Clock = std::chrono::steady_clock;
+
+	TerrainGenerator generator;
+	ChunkMesher      mesher;
+
+	// Loaded chunks share identical voxel blocks, so each scene is measured while it is the only one alive.
+	std::vector<LodCoord>      nodes;
+	std::vector<Vertex>        vertices;
+	std::vector<std::uint32_t> indices;
+	double                     seconds   = 0.0;
+	std::size_t                lodQuads  = 0;
+	std::size_t                lodMemory = 0;
+	{
+		Dimension lodDimension;
+		auto&     lod = lodDimension.getLod();
+		lodDimension.setGenerator([&generator](Chunk& chunk) { generator.generate(chunk); });
+		lod.setGenerator([&generator](Chunk& node, std::uint32_t level) { generator.generateLod(node, level); });
+		lod.setDistances(4, 16, 2);
+		lod.setFrameBudget(1e9f);
+
+		lod.select({ 16.0f, 16.0f, 16.0f }, nodes);
+		for (auto& node : nodes)
+			if (node.m_Level == 0)
+				lodDimension.loadChunk(node.m_Coord);
+
+		auto start = Clock::now();
+		lod.update(lodDimension, nodes);
+		seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		std::unordered_set<LodCoord, LodCoordHash> selected(nodes.begin(), nodes.end());
+		lodMemory = lod.getStats().m_MemoryUsage;
+		for (auto& node : nodes)
+		{
+			const Chunk* chunk = lod.getNode(lodDimension, node);
+			if (!chunk)
+				continue;
+
+			// Neighbours only cull against nodes of the same level, like the renderer.
+			std::array<const Chunk*, FaceCount> neighbours {};
+			for (std::uint32_t i = 0; i < FaceCount; ++i)
+			{
+				LodCoord neighbour = node.neighbour(static_cast<EFace>(i));
+				if (selected.contains(neighbour))
+					neighbours[i] = lod.getNode(lodDimension, neighbour);
+			}
+			vertices.clear();
+			indices.clear();
+			mesher.mesh(*chunk, neighbours, vertices, indices);
+			lodQuads += mesher.getQuads().size();
+			if (node.m_Level == 0)
+				lodMemory += chunk->getVoxels().getMemoryUsage();
+		}
+		lodMemory += ChunkStorage::GetSharingStats().m_SharedMemoryUsage;
+	}
+
+	// Every chunk under the selected nodes, loaded and meshed as if there were no LOD.
+	Dimension fullDimension;
+	fullDimension.setGenerator([&generator](Chunk& chunk) { generator.generate(chunk); });
+	for (auto& node : nodes)
+	{
+		ChunkCoord   first = node.getFirstChunk();
+		std::int64_t size  = node.getSize();
+		for (std::int64_t z = 0; z < size; ++z)
+			for (std::int64_t y = 0; y < size; ++y)
+				for (std::int64_t x = 0; x < size; ++x)
+					fullDimension.loadChunk({ first.m_X + x, first.m_Y + y, first.m_Z + z });
+	}
+
+	std::size_t fullQuads  = 0;
+	std::size_t fullMemory = 0;
+	fullDimension.forEachChunk([&](const Chunk& chunk) {
+		auto                                loaded = fullDimension.getNeighbours(chunk.getCoord());
+		std::array<const Chunk*, FaceCount> neighbours {};
+		for (std::uint32_t i = 0; i < FaceCount; ++i)
+			neighbours[i] = loaded[i];
+		vertices.clear();
+		indices.clear();
+		mesher.mesh(chunk, neighbours, vertices, indices);
+		fullQuads  += mesher.getQuads().size();
+		fullMemory += chunk.getVoxels().getMemoryUsage();
+	});
+	fullMemory += ChunkStorage::GetSharingStats().m_SharedMemoryUsage;
+
+	Benchmarks::report("LOD nodes", static_cast<double>(nodes.size()), "nodes");
+	Benchmarks::report("LOD build", seconds * 1e3, "ms");
+	Benchmarks::report("LOD triangles", static_cast<double>(lodQuads * 2), "triangles");
+	Benchmarks::report("LOD voxel memory", static_cast<double>(lodMemory) / (1 << 20), "MiB");
+	Benchmarks::report("full resolution chunks", static_cast<double>(fullDimension.getLoadedChunkCount()), "chunks");
+	Benchmarks::report("full resolution triangles", static_cast<double>(fullQuads * 2), "triangles");
+	Benchmarks::report("full resolution voxel memory", static_cast<double>(fullMemory) / (1 << 20), "MiB");
+}
@@ -0,0 +1,55 @@
+#include "Benchmark.h"
+#include "Carbonite/Renderer/Mesh/ChunkMesher.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Meshing time per chunk for generated terrain, noise and the checkerboard worst case, in both mesher modes.
+BENCHMARK(ChunkMesherPerChunk)
+{
+	Chunk terrain(0, 0, -1);
+	TerrainGenerator().generate(terrain);
+
+	ChunkStorage    noisy;
+	std::mt19937_64 rng(1);
+	for (std::size_t i = 0; i < ChunkStorage::VoxelCount; ++i)
+		noisy.set(i, rng() % 2 ? Chunk::EmptyState : rng() % 4);
+
+	ChunkStorage checkerboard;
+	for (std::uint32_t z = 0; z < Chunk::Size; ++z)
+		for (std::uint32_t y = 0; y < Chunk::Size; ++y)
+			for (std::uint32_t x = 0; x < Chunk::Size; ++x)
+				checkerboard.set(Chunk::PositionToIndex(x, y, z), (x + y + z) % 2 ? 1 : Chunk::EmptyState);
+
+	const std::pair<const char*, const ChunkStorage*> cases[] {
+		{ "terrain", &terrain.getVoxels() },
+		{ "noisy", &noisy },
+		{ "checkerboard", &checkerboard }
+	};
+
+	std::vector<Vertex>        vertices;
+	std::vector<std::uint32_t> indices;
+	for (auto mode : { EChunkMesherMode::Reference, EChunkMesherMode::Binary })
+	{
+		ChunkMesher mesher;
+		mesher.setMode(mode);
+		std::string modeName = mode == EChunkMesherMode::Reference ? "reference " : "binary ";
+		for (auto& [name, voxels] : cases)
+		{
+			double seconds = Benchmarks::measure([&]() {
+				vertices.clear();
+				indices.clear();
+				mesher.mesh(*voxels, {}, vertices, indices);
+			});
+			Benchmarks::report((modeName + name).c_str(), seconds * 1e3, "ms/chunk");
+			if (mode == EChunkMesherMode::Binary)
+				Benchmarks::report((std::string(name) + " quads").c_str(), static_cast<double>(mesher.getQuads().size()), "quads");
+		}
+	}
+}
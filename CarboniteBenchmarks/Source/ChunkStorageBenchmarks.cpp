@@ -0,0 +1,152 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Chunk.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Voxels of the compared layouts: uniform, a few terrain layers, and many states in no order.
+	std::vector<std::uint64_t> MakeVoxels(std::uint32_t pattern)
+	{
+		std::vector<std::uint64_t> voxels(ChunkStorage::VoxelCount);
+		std::mt19937_64            rng(pattern);
+		for (std::size_t i = 0; i < voxels.size(); ++i)
+		{
+			std::size_t z = i / (Chunk::Size * Chunk::Size);
+			switch (pattern)
+			{
+			case 0: voxels[i] = 1; break;
+			case 1: voxels[i] = z < 12 ? 1 : z < 15 ? 2 : z == 15 ? 3 : Chunk::EmptyState; break;
+			default: voxels[i] = rng() % 200; break;
+			}
+		}
+		return voxels;
+	}
+
+	constexpr const char* PatternNames[] { "uniform", "layered", "noisy" };
+} // namespace
+
+// Palette storage against the flat 256 KiB array it replaced.
+BENCHMARK(ChunkStorageVsFlatArray)
+{
+	std::mt19937               rng(1);
+	std::vector<std::uint32_t> randomIndices(1 << 16);
+	for (auto& index : randomIndices)
+		index = static_cast<std::uint32_t>(rng() % ChunkStorage::VoxelCount);
+
+	for (std::uint32_t pattern = 0; pattern < 3; ++pattern)
+	{
+		std::string  name  = PatternNames[pattern];
+		auto         flat  = std::make_unique<std::uint64_t[]>(ChunkStorage::VoxelCount);
+		auto         input = MakeVoxels(pattern);
+		ChunkStorage storage;
+		for (std::size_t i = 0; i < input.size(); ++i)
+		{
+			flat[i] = input[i];
+			storage.set(i, input[i]);
+		}
+
+		Benchmarks::report((name + " flat memory").c_str(), ChunkStorage::VoxelCount * sizeof(std::uint64_t) / 1024.0, "KiB");
+		Benchmarks::report((name + " palette memory").c_str(), storage.getMemoryUsage() / 1024.0, "KiB");
+
+		double voxels  = static_cast<double>(ChunkStorage::VoxelCount);
+		double seconds = Benchmarks::measure([&]() {
+			std::uint64_t sum = 0;
+			for (std::size_t i = 0; i < ChunkStorage::VoxelCount; ++i)
+				sum += flat[i];
+			Benchmarks::doNotOptimize(&sum);
+		});
+		Benchmarks::report((name + " flat sequential get").c_str(), voxels / seconds / 1e6, "Mvoxels/s");
+		seconds = Benchmarks::measure([&]() {
+			std::uint64_t sum = 0;
+			for (std::size_t i = 0; i < ChunkStorage::VoxelCount; ++i)
+				sum += storage.get(i);
+			Benchmarks::doNotOptimize(&sum);
+		});
+		Benchmarks::report((name + " palette sequential get").c_str(), voxels / seconds / 1e6, "Mvoxels/s");
+		seconds = Benchmarks::measure([&]() {
+			std::uint64_t sum = 0;
+			storage.forEach([&sum](std::size_t, std::uint64_t state) { sum += state; });
+			Benchmarks::doNotOptimize(&sum);
+		});
+		Benchmarks::report((name + " palette forEach").c_str(), voxels / seconds / 1e6, "Mvoxels/s");
+
+		// Writes of states already in the palette, the common case after generation.
+		double writes = static_cast<double>(randomIndices.size());
+		seconds       = Benchmarks::measure([&]() {
+			for (std::uint32_t index : randomIndices)
+				flat[index] = input[index ^ 1];
+			Benchmarks::doNotOptimize(flat.get());
+		});
+		Benchmarks::report((name + " flat random set").c_str(), writes / seconds / 1e6, "Mvoxels/s");
+		seconds = Benchmarks::measure([&]() {
+			for (std::uint32_t index : randomIndices)
+				storage.set(index, input[index ^ 1]);
+		});
+		Benchmarks::report((name + " palette random set").c_str(), writes / seconds / 1e6, "Mvoxels/s");
+	}
+}
+
+// Voxel memory of 16x16x8 generated chunks with private voxels, then after passing every chunk through share() like
+// Dimension::loadChunk() does. Uniform chunks share their block either way. Hilly terrain with caves has next to no identical
+// chunks, flat terrain without caves repeats its surface chunk across the whole layer.
+BENCHMARK(ChunkStorageSharing)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::int64_t Radius = 8;
+	constexpr std::int64_t Depth  = 4;
+
+	auto memoryUsage = [](const std::vector<std::unique_ptr<Chunk>>& chunks) {
+		std::size_t bytes = ChunkStorage::GetSharingStats().m_SharedMemoryUsage;
+		for (auto& chunk : chunks)
+			bytes += chunk->getVoxels().getMemoryUsage();
+		return static_cast<double>(bytes) / (1 << 20);
+	};
+
+	TerrainSettings flat;
+	flat.m_BaseHeight      = 5.0f;
+	flat.m_HeightAmplitude = 0.0f;
+	flat.m_CaveThreshold   = 0.0f;
+	for (bool isFlat : { false, true })
+	{
+		std::string                         prefix = isFlat ? "flat, " : "hills, ";
+		TerrainGenerator                    generator(isFlat ? flat : TerrainSettings {});
+		std::vector<std::unique_ptr<Chunk>> chunks;
+		for (std::int64_t z = -Depth; z < Depth; ++z)
+		{
+			for (std::int64_t y = -Radius; y < Radius; ++y)
+			{
+				for (std::int64_t x = -Radius; x < Radius; ++x)
+				{
+					auto& chunk = chunks.emplace_back(std::make_unique<Chunk>(x, y, z));
+					generator.generate(*chunk);
+				}
+			}
+		}
+		std::size_t uniform = 0;
+		for (auto& chunk : chunks)
+			uniform += chunk->getVoxels().isShared();
+		Benchmarks::report((prefix + "uniform chunks").c_str(), static_cast<double>(uniform), "chunks");
+		Benchmarks::report((prefix + "voxels without share()").c_str(), memoryUsage(chunks), "MiB");
+
+		auto stats = ChunkStorage::GetSharingStats();
+		auto start = Clock::now();
+		for (auto& chunk : chunks)
+			chunk->getVoxels().share();
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		auto   after   = ChunkStorage::GetSharingStats();
+		Benchmarks::report((prefix + "voxels with share()").c_str(), memoryUsage(chunks), "MiB");
+		Benchmarks::report((prefix + "share()").c_str(), seconds / static_cast<double>(chunks.size()) * 1e6, "us/chunk");
+		Benchmarks::report((prefix + "identical chunks found").c_str(), static_cast<double>(after.m_Shares - stats.m_Shares), "chunks");
+		Benchmarks::report((prefix + "live shared blocks").c_str(), static_cast<double>(after.m_SharedBlocks), "blocks");
+	}
+}
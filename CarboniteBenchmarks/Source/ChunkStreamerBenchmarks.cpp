@@ -0,0 +1,56 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Dimension.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <vector>
+
+// A camera flying over generated terrain with the default 4 ms frame budget, then hovering on a chunk border.
+BENCHMARK(ChunkStreamerFlight)
+{
+	TerrainGenerator generator;
+	Dimension        dimension;
+	dimension.setGenerator([&generator](Chunk& chunk) { generator.generate(chunk); });
+
+	auto& streamer = dimension.getStreamer();
+	streamer.setRadius(8, 2);
+	streamer.setHysteresis(2);
+	streamer.setFrameBudget(4.0f);
+
+	constexpr std::size_t Frames = 600;
+	constexpr float       Speed  = 16.0f; // Voxels per frame, a chunk every other frame
+
+	double      milliseconds    = 0.0;
+	float       maxMilliseconds = 0.0f;
+	std::size_t maxQueueDepth   = 0;
+	for (std::size_t frame = 0; frame < Frames; ++frame)
+	{
+		dimension.updateStreaming({ { static_cast<float>(frame) * Speed, 0.0f, 0.0f } });
+		auto& stats      = streamer.getStats();
+		milliseconds    += stats.m_UpdateMilliseconds;
+		maxMilliseconds  = std::max(maxMilliseconds, stats.m_UpdateMilliseconds);
+		maxQueueDepth    = std::max(maxQueueDepth, stats.m_PendingLoads);
+	}
+
+	auto& stats = streamer.getStats();
+	Benchmarks::report("flight streamed", static_cast<double>(stats.m_TotalLoads) / (milliseconds / 1e3), "chunks/s");
+	Benchmarks::report("flight average update", milliseconds / Frames, "ms");
+	Benchmarks::report("flight slowest update", maxMilliseconds, "ms");
+	Benchmarks::report("flight deepest load queue", static_cast<double>(maxQueueDepth), "chunks");
+	Benchmarks::report("flight unloads", static_cast<double>(stats.m_TotalUnloads), "chunks");
+
+	// Let the queues drain, then step back and forth over a chunk border, the hysteresis must keep churn at zero.
+	glm::fvec3 border { Frames * Speed, 0.0f, 0.0f };
+	while (streamer.getStats().m_PendingLoads + streamer.getStats().m_PendingUnloads > 0)
+		dimension.updateStreaming({ border });
+
+	std::uint64_t loads   = stats.m_TotalLoads;
+	std::uint64_t unloads = stats.m_TotalUnloads;
+	for (std::size_t frame = 0; frame < Frames; ++frame)
+		dimension.updateStreaming({ { border.x + (frame % 2 ? 20.0f : -20.0f), 0.0f, 0.0f } });
+	Benchmarks::report("hover loads", static_cast<double>(stats.m_TotalLoads - loads), "chunks");
+	Benchmarks::report("hover unloads", static_cast<double>(stats.m_TotalUnloads - unloads), "chunks");
+}
@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Dimension.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace
+{
+	constexpr std::uint8_t Water = 0;
+	constexpr std::uint8_t Lava  = 1;
+} // namespace
+
+// Fluid ticks while 400 water and lava sources spill over generated terrain until everything settled, then the settled world.
+BENCHMARK(FluidSimulationSpill)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::int64_t Radius   = 6;
+	constexpr std::size_t  MaxTicks = 400;
+
+	Benchmarks::TerrainWorld world;
+	auto&                    dimension = world.getDimension();
+	dimension.getFluids().setProperties(Lava, { 2, 3 });
+	world.loadBox({ -Radius, -Radius, -2 }, { Radius, Radius, 3 });
+
+	// Sources a few voxels above the surface, away from the unloaded border.
+	std::mt19937_64 rng(9);
+	std::size_t     sources = 0;
+	while (sources < 400)
+	{
+		std::int64_t x      = static_cast<std::int64_t>(rng() % (Radius * 64 - 20)) - Radius * 32 + 10;
+		std::int64_t y      = static_cast<std::int64_t>(rng() % (Radius * 64 - 20)) - Radius * 32 + 10;
+		std::int64_t height = dimension.getHeight(EHeightmap::MotionBlocking, x, y);
+		if (height == ColumnHeightmaps::NoHeight || height > 60)
+			continue;
+		sources += dimension.setFluid(x, y, height + 3 + static_cast<std::int64_t>(rng() % 5), ChunkFluid::Make(rng() % 4 == 0 ? Lava : Water, 8, true));
+	}
+
+	double      seconds        = 0.0;
+	double      slowestSeconds = 0.0;
+	std::size_t peakActive     = 0;
+	std::size_t ticks          = 0;
+	while (ticks < MaxTicks)
+	{
+		auto        start   = Clock::now();
+		std::size_t changed = dimension.updateFluids();
+		double      elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+		seconds        += elapsed;
+		slowestSeconds  = std::max(slowestSeconds, elapsed);
+		peakActive      = std::max(peakActive, dimension.getFluids().getStats().m_ActiveCells);
+		++ticks;
+		if (changed == 0 && dimension.getFluids().getActiveCellCount() == 0)
+			break;
+	}
+	Benchmarks::report("spill ticks until settled", static_cast<double>(ticks), "ticks");
+	Benchmarks::report("spill average tick", seconds / static_cast<double>(ticks) * 1e3, "ms");
+	Benchmarks::report("spill slowest tick", slowestSeconds * 1e3, "ms");
+	Benchmarks::report("spill peak active cells", static_cast<double>(peakActive), "cells");
+
+	seconds = Benchmarks::measure([&dimension]() { dimension.updateFluids(); });
+	Benchmarks::report("settled tick", seconds * 1e6, "us");
+}
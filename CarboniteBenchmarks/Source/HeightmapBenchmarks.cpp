@@ -0,0 +1,80 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Dimension.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+// Heightmaps of 8x8x8 chunks of generated terrain: building them per chunk, surface lookups against scanning the column with
+// getVoxel(), and the cost they add to setVoxel() when digging and building at the surface.
+BENCHMARK(HeightmapColumns)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::int64_t Radius = 4;
+	constexpr std::int64_t Top    = Radius * Chunk::Size - 1;
+	constexpr std::int64_t Bottom = -Radius * Chunk::Size;
+
+	Benchmarks::TerrainWorld world;
+	world.loadBox({ -Radius, -Radius, -Radius }, { Radius, Radius, Radius });
+	auto& dimension = world.getDimension();
+
+	double      buildSeconds = 0.0;
+	std::size_t chunks       = 0;
+	dimension.forEachChunk([&](Chunk& chunk) {
+		auto start = Clock::now();
+		chunk.getHeightmap().build(chunk.getVoxels(), dimension.getBlockStates());
+		buildSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+		++chunks;
+	});
+	Benchmarks::report("build", buildSeconds / static_cast<double>(chunks) * 1e6, "us/chunk");
+
+	std::mt19937_64           rng(3);
+	std::vector<std::int64_t> columns(4096);
+	for (auto& column : columns)
+		column = static_cast<std::int64_t>(rng() % (2 * Radius * Chunk::Size)) + Bottom;
+
+	double seconds = Benchmarks::measure([&]() {
+		std::int64_t sum = 0;
+		for (std::size_t i = 0; i + 1 < columns.size(); i += 2)
+			sum += dimension.getHeight(EHeightmap::MotionBlocking, columns[i], columns[i + 1]);
+		Benchmarks::doNotOptimize(&sum);
+	});
+	Benchmarks::report("getHeight", seconds / static_cast<double>(columns.size() / 2) * 1e9, "ns");
+
+	seconds = Benchmarks::measure([&]() {
+		std::int64_t sum = 0;
+		for (std::size_t i = 0; i + 1 < columns.size(); i += 2)
+		{
+			std::int64_t z = Top;
+			while (z >= Bottom && dimension.getVoxel(columns[i], columns[i + 1], z) == Chunk::EmptyState)
+				--z;
+			sum += z;
+		}
+		Benchmarks::doNotOptimize(&sum);
+	});
+	Benchmarks::report("column scan with getVoxel", seconds / static_cast<double>(columns.size() / 2) * 1e9, "ns");
+
+	// Removing the top voxel scans down the column, placing one above only raises the height.
+	seconds = Benchmarks::measure([&]() {
+		for (std::size_t i = 0; i + 1 < columns.size(); i += 2)
+		{
+			std::int64_t height = dimension.getHeight(EHeightmap::MotionBlocking, columns[i], columns[i + 1]);
+			if (height != ColumnHeightmaps::NoHeight && height > Bottom)
+				dimension.setVoxel(columns[i], columns[i + 1], height - 1, Chunk::EmptyState);
+		}
+	});
+	Benchmarks::report("setVoxel digging the surface", seconds / static_cast<double>(columns.size() / 2) * 1e9, "ns");
+	seconds = Benchmarks::measure([&]() {
+		for (std::size_t i = 0; i + 1 < columns.size(); i += 2)
+		{
+			std::int64_t height = dimension.getHeight(EHeightmap::MotionBlocking, columns[i], columns[i + 1]);
+			if (height != ColumnHeightmaps::NoHeight && height <= Top)
+				dimension.setVoxel(columns[i], columns[i + 1], height, 0);
+		}
+	});
+	Benchmarks::report("setVoxel building on the surface", seconds / static_cast<double>(columns.size() / 2) * 1e9, "ns");
+}
@@ -0,0 +1,77 @@
+#include "Benchmark.h"
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Carbonite/World/Dimension.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <random>
+#include <utility>
+
+namespace
+{
+	constexpr std::uint64_t Torch = 3;
+
+	// The terrain's states are unregistered and opaque, only the torch needs its own.
+	const BlockStateTable& GetBlockStates()
+	{
+		static BlockStateTable table = []() {
+			Registry<BlockState> registry;
+			BlockState           torch;
+			torch.m_Opaque        = false;
+			torch.m_LightEmission = 14;
+			registry.addEntry("torch", Torch, std::move(torch));
+			registry.freeze();
+
+			BlockStateTable blockStates;
+			blockStates.build(registry);
+			return blockStates;
+		}();
+		return table;
+	}
+} // namespace
+
+// Light updates per second while digging, building and placing torches in a 4x4x4 chunk block of terrain.
+BENCHMARK(LightingEngineEdits)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::int64_t Size = 4;
+
+	TerrainSettings settings;
+	settings.m_BaseHeight = 8.0f;
+	Benchmarks::TerrainWorld world(settings, GetBlockStates());
+	auto&                    dimension = world.getDimension();
+
+	auto start = Clock::now();
+	world.loadBox({ 0, 0, -Size / 2 }, { Size, Size, Size / 2 });
+	std::size_t updates = dimension.updateLighting();
+	double      seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	Benchmarks::report("initial light", static_cast<double>(updates) / seconds / 1e6, "M updates/s");
+
+	// Half the edits dig, a third build and the rest place torches, settled in batches of 50 like a busy frame.
+	constexpr std::size_t Batches   = 200;
+	constexpr std::size_t BatchSize = 50;
+
+	std::mt19937 rng(1);
+	updates = 0;
+	seconds = 0.0;
+	for (std::size_t batch = 0; batch < Batches; ++batch)
+	{
+		for (std::size_t edit = 0; edit < BatchSize; ++edit)
+		{
+			std::int64_t  x      = rng() % (Size * Chunk::Size);
+			std::int64_t  y      = rng() % (Size * Chunk::Size);
+			std::int64_t  z      = static_cast<std::int64_t>(rng() % (Size * Chunk::Size)) - Size / 2 * Chunk::Size;
+			std::uint32_t choice = rng() % 10;
+			dimension.setVoxel(x, y, z, choice < 5 ? Chunk::EmptyState : choice < 8 ? 0 : Torch);
+		}
+		start    = Clock::now();
+		updates += dimension.updateLighting();
+		seconds += std::chrono::duration<double>(Clock::now() - start).count();
+	}
+	Benchmarks::report("edits", static_cast<double>(updates) / seconds / 1e6, "M updates/s");
+	Benchmarks::report("edits", static_cast<double>(Batches * BatchSize) / seconds, "edits/s");
+	Benchmarks::report("batch of 50 edits", seconds / Batches * 1e3, "ms");
+}
@@ -0,0 +1,52 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	const void* volatile s_Sink = nullptr;
+} // namespace
+
+namespace Benchmarks
+{
+	std::vector<Benchmark>& getBenchmarks()
+	{
+		static std::vector<Benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	bool registerBenchmark(const char* name, BenchmarkFunc func)
+	{
+		getBenchmarks().push_back({ name, func });
+		return true;
+	}
+
+	void report(const char* label, double value, const char* unit)
+	{
+		std::printf("  %-40s %12.3f %s\n", label, value, unit);
+		std::fflush(stdout);
+	}
+
+	void doNotOptimize(const void* value)
+	{
+		s_Sink = value;
+	}
+} // namespace Benchmarks
+
+// Runs every benchmark, or only those whose name contains one of the arguments.
+int main(int argc, char** argv)
+{
+	for (auto& benchmark : Benchmarks::getBenchmarks())
+	{
+		bool selected = argc < 2;
+		for (int i = 1; i < argc && !selected; ++i)
+			selected = std::strstr(benchmark.m_Name, argv[i]) != nullptr;
+		if (!selected)
+			continue;
+
+		std::printf("%s\n", benchmark.m_Name);
+		benchmark.m_Func();
+	}
+	return 0;
+}
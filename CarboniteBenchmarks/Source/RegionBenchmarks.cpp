@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+#include "Carbonite/World/Region/RegionStorage.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Chunks laid out in columns of 4 along z, 100k of them cover about 160x160 columns.
+	ChunkCoord GetCoord(std::size_t i)
+	{
+		std::int64_t column = static_cast<std::int64_t>(i / 4);
+		return { column % 160, column / 160, static_cast<std::int64_t>(i % 4) - 2 };
+	}
+} // namespace
+
+// Save and load throughput of the region files, every chunk a copy of one of a few generated terrain chunks.
+BENCHMARK(RegionSaveLoad)
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<Chunk> templates;
+	TerrainGenerator   generator;
+	for (std::size_t i = 0; i < 64; ++i)
+	{
+		templates.emplace_back(GetCoord(i));
+		generator.generate(templates.back());
+	}
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "CarboniteBenchmarks" / "Regions";
+	for (std::size_t chunkCount : { 10'000ULL, 100'000ULL })
+	{
+		std::filesystem::remove_all(directory);
+		std::string prefix = std::to_string(chunkCount) + " chunks ";
+
+		{
+			RegionStorage                         storage(directory);
+			std::vector<RegionStorage::ChunkSave> batch;
+			auto                                  start = Clock::now();
+			for (std::size_t i = 0; i < chunkCount; ++i)
+			{
+				auto& chunk = templates[i % templates.size()];
+				batch.push_back({ GetCoord(i), chunk.getVoxels(), chunk.getHeightmap(), chunk.getFluid() });
+				if (batch.size() == 1024 || i + 1 == chunkCount)
+				{
+					storage.saveChunks(batch);
+					batch.clear();
+				}
+			}
+			storage.flush();
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			Benchmarks::report((prefix + "save").c_str(), static_cast<double>(chunkCount) / seconds, "chunks/s");
+		}
+
+		{
+			// A fresh storage maps the files again, so loads start cold in the process.
+			RegionStorage storage(directory);
+			std::size_t   loaded = 0;
+			auto          start  = Clock::now();
+			for (std::size_t i = 0; i < chunkCount; ++i)
+			{
+				Chunk chunk(GetCoord(i));
+				loaded += storage.loadChunk(chunk);
+			}
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			Benchmarks::report((prefix + "load").c_str(), static_cast<double>(loaded) / seconds, "chunks/s");
+		}
+	}
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Dimension.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+// Main thread stall of handing about 10k edited chunks to the save thread, against writing them on the main thread.
+BENCHMARK(RegionSaverStall)
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "CarboniteBenchmarks" / "Saves";
+	std::filesystem::remove_all(directory);
+
+	TerrainGenerator generator;
+	{
+		Dimension dimension;
+		dimension.setSaveDirectory(directory / "Background");
+		dimension.setGenerator([&generator](Chunk& chunk) { generator.generate(chunk); });
+		for (std::int64_t z = -10; z <= 10; ++z)
+			for (std::int64_t y = 0; y < 22; ++y)
+				for (std::int64_t x = 0; x < 22; ++x)
+					dimension.loadChunk({ x, y, z });
+		dimension.forEachChunk([](Chunk& chunk) { chunk.set(1, 2, 3, 0); });
+		double chunkCount = static_cast<double>(dimension.getLoadedChunkCount());
+		Benchmarks::report("chunks", chunkCount, "chunks");
+
+		{
+			RegionStorage                         storage(directory / "Synchronous");
+			std::vector<RegionStorage::ChunkSave> batch;
+			auto                                  start = Clock::now();
+			dimension.forEachChunk([&batch](const Chunk& chunk) { batch.push_back({ chunk.getCoord(), chunk.getVoxels(), chunk.getHeightmap(), chunk.getFluid() }); });
+			storage.saveChunks(batch);
+			storage.flush();
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			Benchmarks::report("synchronous save", seconds * 1e3, "ms");
+		}
+
+		auto        start  = Clock::now();
+		std::size_t queued = dimension.saveAllChunks();
+		double      stall  = std::chrono::duration<double>(Clock::now() - start).count();
+		dimension.waitForSaves();
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		Benchmarks::report("background save stall", stall * 1e3, "ms");
+		Benchmarks::report("background save stall", stall / static_cast<double>(queued) * 1e6, "us/chunk");
+		Benchmarks::report("background save total", seconds * 1e3, "ms");
+	}
+	std::filesystem::remove_all(directory);
+}
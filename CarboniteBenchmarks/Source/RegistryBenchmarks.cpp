@@ -0,0 +1,62 @@
+#include "Benchmark.h"
+#include "Utils/InternalRegistry.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Nanoseconds per lookup of every id and every name in a shuffled order, all of them present.
+	void MeasureLookups(const Registry<std::uint64_t>& registry, const std::vector<std::uint64_t>& ids, const std::vector<std::string>& names, const std::string& prefix)
+	{
+		double seconds = Benchmarks::measure([&]() {
+			std::uint64_t sum = 0;
+			for (std::uint64_t id : ids)
+				sum += *registry.get(id);
+			Benchmarks::doNotOptimize(&sum);
+		});
+		Benchmarks::report((prefix + " id lookup").c_str(), seconds / static_cast<double>(ids.size()) * 1e9, "ns");
+
+		seconds = Benchmarks::measure([&]() {
+			std::uint64_t sum = 0;
+			for (auto& name : names)
+				sum += *registry.get(name);
+			Benchmarks::doNotOptimize(&sum);
+		});
+		Benchmarks::report((prefix + " name lookup").c_str(), seconds / static_cast<double>(names.size()) * 1e9, "ns");
+	}
+} // namespace
+
+// Id and name lookups while mods load and after freeze(), for a handful of entries, a modded game's blocks and its states.
+// Ids are sparse like the ones mods hand out, names look like namespaced paths.
+BENCHMARK(RegistryLookups)
+{
+	for (std::size_t size : { 16, 1000, 20'000 })
+	{
+		std::mt19937_64            rng(size);
+		Registry<std::uint64_t>    registry;
+		std::vector<std::uint64_t> ids;
+		std::vector<std::string>   names;
+		while (ids.size() < size)
+		{
+			std::uint64_t id   = rng() % (size * 64);
+			std::string   name = "carbonite:block/" + std::to_string(rng() % 100) + "/state_" + std::to_string(ids.size());
+			if (!registry.addEntry(name, id, std::uint64_t { id }))
+				continue;
+			ids.push_back(id);
+			names.push_back(std::move(name));
+		}
+		std::shuffle(ids.begin(), ids.end(), rng);
+		std::shuffle(names.begin(), names.end(), rng);
+
+		std::string prefix = std::to_string(size) + " entries,";
+		MeasureLookups(registry, ids, names, prefix + " loading");
+		registry.freeze();
+		MeasureLookups(registry, ids, names, prefix + " frozen");
+	}
+}
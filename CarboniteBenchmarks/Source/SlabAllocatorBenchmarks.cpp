@@ -0,0 +1,113 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Chunk.h"
+#include "Utils/Pool.h"
+#include "Utils/SlabAllocator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct ChurnResult
+	{
+	public:
+		double      m_AverageMicroseconds = 0.0;
+		double      m_P99Microseconds     = 0.0;
+		double      m_MaxMicroseconds     = 0.0;
+		std::size_t m_PeakResidentGrowth  = 0;
+		std::size_t m_FinalResidentGrowth = 0;
+	};
+
+	// Streams chunks through a window of 1500 loaded ones, with unrelated small allocations in between like the rest of the game.
+	// Only the allocations are timed: the chunk, its packed voxels and its light levels.
+	ChurnResult Churn()
+	{
+		using Clock = std::chrono::steady_clock;
+
+		constexpr std::size_t Window     = 1500;
+		constexpr std::size_t Iterations = 40'000;
+
+		Pool<Chunk>                    chunks;
+		std::deque<Chunk*>             live;
+		std::vector<std::vector<char>> noise;
+		std::vector<double>            latencies;
+		std::mt19937_64                rng(1);
+		std::size_t                    baseline = Slab::getResidentBytes();
+		std::size_t                    peak     = baseline;
+		latencies.reserve(Iterations);
+		for (std::size_t i = 0; i < Iterations; ++i)
+		{
+			auto                       start     = Clock::now();
+			Chunk*                     chunk     = chunks.allocate(static_cast<std::int64_t>(i), 0, 0);
+			std::uint32_t              bits      = 1U << (rng() % 4);
+			std::vector<std::uint64_t> palette(1ULL << bits);
+			ChunkStorage::Words        words(ChunkStorage::VoxelCount / (64 / bits));
+			auto                       allocated = Clock::now();
+
+			for (std::size_t j = 0; j < palette.size(); ++j)
+				palette[j] = j;
+			for (auto& word : words)
+				word = rng();
+			chunk->getVoxels().assign(std::move(palette), std::move(words));
+
+			auto lightStart = Clock::now();
+			if (i & 1)
+				chunk->getLight().set(ELightChannel::Block, i % ChunkStorage::VoxelCount, 7);
+			latencies.push_back(std::chrono::duration<double, std::micro>((allocated - start) + (Clock::now() - lightStart)).count());
+
+			noise.emplace_back(16 + rng() % 3000);
+			if (noise.size() > 4000)
+				noise.erase(noise.begin() + static_cast<std::ptrdiff_t>(rng() % noise.size()));
+			live.push_back(chunk);
+			if (live.size() > Window)
+			{
+				chunks.free(live.front());
+				live.pop_front();
+			}
+			if (i % 256 == 0)
+				peak = std::max(peak, Slab::getResidentBytes());
+		}
+
+		ChurnResult result;
+		std::sort(latencies.begin(), latencies.end());
+		for (double latency : latencies)
+			result.m_AverageMicroseconds += latency;
+		result.m_AverageMicroseconds /= static_cast<double>(latencies.size());
+		result.m_P99Microseconds      = latencies[latencies.size() * 99 / 100];
+		result.m_MaxMicroseconds      = latencies.back();
+		result.m_PeakResidentGrowth   = std::max(peak, Slab::getResidentBytes()) - baseline;
+		result.m_FinalResidentGrowth  = std::max(baseline, Slab::getResidentBytes()) - baseline;
+		return result;
+	}
+} // namespace
+
+// Chunk churn allocation latency and resident memory, with the buffers from operator new and then from the slabs.
+// The heap runs first, slab arenas are never given back and would hide its growth otherwise.
+BENCHMARK(SlabAllocatorChunkChurn)
+{
+	bool wasEnabled = Slab::isEnabled();
+	for (bool enabled : { false, true })
+	{
+		Slab::setEnabled(enabled);
+		ChurnResult result = Churn();
+		std::string prefix = enabled ? "slab " : "heap ";
+		Benchmarks::report((prefix + "allocation average").c_str(), result.m_AverageMicroseconds, "us");
+		Benchmarks::report((prefix + "allocation p99").c_str(), result.m_P99Microseconds, "us");
+		Benchmarks::report((prefix + "allocation max").c_str(), result.m_MaxMicroseconds, "us");
+		Benchmarks::report((prefix + "peak resident growth").c_str(), static_cast<double>(result.m_PeakResidentGrowth) / (1 << 20), "MiB");
+		Benchmarks::report((prefix + "resident growth after churn").c_str(), static_cast<double>(result.m_FinalResidentGrowth) / (1 << 20), "MiB");
+	}
+	Slab::setEnabled(wasEnabled);
+
+	auto stats = Slab::getStats();
+	Benchmarks::report("slab arenas", static_cast<double>(stats.m_ArenaBytes) / (1 << 20), "MiB");
+	Benchmarks::report("slab peak used", static_cast<double>(stats.m_PeakUsedBytes) / (1 << 20), "MiB");
+}
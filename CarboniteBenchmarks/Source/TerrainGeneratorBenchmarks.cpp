@@ -0,0 +1,80 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Generation/Noise.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Four chunks per column from the caves to the air above the surface, every column new to the generator.
+	void GenerateColumns(TerrainGenerator& generator, std::int64_t firstColumn, std::int64_t columnCount, std::int64_t stride)
+	{
+		for (std::int64_t column = firstColumn; column < columnCount; column += stride)
+		{
+			for (std::int64_t z = -2; z < 2; ++z)
+			{
+				Chunk chunk(column % 256, column / 256, z);
+				generator.generate(chunk);
+				Benchmarks::doNotOptimize(&chunk);
+			}
+		}
+	}
+} // namespace
+
+BENCHMARK(NoiseRows)
+{
+	Noise              noise(1234);
+	NoiseFractal       fractal;
+	std::vector<float> row(Chunk::Size);
+	double             samples = static_cast<double>(row.size());
+
+	double seconds = Benchmarks::measure([&]() { noise.perlinRow(0.5f, 1.5f, 0.173f, row.size(), row.data()); });
+	Benchmarks::report("perlin 2D", samples / seconds / 1e6, "Msamples/s");
+	seconds = Benchmarks::measure([&]() { noise.perlinRow(0.5f, 1.5f, 2.5f, 0.173f, row.size(), row.data()); });
+	Benchmarks::report("perlin 3D", samples / seconds / 1e6, "Msamples/s");
+	seconds = Benchmarks::measure([&]() { noise.simplexRow(0.5f, 1.5f, 0.173f, row.size(), row.data()); });
+	Benchmarks::report("simplex", samples / seconds / 1e6, "Msamples/s");
+	seconds = Benchmarks::measure([&]() { noise.fractalRow(ENoiseType::Simplex, fractal, 0.5f, 1.5f, 0.173f, row.size(), row.data()); });
+	Benchmarks::report("simplex fractal, 4 octaves", samples / seconds / 1e6, "Msamples/s");
+}
+
+BENCHMARK(TerrainGeneratorThroughput)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::int64_t ColumnCount = 512;
+
+	{
+		TerrainGenerator generator;
+		auto             start = Clock::now();
+		GenerateColumns(generator, 0, ColumnCount, 1);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		Benchmarks::report("1 thread", ColumnCount * 4 / seconds, "chunks/s");
+	}
+
+	// One generator shared by every thread, the way the world uses it.
+	std::size_t threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+	if (threadCount == 1)
+		return;
+
+	TerrainGenerator         generator;
+	std::vector<std::thread> threads;
+	auto                     start = Clock::now();
+	for (std::size_t i = 0; i < threadCount; ++i)
+	{
+		std::int64_t stride = static_cast<std::int64_t>(threadCount);
+		threads.emplace_back([&generator, i, stride]() { GenerateColumns(generator, ColumnCount + static_cast<std::int64_t>(i), ColumnCount * (stride + 1), stride); });
+	}
+	for (auto& thread : threads)
+		thread.join();
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	double chunks  = static_cast<double>(ColumnCount * threadCount * 4);
+	Benchmarks::report("all threads", chunks / seconds, "chunks/s");
+	Benchmarks::report("all threads, per core", chunks / seconds / static_cast<double>(threadCount), "chunks/s");
+}
@@ -0,0 +1,77 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Dimension.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// 10k player sized bodies walking and falling over generated terrain.
+BENCHMARK(VoxelCollisionBodies)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::int64_t Radius    = 6;
+	constexpr std::size_t  BodyCount = 10'000;
+	constexpr std::size_t  Ticks     = 200;
+	constexpr float        Extent    = static_cast<float>(Radius * Chunk::Size);
+	constexpr float        Margin    = 4.0f;
+
+	Benchmarks::TerrainWorld world;
+	world.loadBox({ -Radius, -Radius, -2 }, { Radius, Radius, 3 });
+	auto& dimension = world.getDimension();
+
+	// Bodies start just above the surface, every tick moves them up to 0.4 voxels sideways and pulls them down.
+	std::mt19937_64                       rng(5);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<CollisionBody>            start(BodyCount);
+	for (auto& body : start)
+	{
+		float        x      = (unit(rng) * 2.0f - 1.0f) * (Extent - Margin);
+		float        y      = (unit(rng) * 2.0f - 1.0f) * (Extent - Margin);
+		std::int64_t height = dimension.getHeight(EHeightmap::MotionBlocking, static_cast<std::int64_t>(std::floor(x)), static_cast<std::int64_t>(std::floor(y)));
+		float        z      = std::min(height == ColumnHeightmaps::NoHeight ? -60.0f : static_cast<float>(height), 90.0f) + unit(rng) * 3.0f;
+		body.m_Min          = { x, y, z };
+		body.m_Max          = { x + 0.6f, y + 0.6f, z + 1.8f };
+	}
+	std::vector<std::vector<glm::fvec3>> motions(Ticks, std::vector<glm::fvec3>(BodyCount));
+	for (auto& tick : motions)
+		for (auto& motion : tick)
+			motion = { (unit(rng) - 0.5f) * 0.8f, (unit(rng) - 0.5f) * 0.8f, -0.08f - unit(rng) * 0.5f };
+
+	std::vector<CollisionBody> bodies  = start;
+	double                     seconds = 0.0;
+	std::size_t                blocked = 0;
+	for (std::size_t tick = 0; tick < Ticks; ++tick)
+	{
+		for (std::size_t i = 0; i < BodyCount; ++i)
+			bodies[i].m_Motion = motions[tick][i];
+		auto begin = Clock::now();
+		dimension.collide(bodies);
+		seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+		blocked += dimension.getCollision().getStats().m_Blocked;
+	}
+	Benchmarks::report("collide", seconds / Ticks * 1e3, "ms/tick");
+	Benchmarks::report("collide", seconds / Ticks / BodyCount * 1e9, "ns/body");
+	Benchmarks::report("blocked", static_cast<double>(blocked) / Ticks, "bodies/tick");
+
+	// For scale, one sweep per body that only finds the first hit and does not slide along it.
+	bodies  = start;
+	seconds = 0.0;
+	for (std::size_t tick = 0; tick < 20; ++tick)
+	{
+		auto begin = Clock::now();
+		for (std::size_t i = 0; i < BodyCount; ++i)
+		{
+			VoxelHit hit;
+			dimension.sweep(bodies[i].m_Min, bodies[i].m_Max, motions[tick][i], hit);
+			Benchmarks::doNotOptimize(&hit);
+		}
+		seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+	}
+	Benchmarks::report("sweep per body", seconds / 20 * 1e3, "ms/tick");
+}
@@ -0,0 +1,82 @@
+#include "Benchmark.h"
+#include "Carbonite/World/ChunkStorage.h"
+#include "Carbonite/World/VoxelKernels.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr std::uint32_t Widths[] { 1, 2, 4, 8, 16 };
+
+	constexpr EVoxelKernelSet Sets[] { EVoxelKernelSet::Scalar, EVoxelKernelSet::SSE41, EVoxelKernelSet::AVX2 };
+
+	const char* GetSetName(EVoxelKernelSet set)
+	{
+		switch (set)
+		{
+		case EVoxelKernelSet::Scalar: return "scalar";
+		case EVoxelKernelSet::SSE41: return "sse4.1";
+		case EVoxelKernelSet::AVX2: return "avx2";
+		default: return "unknown";
+		}
+	}
+
+	// A chunk of packed indices in runs, never using the highest index so it can be searched for and swapped in.
+	std::vector<std::uint64_t> MakeWords(std::uint32_t bits)
+	{
+		std::uint32_t              perWord = 64 / bits;
+		std::uint32_t              unused  = (1U << bits) - 1;
+		std::vector<std::uint64_t> words(ChunkStorage::VoxelCount / perWord, 0);
+		std::mt19937               rng(bits);
+		std::uint32_t              run = 0;
+		for (std::size_t i = 0; i < ChunkStorage::VoxelCount; ++i)
+		{
+			if (rng() % 64 == 0)
+				run = unused > 1 ? static_cast<std::uint32_t>(rng() % unused) : 0;
+			words[i / perWord] |= static_cast<std::uint64_t>(run) << ((i % perWord) * bits);
+		}
+		return words;
+	}
+} // namespace
+
+// Each kernel over a whole chunk per call, for every supported set and index width.
+BENCHMARK(VoxelKernelsPerSet)
+{
+	double voxels = static_cast<double>(ChunkStorage::VoxelCount);
+	for (EVoxelKernelSet set : Sets)
+	{
+		if (set > VoxelKernels::getSupportedSet())
+			continue;
+		VoxelKernels::setKernelSet(set);
+
+		for (std::uint32_t bits : Widths)
+		{
+			std::string                prefix = std::string(GetSetName(set)) + " " + std::to_string(bits) + " bits ";
+			auto                       words  = MakeWords(bits);
+			std::uint32_t              unused = (1U << bits) - 1;
+			std::vector<std::uint32_t> counts(1ULL << bits);
+
+			std::size_t result  = 0;
+			double      seconds = Benchmarks::measure([&]() { result += VoxelKernels::count(words.data(), words.size(), bits, 0); });
+			Benchmarks::report((prefix + "count").c_str(), voxels / seconds / 1e9, "Gvoxels/s");
+			// Searching for an index that is not there scans the whole chunk.
+			seconds = Benchmarks::measure([&]() { result += VoxelKernels::findFirst(words.data(), words.size(), bits, unused); });
+			Benchmarks::report((prefix + "findFirst").c_str(), voxels / seconds / 1e9, "Gvoxels/s");
+			// Swapping an index out and back in keeps the input the same between calls.
+			seconds = Benchmarks::measure([&]() {
+				result += VoxelKernels::replace(words.data(), words.size(), bits, 0, unused);
+				result += VoxelKernels::replace(words.data(), words.size(), bits, unused, 0);
+			});
+			Benchmarks::report((prefix + "replace").c_str(), 2.0 * voxels / seconds / 1e9, "Gvoxels/s");
+			seconds = Benchmarks::measure([&]() { VoxelKernels::histogram(words.data(), words.size(), bits, counts.data(), counts.size()); });
+			Benchmarks::report((prefix + "histogram").c_str(), voxels / seconds / 1e9, "Gvoxels/s");
+			Benchmarks::doNotOptimize(&result);
+		}
+	}
+	VoxelKernels::setKernelSet(VoxelKernels::getSupportedSet());
+}
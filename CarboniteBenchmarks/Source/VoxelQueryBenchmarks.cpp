@@ -0,0 +1,48 @@
+#include "Benchmark.h"
+#include "Carbonite/World/Dimension.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <random>
+#include <vector>
+
+// Rays per second through generated terrain, one at a time and in batches on the calling thread and on the worker pool.
+BENCHMARK(VoxelQueryRays)
+{
+	TerrainSettings settings;
+	settings.m_BaseHeight = 8.0f;
+	Benchmarks::TerrainWorld world(settings);
+	world.loadBox({ -4, -4, -3 }, { 4, 4, 3 });
+	auto& dimension = world.getDimension();
+
+	// Rays of up to 100 voxels in every direction around the surface, and long nearly flat rays through the sky above it.
+	std::mt19937                          rng(5);
+	std::uniform_real_distribution<float> horizontal(-120.0f, 120.0f);
+	std::uniform_real_distribution<float> vertical(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+	std::vector<VoxelRay>                 rays(20'000);
+	std::vector<VoxelRay>                 skyRays(20'000);
+	for (auto& ray : rays)
+		ray = { { horizontal(rng), horizontal(rng), vertical(rng) }, { direction(rng), direction(rng), direction(rng) }, 100.0f };
+	for (auto& ray : skyRays)
+		ray = { { horizontal(rng), horizontal(rng), 150.0f }, { direction(rng), direction(rng), 0.05f }, 512.0f };
+
+	double   count   = static_cast<double>(rays.size());
+	VoxelHit hit;
+	double   seconds = Benchmarks::measure([&]() {
+		for (auto& ray : rays)
+			dimension.raycast(ray, hit);
+	});
+	Benchmarks::report("single rays", count / seconds / 1e6, "M rays/s");
+
+	std::vector<VoxelHit> hits;
+	seconds = Benchmarks::measure([&]() { VoxelQuery::raycast(dimension, rays, hits); });
+	Benchmarks::report("batch, calling thread", count / seconds / 1e6, "M rays/s");
+	seconds = Benchmarks::measure([&]() { dimension.raycast(rays, hits); });
+	Benchmarks::report("batch, worker pool", count / seconds / 1e6, "M rays/s");
+	Benchmarks::report("worker pool", static_cast<double>(dimension.getWorkers().getWorkerCount() + 1), "threads");
+
+	seconds = Benchmarks::measure([&]() { VoxelQuery::raycast(dimension, skyRays, hits); });
+	Benchmarks::report("sky rays of 512 voxels", static_cast<double>(skyRays.size()) / seconds / 1e6, "M rays/s");
+}
@@ -0,0 +1,146 @@
+#include "Carbonite/Block/BlockStateTable.h"
+#include "Carbonite/Renderer/Mesh/ChunkMesher.h"
+#include "Carbonite/World/Generation/TerrainGenerator.h"
+#include "Test.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	constexpr std::uint64_t Stone = 0;
+	constexpr std::uint64_t Dirt  = 1;
+	constexpr std::uint64_t Grass = 2;
+	constexpr std::uint64_t Glass = 3; // Not opaque, must not get faces or hide any
+
+	const BlockStateTable& GetBlockStates()
+	{
+		static BlockStateTable table = []() {
+			Registry<BlockState> registry;
+			registry.addEntry("stone", Stone, BlockState {});
+			registry.addEntry("dirt", Dirt, BlockState {});
+			registry.addEntry("grass", Grass, BlockState {});
+			BlockState glass;
+			glass.m_Opaque = false;
+			registry.addEntry("glass", Glass, std::move(glass));
+			registry.freeze();
+
+			BlockStateTable blockStates;
+			blockStates.build(registry);
+			return blockStates;
+		}();
+		return table;
+	}
+
+	// Meshes the voxels with both modes, they must agree on every quad and therefore on the geometry.
+	void CompareModes(const ChunkStorage& voxels, const std::array<const ChunkStorage*, FaceCount>& neighbours)
+	{
+		ChunkMesher reference;
+		ChunkMesher binary;
+		reference.setMode(EChunkMesherMode::Reference);
+		binary.setMode(EChunkMesherMode::Binary);
+		reference.setBlockStates(&GetBlockStates());
+		binary.setBlockStates(&GetBlockStates());
+
+		std::vector<Vertex>        referenceVertices, binaryVertices;
+		std::vector<std::uint32_t> referenceIndices, binaryIndices;
+		reference.mesh(voxels, neighbours, referenceVertices, referenceIndices);
+		binary.mesh(voxels, neighbours, binaryVertices, binaryIndices);
+
+		CHECK(reference.getQuads() == binary.getQuads());
+		CHECK(referenceVertices.size() == binaryVertices.size());
+		CHECK(referenceIndices == binaryIndices);
+	}
+
+	void CompareModes(const ChunkStorage& voxels)
+	{
+		CompareModes(voxels, {});
+	}
+
+	void FillRandom(ChunkStorage& voxels, std::mt19937& rng, std::uint32_t emptyChance, std::uint32_t stateCount)
+	{
+		for (std::size_t i = 0; i < ChunkStorage::VoxelCount; ++i)
+			voxels.set(i, rng() % emptyChance == 0 ? Chunk::EmptyState : rng() % stateCount);
+	}
+} // namespace
+
+TEST(ChunkMesherUniform)
+{
+	ChunkStorage voxels;
+	CompareModes(voxels);
+	voxels.fill(Stone);
+	CompareModes(voxels);
+	voxels.fill(Glass);
+	CompareModes(voxels);
+}
+
+TEST(ChunkMesherRandom)
+{
+	std::mt19937 rng(1);
+	for (std::uint32_t trial = 0; trial < 24; ++trial)
+	{
+		// Sparse to dense, one to all four states, the single opaque state case has its own binary path.
+		ChunkStorage voxels;
+		FillRandom(voxels, rng, 2 + trial % 4, 1 + trial % 4);
+
+		std::array<std::optional<ChunkStorage>, FaceCount> neighbourStorage;
+		std::array<const ChunkStorage*, FaceCount>         neighbours {};
+		for (std::uint32_t face = 0; face < FaceCount; ++face)
+		{
+			if (rng() % 2)
+				continue;
+			neighbourStorage[face].emplace();
+			FillRandom(*neighbourStorage[face], rng, 3, 4);
+			neighbours[face] = &*neighbourStorage[face];
+		}
+		CompareModes(voxels, neighbours);
+	}
+}
+
+TEST(ChunkMesherTerrain)
+{
+	TerrainSettings settings;
+	settings.m_HeightAmplitude = 24.0f;
+	TerrainGenerator generator(settings);
+
+	// The surface, the caves below it and a layer that is mostly air.
+	for (std::int64_t z = -2; z <= 1; ++z)
+	{
+		Chunk chunk(0, 0, z);
+		generator.generate(chunk);
+
+		std::array<std::optional<Chunk>, FaceCount> neighbourChunks;
+		std::array<const ChunkStorage*, FaceCount>  neighbours {};
+		for (std::uint32_t face = 0; face < FaceCount; ++face)
+		{
+			neighbourChunks[face].emplace(chunk.getCoord().neighbour(static_cast<EFace>(face)));
+			generator.generate(*neighbourChunks[face]);
+			neighbours[face] = &neighbourChunks[face]->getVoxels();
+		}
+		CompareModes(chunk.getVoxels(), neighbours);
+	}
+}
+
+TEST(ChunkMesherCheckerboard)
+{
+	// Nothing merges, the worst case for the quad count.
+	ChunkStorage voxels;
+	for (std::uint32_t z = 0; z < Chunk::Size; ++z)
+		for (std::uint32_t y = 0; y < Chunk::Size; ++y)
+			for (std::uint32_t x = 0; x < Chunk::Size; ++x)
+				voxels.set(Chunk::PositionToIndex(x, y, z), (x + y + z) % 2 ? Stone : Chunk::EmptyState);
+	CompareModes(voxels);
+
+	// Alternating opaque states merge nothing either, glass in between hides no faces.
+	for (std::uint32_t z = 0; z < Chunk::Size; ++z)
+		for (std::uint32_t y = 0; y < Chunk::Size; ++y)
+			for (std::uint32_t x = 0; x < Chunk::Size; ++x)
+				voxels.set(Chunk::PositionToIndex(x, y, z), (x + y + z) % 3 == 0 ? Glass : (x + y + z) % 3 == 1 ? Stone : Dirt);
+	CompareModes(voxels);
+}
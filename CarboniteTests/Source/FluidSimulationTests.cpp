@@ -0,0 +1,66 @@
+#include "Carbonite/World/Dimension.h"
+#include "Test.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+
+namespace
+{
+	constexpr std::uint8_t  Water = 0;
+	constexpr std::uint64_t Stone = 1;
+
+	// Empty chunks from -32 to 31 on every axis, everything outside is unloaded and solid.
+	std::unique_ptr<Dimension> MakeDimension()
+	{
+		auto dimension = std::make_unique<Dimension>();
+		for (std::int64_t z = -1; z < 1; ++z)
+			for (std::int64_t y = -1; y < 1; ++y)
+				for (std::int64_t x = -1; x < 1; ++x)
+					dimension->loadChunk({ x, y, z });
+		return dimension;
+	}
+
+	void Settle(Dimension& dimension)
+	{
+		for (std::size_t i = 0; i < 500 && (dimension.updateFluids() != 0 || dimension.getFluids().getActiveCellCount() != 0); ++i)
+			;
+	}
+} // namespace
+
+TEST(FluidFallingColumnSpreadsWhereItLands)
+{
+	// A source walled in on every side but the bottom, so a single column falls from it.
+	auto dimension = MakeDimension();
+	dimension->setVoxel(-1, 0, 20, Stone);
+	dimension->setVoxel(1, 0, 20, Stone);
+	dimension->setVoxel(0, -1, 20, Stone);
+	dimension->setVoxel(0, 1, 20, Stone);
+	dimension->setFluid(0, 0, 20, ChunkFluid::Make(Water, ChunkFluid::MaxLevel, true));
+	Settle(*dimension);
+
+	CHECK(dimension->getFluid(0, 0, 0) == ChunkFluid::Make(Water, ChunkFluid::MaxLevel, false));
+	CHECK(dimension->getFluid(0, 0, -32) == ChunkFluid::Make(Water, ChunkFluid::MaxLevel, false));
+	// Nothing beside the column while it falls, a puddle where it hits the unloaded floor.
+	CHECK(dimension->getFluid(1, 0, 0) == 0);
+	CHECK(dimension->getFluid(1, 0, -31) == 0);
+	CHECK(ChunkFluid::GetLevel(dimension->getFluid(1, 0, -32)) == ChunkFluid::MaxLevel - 1);
+	CHECK(ChunkFluid::GetLevel(dimension->getFluid(0, 3, -32)) == ChunkFluid::MaxLevel - 3);
+}
+
+TEST(FluidRestingOnFallingFluidSpreads)
+{
+	// A source on a stone pillar flows over the edge, the cells past the edge rest on the fluid falling below them.
+	auto dimension = MakeDimension();
+	dimension->setVoxel(0, 0, 9, Stone);
+	dimension->setFluid(0, 0, 10, ChunkFluid::Make(Water, ChunkFluid::MaxLevel, true));
+	Settle(*dimension);
+
+	CHECK(ChunkFluid::GetLevel(dimension->getFluid(1, 0, 10)) == ChunkFluid::MaxLevel - 1);
+	CHECK(dimension->getFluid(1, 0, 9) == ChunkFluid::Make(Water, ChunkFluid::MaxLevel, false));
+	CHECK(ChunkFluid::GetLevel(dimension->getFluid(2, 0, 10)) == ChunkFluid::MaxLevel - 2);
+	CHECK(ChunkFluid::GetLevel(dimension->getFluid(3, 3, 10)) == ChunkFluid::MaxLevel - 6);
+	CHECK(dimension->getFluid(3, 3, 0) == ChunkFluid::Make(Water, ChunkFluid::MaxLevel, false));
+	CHECK(dimension->getFluid(8, 0, 10) == 0);
+}
@@ -0,0 +1,57 @@
+#include "Test.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace Tests
+{
+	static std::size_t s_Failures = 0;
+
+	std::vector<Test>& getTests()
+	{
+		static std::vector<Test> tests;
+		return tests;
+	}
+
+	bool registerTest(const char* name, TestFunc func)
+	{
+		getTests().push_back({ name, func });
+		return true;
+	}
+
+	void fail(const char* file, int line, const char* expression)
+	{
+		std::printf("  %s:%d: CHECK(%s) failed\n", file, line, expression);
+		++s_Failures;
+	}
+
+	std::size_t getFailures()
+	{
+		return s_Failures;
+	}
+} // namespace Tests
+
+// Runs every test, or only those whose name contains one of the arguments.
+int main(int argc, char** argv)
+{
+	std::size_t run    = 0;
+	std::size_t failed = 0;
+	for (auto& test : Tests::getTests())
+	{
+		bool selected = argc < 2;
+		for (int i = 1; i < argc && !selected; ++i)
+			selected = std::strstr(test.m_Name, argv[i]) != nullptr;
+		if (!selected)
+			continue;
+
+		std::printf("%s\n", test.m_Name);
+		std::size_t failures = Tests::getFailures();
+		test.m_Func();
+		++run;
+		if (Tests::getFailures() != failures)
+			++failed;
+	}
+
+	std::printf("%zu of %zu tests passed\n", run - failed, run);
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#include "Carbonite/World/Generation/Noise.h"
+#include "Test.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include <vector>
+
+namespace
+{
+	constexpr std::size_t RowLength = 37; // Several wide iterations plus a tail for every lane width
+
+	// Every prefix of a row must match the full row bit for bit, whichever part of it ran in the lanes or in the tail.
+	template <class F>
+	void CheckPrefixes(F&& row)
+	{
+		std::vector<float> full(RowLength);
+		std::vector<float> prefix(RowLength);
+		row(RowLength, full.data());
+		for (std::size_t count = 1; count <= RowLength; ++count)
+		{
+			row(count, prefix.data());
+			CHECK(std::memcmp(prefix.data(), full.data(), count * sizeof(float)) == 0);
+		}
+	}
+} // namespace
+
+TEST(NoisePerlinRowLength)
+{
+	Noise noise(1234);
+	CheckPrefixes([&](std::size_t count, float* out) { noise.perlinRow(0.37f, 5.1f, 0.173f, count, out); });
+	CheckPrefixes([&](std::size_t count, float* out) { noise.perlinRow(-13.9f, 5.1f, -2.7f, 0.173f, count, out); });
+}
+
+TEST(NoiseSimplexRowLength)
+{
+	Noise noise(1234);
+	CheckPrefixes([&](std::size_t count, float* out) { noise.simplexRow(0.37f, 5.1f, 0.173f, count, out); });
+	CheckPrefixes([&](std::size_t count, float* out) { noise.simplexRow(-1000.25f, 77.5f, 0.031f, count, out); });
+}
+
+TEST(NoiseFractalRowLength)
+{
+	Noise        noise(99);
+	NoiseFractal fractal;
+	CheckPrefixes([&](std::size_t count, float* out) { noise.fractalRow(ENoiseType::Perlin, fractal, 0.37f, 5.1f, 0.173f, count, out); });
+	CheckPrefixes([&](std::size_t count, float* out) { noise.fractalRow(ENoiseType::Simplex, fractal, 0.37f, 5.1f, 0.173f, count, out); });
+	CheckPrefixes([&](std::size_t count, float* out) { noise.fractalRow(fractal, 0.37f, 5.1f, -2.7f, 0.173f, count, out); });
+}
@@ -0,0 +1,87 @@
+#include "Test.h"
+#include "Utils/Pool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <utility>
+#include <vector>
+
+namespace
+{
+	std::size_t s_Live = 0;
+
+	struct Counted
+	{
+	public:
+		Counted(int value)
+		    : m_Value(value)
+		{
+			++s_Live;
+		}
+		~Counted() { --s_Live; }
+
+		int m_Value;
+	};
+
+	// Enough objects to span several pages of 64.
+	std::vector<Counted*> Fill(Pool<Counted>& pool, int first, int count)
+	{
+		std::vector<Counted*> values;
+		for (int i = 0; i < count; ++i)
+			values.push_back(pool.allocate(first + i));
+		return values;
+	}
+} // namespace
+
+TEST(PoolMoveAssign)
+{
+	s_Live = 0;
+	{
+		Pool<Counted> target;
+		Pool<Counted> source;
+		Fill(target, 0, 100);
+		auto values = Fill(source, 1000, 150);
+		source.free(values[7]);
+		CHECK(s_Live == 249);
+
+		// The objects of the target are destroyed, the ones of the source stay where they were.
+		target = std::move(source);
+		CHECK(s_Live == 149);
+		CHECK(target.getSize() == 149);
+		CHECK(source.getSize() == 0);
+		CHECK(source.getCapacity() == 0);
+		for (int i = 0; i < 150; ++i)
+			if (i != 7)
+				CHECK(values[i]->m_Value == 1000 + i);
+
+		// The freed slot came along, the source starts over with fresh pages.
+		Counted* reused = target.allocate(5);
+		CHECK(reused == values[7]);
+		Counted* fresh = source.allocate(6);
+		CHECK(source.getSize() == 1);
+		CHECK(fresh->m_Value == 6);
+		CHECK(s_Live == 151);
+
+		target.free(values[0]);
+		CHECK(target.getSize() == 149);
+	}
+	CHECK(s_Live == 0);
+}
+
+TEST(PoolMoveConstruct)
+{
+	s_Live = 0;
+	{
+		Pool<Counted> source;
+		auto          values = Fill(source, 0, 70);
+		Pool<Counted> moved(std::move(source));
+		CHECK(moved.getSize() == 70);
+		CHECK(source.getSize() == 0);
+		CHECK(values[69]->m_Value == 69);
+
+		Fill(source, 100, 3);
+		CHECK(s_Live == 73);
+	}
+	CHECK(s_Live == 0);
+}
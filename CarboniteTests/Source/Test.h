@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+#include <vector>
+
+// Minimal self registering tests: TEST(Name) { CHECK(expression); } in any source of the project.
+// A failed CHECK reports itself and marks the test failed, the test keeps running.
+namespace Tests
+{
+	using TestFunc = void (*)();
+
+	struct Test
+	{
+	public:
+		const char* m_Name;
+		TestFunc    m_Func;
+	};
+
+	std::vector<Test>& getTests();
+	bool               registerTest(const char* name, TestFunc func);
+
+	void fail(const char* file, int line, const char* expression);
+	// Failed checks of the running test.
+	std::size_t getFailures();
+} // namespace Tests
+
+#define TEST(name)                                                                     \
+	static void name();                                                                \
+	[[maybe_unused]] static bool name##Registered = Tests::registerTest(#name, &name); \
+	static void name()
+
+#define CHECK(expression)                                 \
+	do                                                    \
+	{                                                     \
+		if (!(expression))                                \
+			Tests::fail(__FILE__, __LINE__, #expression); \
+	} while (false)
@@ -0,0 +1,187 @@
+#include "Carbonite/World/VoxelKernels.h"
+#include "Test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr std::uint32_t Widths[] { 1, 2, 4, 8, 16 };
+	// Odd counts leave tails for the 2 and 4 word steps, 512 words are a chunk at 16 bits.
+	constexpr std::size_t WordCounts[] { 1, 2, 3, 5, 7, 64, 512 };
+
+	constexpr EVoxelKernelSet Sets[] { EVoxelKernelSet::Scalar, EVoxelKernelSet::SSE41, EVoxelKernelSet::AVX2 };
+
+	const char* GetSetName(EVoxelKernelSet set)
+	{
+		switch (set)
+		{
+		case EVoxelKernelSet::Scalar: return "Scalar";
+		case EVoxelKernelSet::SSE41: return "SSE4.1";
+		case EVoxelKernelSet::AVX2: return "AVX2";
+		default: return "Unknown";
+		}
+	}
+
+	// The reference extracts one index at a time, nothing shared with the kernels.
+	std::uint32_t GetIndex(const std::vector<std::uint64_t>& words, std::uint32_t bits, std::size_t position)
+	{
+		std::uint32_t perWord = 64 / bits;
+		std::uint64_t mask    = (1ULL << bits) - 1;
+		return static_cast<std::uint32_t>((words[position / perWord] >> ((position % perWord) * bits)) & mask);
+	}
+
+	// Indices below paletteSize, mostly runs of one index like real chunks, with noise in between.
+	std::vector<std::uint64_t> MakeWords(std::mt19937& rng, std::size_t wordCount, std::uint32_t bits, std::uint32_t paletteSize)
+	{
+		std::vector<std::uint64_t> words(wordCount, 0);
+		std::uint32_t              perWord = 64 / bits;
+		std::uint32_t              run     = 0;
+		for (std::size_t i = 0; i < wordCount * perWord; ++i)
+		{
+			if (rng() % 8 == 0)
+				run = static_cast<std::uint32_t>(rng() % paletteSize);
+			std::uint32_t index = rng() % 4 == 0 ? static_cast<std::uint32_t>(rng() % paletteSize) : run;
+			words[i / perWord] |= static_cast<std::uint64_t>(index) << ((i % perWord) * bits);
+		}
+		return words;
+	}
+
+	// Runs func() with every set the CPU supports, restoring the detected set afterwards.
+	template <class F>
+	void ForEachSet(F&& func)
+	{
+		for (EVoxelKernelSet set : Sets)
+		{
+			if (set > VoxelKernels::getSupportedSet())
+			{
+				std::printf("  %s not supported, skipped\n", GetSetName(set));
+				continue;
+			}
+			VoxelKernels::setKernelSet(set);
+			func();
+		}
+		VoxelKernels::setKernelSet(VoxelKernels::getSupportedSet());
+	}
+
+	std::uint32_t GetPaletteSize(std::uint32_t bits)
+	{
+		return bits >= 8 ? 20 : 1U << bits;
+	}
+} // namespace
+
+TEST(VoxelKernelsCount)
+{
+	ForEachSet([]() {
+		std::mt19937 rng(1);
+		for (std::uint32_t bits : Widths)
+		{
+			for (std::size_t wordCount : WordCounts)
+			{
+				std::uint32_t paletteSize = GetPaletteSize(bits);
+				auto          words       = MakeWords(rng, wordCount, bits, paletteSize);
+				for (std::uint32_t index = 0; index < paletteSize; ++index)
+				{
+					std::size_t expected = 0;
+					for (std::size_t i = 0; i < wordCount * (64 / bits); ++i)
+						expected += GetIndex(words, bits, i) == index;
+					CHECK(VoxelKernels::count(words.data(), wordCount, bits, index) == expected);
+				}
+			}
+		}
+	});
+}
+
+TEST(VoxelKernelsFindFirst)
+{
+	ForEachSet([]() {
+		std::mt19937 rng(2);
+		for (std::uint32_t bits : Widths)
+		{
+			for (std::size_t wordCount : WordCounts)
+			{
+				std::size_t indexCount = wordCount * (64 / bits);
+				auto        words      = MakeWords(rng, wordCount, bits, GetPaletteSize(bits));
+				for (std::uint32_t index = 0; index < GetPaletteSize(bits); ++index)
+				{
+					std::size_t expected = 0;
+					while (expected < indexCount && GetIndex(words, bits, expected) != index)
+						++expected;
+					CHECK(VoxelKernels::findFirst(words.data(), wordCount, bits, index) == expected);
+				}
+
+				// Only the very last index matches, then none does.
+				std::uint32_t              last = (1U << (bits - 1)) | 1U;
+				std::vector<std::uint64_t> empty(wordCount, 0);
+				empty.back() |= static_cast<std::uint64_t>(last) << ((64 / bits - 1) * bits);
+				CHECK(VoxelKernels::findFirst(empty.data(), wordCount, bits, last) == indexCount - 1);
+				empty.back() = 0;
+				CHECK(VoxelKernels::findFirst(empty.data(), wordCount, bits, last) == indexCount);
+			}
+		}
+	});
+}
+
+TEST(VoxelKernelsReplace)
+{
+	ForEachSet([]() {
+		std::mt19937 rng(3);
+		for (std::uint32_t bits : Widths)
+		{
+			for (std::size_t wordCount : WordCounts)
+			{
+				std::uint32_t paletteSize = GetPaletteSize(bits);
+				auto          words       = MakeWords(rng, wordCount, bits, paletteSize);
+				std::uint32_t from        = static_cast<std::uint32_t>(rng() % paletteSize);
+				std::uint32_t to          = static_cast<std::uint32_t>(rng() % paletteSize);
+
+				std::vector<std::uint64_t> expected(wordCount, 0);
+				std::size_t                expectedCount = 0;
+				for (std::size_t i = 0; i < wordCount * (64 / bits); ++i)
+				{
+					std::uint32_t index = GetIndex(words, bits, i);
+					if (index == from)
+					{
+						index = to;
+						++expectedCount;
+					}
+					expected[i / (64 / bits)] |= static_cast<std::uint64_t>(index) << ((i % (64 / bits)) * bits);
+				}
+
+				CHECK(VoxelKernels::replace(words.data(), wordCount, bits, from, to) == expectedCount);
+				CHECK(words == expected);
+			}
+		}
+	});
+}
+
+TEST(VoxelKernelsHistogram)
+{
+	ForEachSet([]() {
+		std::mt19937 rng(4);
+		for (std::uint32_t bits : Widths)
+		{
+			for (std::size_t wordCount : WordCounts)
+			{
+				// Small palettes take the per index count path, wide ones the tally.
+				for (std::uint32_t paletteSize : { std::min(GetPaletteSize(bits), 5U), GetPaletteSize(bits) })
+				{
+					auto words = MakeWords(rng, wordCount, bits, paletteSize);
+
+					std::vector<std::uint32_t> expected(paletteSize, 0);
+					for (std::size_t i = 0; i < wordCount * (64 / bits); ++i)
+						++expected[GetIndex(words, bits, i)];
+
+					std::vector<std::uint32_t> counts(paletteSize, ~0U);
+					VoxelKernels::histogram(words.data(), wordCount, bits, counts.data(), counts.size());
+					CHECK(counts == expected);
+				}
+			}
+		}
+	});
+}
@@ -0,0 +1,53 @@
+#include "Test.h"
+#include "Utils/WorkerPool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <vector>
+
+namespace
+{
+	// Every job of the batch submits two more until depth runs out, like light crossing into neighbouring chunks.
+	void Spread(WorkerPool& pool, std::atomic<std::size_t>& jobs, std::uint32_t depth)
+	{
+		++jobs;
+		if (depth == 0)
+			return;
+		for (int i = 0; i < 2; ++i)
+			pool.submit([&pool, &jobs, depth]() { Spread(pool, jobs, depth - 1); });
+	}
+} // namespace
+
+TEST(WorkerPoolParallelFor)
+{
+	for (std::size_t workerCount : { 0, 3 })
+	{
+		WorkerPool               pool(workerCount);
+		std::vector<std::size_t> values(1000, 0);
+		for (int round = 0; round < 20; ++round)
+			pool.parallelFor(values.size(), [&values](std::size_t index) { values[index] += index; });
+
+		bool correct = true;
+		for (std::size_t i = 0; i < values.size(); ++i)
+			correct &= values[i] == i * 20;
+		CHECK(correct);
+		CHECK(pool.getWorkerCount() == workerCount);
+	}
+}
+
+TEST(WorkerPoolNestedSubmit)
+{
+	for (std::size_t workerCount : { 0, 3 })
+	{
+		WorkerPool               pool(workerCount);
+		std::atomic<std::size_t> jobs = 0;
+		for (int round = 0; round < 10; ++round)
+		{
+			Spread(pool, jobs, 10);
+			pool.wait();
+		}
+		CHECK(jobs == 10 * ((1 << 11) - 1));
+	}
+}
@@ -125,3 +125,64 @@ workspace("Carbonite")
 		removefiles({ "*.DS_Store" })
 
 		common:addActions()
+
+	-- The world, block state and mesher sources, built without the rest of the game by the test and benchmark projects.
+	local worldFiles = {
+		"%{wks.location}/Carbonite/Source/Carbonite/Block/BlockState.h",
+		"%{wks.location}/Carbonite/Source/Carbonite/Block/BlockStateTable.*",
+		"%{wks.location}/Carbonite/Source/Carbonite/World/**",
+		"%{wks.location}/Carbonite/Source/Carbonite/Renderer/Mesh/ChunkMesher.*",
+		"%{wks.location}/Carbonite/Source/Carbonite/Renderer/Mesh/ChunkVisibility.*",
+		"%{wks.location}/Carbonite/Source/Utils/LZ.*",
+		"%{wks.location}/Carbonite/Source/Utils/MappedFile.*",
+		"%{wks.location}/Carbonite/Source/Utils/PerfectHash.*",
+		"%{wks.location}/Carbonite/Source/Utils/SlabAllocator.*"
+	}
+
+	group("Tests")
+	project("CarboniteTests")
+		location("CarboniteTests/")
+		kind("ConsoleApp")
+		warnings("Extra")
+
+		common:outDirs()
+
+		includedirs({
+			"%{prj.location}/Source/",
+			"%{wks.location}/Carbonite/Source/"
+		})
+
+		-- The mesher's Mesh.h pulls in the Vulkan and VMA headers.
+		libs.vma:setupDep()
+		libs.vulkan:setupDep(true)
+		libs.glm:setupDep()
+
+		files({ "%{prj.location}/Source/**" })
+		files(worldFiles)
+		removefiles({ "*.DS_Store" })
+
+	project("CarboniteBenchmarks")
+		location("CarboniteBenchmarks/")
+		kind("ConsoleApp")
+		warnings("Extra")
+
+		common:outDirs()
+
+		-- Benchmarks are only meaningful optimised.
+		filter("configurations:Debug")
+			optimize("Speed")
+
+		filter({})
+
+		includedirs({
+			"%{prj.location}/Source/",
+			"%{wks.location}/Carbonite/Source/"
+		})
+
+		libs.vma:setupDep()
+		libs.vulkan:setupDep(true)
+		libs.glm:setupDep()
+
+		files({ "%{prj.location}/Source/**" })
+		files(worldFiles)
+		removefiles({ "*.DS_Store" })